@@ -0,0 +1,41 @@
+#include <iostream>
+#include <iomanip>
+
+#include "bench.h"
+#include "CPPNeuralNet/Utils/async.h"
+
+namespace cpp_nn {
+namespace bench {
+
+/** Independent Branches
+ *  Trunk feeding two heads, run op by op on the caller against queued on an ExecutionStream.
+ *  Heads are small enough that a single Gemm cannot fill the pool, so the stream runs them side by side.
+ */
+CPP_NN_BENCHMARK(AsyncBranches) {
+  const int batch = 32, width = 256;
+  util::Tensor<float> x({batch, width}, 0.5f);
+  util::Tensor<float> W({width, width}, 0.01f);
+  util::Tensor<float> W1({width, width}, 0.02f);
+  util::Tensor<float> W2({width, width}, 0.03f);
+  auto relu = [](float v) {return v > 0.0f ? v : 0.0f;};
+
+  double sync = TimeBest([&]() {
+    util::Tensor<float> trunk = (x * W).Map(relu);
+    util::Tensor<float> head1 = trunk * W1;
+    util::Tensor<float> head2 = trunk * W2;
+  }, 20);
+  double async = TimeBest([&]() {
+    util::ExecutionStream stream;
+    auto trunk = stream.Map(stream.Multiply(stream.Ready(x), stream.Ready(W)), relu);
+    auto head1 = stream.Multiply(trunk, stream.Ready(W1));
+    auto head2 = stream.Multiply(trunk, stream.Ready(W2));
+    stream.Synchronize();
+  }, 20);
+
+  std::cout << "threads: " << util::getNumThreads() << std::fixed << std::setprecision(3)
+            << ", synchronous ms: " << sync * 1e3 << ", stream ms: " << async * 1e3
+            << ", speedup: " << std::setprecision(2) << sync / async << "x" << std::endl;
+}
+
+} // bench
+} // cpp_nn
@@ -0,0 +1,89 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include "bench.h"
+#include "CPPNeuralNet/model.h"
+#include "CPPNeuralNet/layers.h"
+#include "CPPNeuralNet/Utils/autograd.h"
+
+namespace cpp_nn {
+namespace bench {
+
+/** Tape Overhead
+ *  Per-op cost of recording and differentiating a chain of elementwise ops on tiny Tensors,
+ *    where the arithmetic is negligible and bookkeeping is all that is left.
+ */
+CPP_NN_BENCHMARK(TapeOverhead) {
+  const int length = 1000;
+  util::Tensor<double> x({4}, 0.5);
+  util::Tape<double> tape;
+  auto step = [&]() {
+    tape.Clear();
+    util::Variable<double> h = tape.Leaf(x);
+    for (int i = 0; i < length; ++i) h = tape.Scale(h, 0.999);
+    tape.Backward(tape.Sum(h));
+  };
+  step();
+  const double time = TimeBest(step, 10);
+  std::cout << std::setw(10) << "ops" << std::setw(14) << "ns per op" << std::setw(10) << "buffers" << std::endl;
+  std::cout << std::setw(10) << length + 2 << std::fixed << std::setprecision(1)
+            << std::setw(14) << time * 1e9 / (length + 2) << std::setw(10) << tape.getNumBuffers() << std::endl;
+}
+
+/** Tape MLP Training Step
+ *  784-512-256-10 ReLU MLP forward and backward with squared error, recorded on a tape,
+ *    against Model with its fixed per-layer buffers.
+ */
+CPP_NN_BENCHMARK(TapeMlpStep) {
+  const std::vector<int> sizes{784, 512, 256, 10};
+  std::cout << std::setw(8) << "batch" << std::setw(12) << "tape ms" << std::setw(12) << "model ms"
+            << std::setw(10) << "ratio" << std::setw(8) << "nodes" << std::setw(10) << "buffers" << std::endl;
+  for (int batch : {32, 128}) {
+    util::Tensor<double> x({batch, 784});
+    util::Tensor<double> target({batch, 10}, 0.0);
+    util::Tensor<double> dy({batch, 10});
+    for (int i = 0; i < x.getCapacity(); ++i) x.data()[i] = ((i * 7919) % 256) / 255.0;
+    for (int i = 0; i < batch; ++i) target({i, i % 10}) = 1;
+
+    Model model;
+    for (size_t l = 0; l + 1 < sizes.size(); ++l) {
+      const util::Activation activation = l + 2 < sizes.size() ? util::Activation::kReLU : util::Activation::kNone;
+      model.AddLayer<Linear>(sizes[l], sizes[l + 1], activation, l + 1);
+    }
+    model.Build({784}, batch);
+    std::vector<util::Tensor<double>*> parameters = model.Parameters();
+
+    auto model_step = [&]() {
+      const util::Tensor<double>& y = model.Forward(x);
+      for (int i = 0; i < y.getCapacity(); ++i) dy.data()[i] = 2 * (y.data()[i] - target.data()[i]) / y.getCapacity();
+      model.ZeroGradients();
+      model.Backward(dy);
+    };
+
+    // Same parameters, same loss
+    util::Tape<double> tape;
+    auto tape_step = [&]() {
+      tape.Clear();
+      util::Variable<double> h = tape.Leaf(x, false);
+      for (size_t l = 0; l + 1 < sizes.size(); ++l) {
+        h = h * tape.Leaf(*parameters[2 * l]) + tape.Leaf(*parameters[2 * l + 1]);
+        if (l + 2 < sizes.size()) h = tape.Apply(h, util::Activation::kReLU);
+      }
+      util::Variable<double> error = h - tape.Leaf(target, false);
+      tape.Backward(tape.Mean(tape.Multiply(error, error)));
+    };
+
+    model_step();
+    tape_step();
+    const double model_time = TimeBest(model_step, 10);
+    const double tape_time = TimeBest(tape_step, 10);
+    std::cout << std::setw(8) << batch << std::fixed << std::setprecision(3)
+              << std::setw(12) << tape_time * 1e3 << std::setw(12) << model_time * 1e3
+              << std::setprecision(2) << std::setw(9) << tape_time / model_time << "x"
+              << std::setw(8) << tape.getNumNodes() << std::setw(10) << tape.getNumBuffers() << std::endl;
+  }
+}
+
+} // bench
+} // cpp_nn
@@ -0,0 +1,56 @@
+#ifndef CPP_NN_BENCH
+#define CPP_NN_BENCH
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+namespace cpp_nn {
+namespace bench {
+
+/**
+ * Minimal benchmark harness.
+ * Each benchmark is a function registered by CPP_NN_BENCHMARK, which prints its own table.
+ * 'make bench' runs all; './build/bench <filter>' runs those whose name contains filter.
+ */
+struct Benchmark {
+  std::string name;
+  std::function<void()> run;
+};
+
+/** All registered benchmarks */
+inline std::vector<Benchmark>& Registry() {
+  static std::vector<Benchmark> registry;
+  return registry;
+}
+
+struct Registrar {
+  Registrar(const std::string& name, std::function<void()> run) {
+    Registry().push_back({name, run});
+  }
+};
+
+/** Seconds taken by a single call of func, best of given repeats */
+template<typename Func>
+double TimeBest(Func func, int repeats = 3) {
+  double best = 1e30;
+  for (int i = 0; i < repeats; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    best = std::min(best, std::chrono::duration<double>(end - start).count());
+  }
+  return best;
+}
+
+} // bench
+} // cpp_nn
+
+#define CPP_NN_BENCHMARK(name) \
+  static void name(); \
+  static ::cpp_nn::bench::Registrar name##_registrar(#name, name); \
+  static void name()
+
+#endif // CPP_NN_BENCH
@@ -0,0 +1,77 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include "bench.h"
+#include "CPPNeuralNet/Utils/block_sparse.h"
+#include "CPPNeuralNet/Utils/tensor.h"
+
+namespace cpp_nn {
+namespace bench {
+
+/** Block Sparse against Dense
+ *  [256 x 1024] activations times pruned [1024 x 1024] weight, at increasing fraction of zero 4x4 blocks.
+ *  Kernel columns use pre-packed weights, 'chosen' the format StructuredSparseMatrix picks, as a pruned Linear runs.
+ *  Speedup > 1 means structured kernel beats dense Gemm, which sets where SetBlockSparseThreshold belongs.
+ */
+CPP_NN_BENCHMARK(BlockSparse) {
+  const int M = 256, K = 1024, N = 1024;
+  const std::vector<double> zero_fractions = {0.25, 0.5, 0.6, 0.7, 0.75, 0.9, 0.95};
+
+  util::Tensor<float> A({M, K});
+  for (int i = 0; i < A.getCapacity(); ++i) A.data()[i] = static_cast<float>(i % 13) - 6.0f;
+  util::Tensor<float> C({M, N});
+  const double default_threshold = util::getBlockSparseThreshold();
+  // Format picked for W, falling back to Gemm when dense
+  auto chosen = [&](const util::StructuredSparseMatrix<float>& packed, const util::Tensor<float>& W) {
+    if (!util::StructuredSparseGemm(M, A.data(), K, 1, packed, C.data(), N)) C.MultiplyInto(A, W);
+  };
+
+  std::cout << std::setw(10) << "zero frac" << std::setw(12) << "dense ms" << std::setw(10) << "4x4"
+            << std::setw(10) << "1x16" << std::setw(10) << "16x1" << std::setw(12) << "chosen" << std::endl;
+  for (double zero_fraction : zero_fractions) {
+    util::Tensor<float> W({K, N});
+    const unsigned keep = static_cast<unsigned>((1.0 - zero_fraction) * 1000);
+    for (int k = 0; k < K; ++k) {
+      for (int n = 0; n < N; ++n) {
+        const unsigned block = static_cast<unsigned>((k / 4) * (N / 4) + n / 4);
+        W.getElement({k, n}) = (block * 2654435761u >> 8) % 1000 < keep ? 0.01f * ((k + n) % 13) + 0.1f : 0.0f;
+      }
+    }
+    double dense = TimeBest([&]() {C.MultiplyInto(A, W);}, 3);
+    util::StructuredSparseMatrix<float> structured;
+    structured.Pack(K, N, W.data(), N);
+    double picked = TimeBest([&]() {chosen(structured, W);}, 3);
+
+    std::cout << std::setw(10) << std::fixed << std::setprecision(3)
+              << util::BlockSparseMatrix<float>::ZeroBlockFraction(K, N, W.data(), N, 1, 4, 4)
+              << std::setw(12) << std::setprecision(2) << dense * 1e3;
+    for (const auto& shape : {std::make_pair(4, 4), std::make_pair(1, 16), std::make_pair(16, 1)}) {
+      util::BlockSparseMatrix<float> packed;
+      packed.Pack(K, N, W.data(), N, 1, shape.first, shape.second);
+      double sparse = TimeBest([&]() {util::BlockSparseGemm(M, A.data(), K, 1, packed, C.data(), N);}, 3);
+      std::cout << std::setw(9) << dense / sparse << "x";
+    }
+    std::cout << std::setw(11) << dense / picked << "x" << std::endl;
+  }
+
+  // 2:4, exactly half of every group of 4 rows kept
+  util::Tensor<float> W({K, N});
+  for (int k = 0; k < K; ++k) {
+    for (int n = 0; n < N; ++n) W.getElement({k, n}) = (k + n) % 4 < 2 ? 0.01f * (n % 13) + 0.1f : 0.0f;
+  }
+  util::TwoFourSparseMatrix<float> packed;
+  packed.Pack(K, N, W.data(), N, 1);
+  double dense = TimeBest([&]() {C.MultiplyInto(A, W);}, 3);
+  double sparse = TimeBest([&]() {util::TwoFourSparseGemm(M, A.data(), K, 1, packed, C.data(), N);}, 3);
+  util::SetBlockSparseThreshold(0.5);
+  util::StructuredSparseMatrix<float> structured;
+  structured.Pack(K, N, W.data(), N);
+  util::SetBlockSparseThreshold(default_threshold);
+  double picked = TimeBest([&]() {chosen(structured, W);}, 3);
+  std::cout << "2:4 kernel " << std::setprecision(2) << dense / sparse << "x, chosen at threshold 0.5 "
+            << dense / picked << "x" << std::endl;
+}
+
+} // bench
+} // cpp_nn
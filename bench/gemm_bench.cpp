@@ -0,0 +1,91 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+
+#include "bench.h"
+#include "CPPNeuralNet/Utils/gemm.h"
+#include "CPPNeuralNet/Utils/strassen.h"
+
+namespace cpp_nn {
+namespace bench {
+
+/** Strassen Crossover
+ *  Square products timed with blocked Gemm against StrassenGemm at a few cutoffs.
+ *  First size where Strassen wins is the crossover on current machine,
+ *    and the best cutoff there is what SetStrassenCutoff should be given.
+ */
+CPP_NN_BENCHMARK(StrassenCrossover) {
+  const std::vector<int> sizes = {256, 512, 1024, 2048};
+  const std::vector<int> cutoffs = {128, 256, 512};
+
+  std::cout << std::setw(8) << "n" << std::setw(14) << "blocked GF/s";
+  for (int cutoff : cutoffs) std::cout << std::setw(12) << ("n0=" + std::to_string(cutoff));
+  std::cout << std::setw(14) << "max abs err" << std::endl;
+
+  util::StrassenWorkspace<double> workspace;
+  for (int n : sizes) {
+    std::vector<double> A(static_cast<size_t>(n) * n), B(static_cast<size_t>(n) * n);
+    std::vector<double> C(static_cast<size_t>(n) * n), D(static_cast<size_t>(n) * n);
+    for (size_t i = 0; i < A.size(); ++i) {
+      A[i] = static_cast<double>((i * 2654435761u) % 1000) / 1000.0 - 0.5;
+      B[i] = static_cast<double>((i * 40503u) % 1000) / 1000.0 - 0.5;
+    }
+    const double flops = 2.0 * n * n * n;
+    const int repeats = n >= 2048 ? 1 : 3;
+
+    double blocked = TimeBest([&]() {
+      util::Gemm(n, n, n, A.data(), n, 1, B.data(), n, 1, C.data(), n);
+    }, repeats);
+    std::cout << std::setw(8) << n << std::setw(14) << std::fixed << std::setprecision(2) << flops / blocked * 1e-9;
+
+    double max_error = 0.0;
+    for (int cutoff : cutoffs) {
+      if (cutoff >= n) {
+        std::cout << std::setw(12) << "-";
+        continue;
+      }
+      double strassen = TimeBest([&]() {
+        util::StrassenGemm(n, n, n, A.data(), n, B.data(), n, D.data(), n, cutoff, workspace);
+      }, repeats);
+      // Speedup over blocked, > 1 means Strassen wins
+      std::cout << std::setw(11) << std::setprecision(2) << blocked / strassen << "x";
+
+      for (size_t i = 0; i < C.size(); ++i) {
+        max_error = std::max(max_error, std::abs(C[i] - D[i]));
+      }
+    }
+    std::cout << std::setw(14) << std::scientific << std::setprecision(1) << max_error << std::endl;
+  }
+}
+
+
+/** Half Precision
+ *  Bandwidth-bound matrix-vector and small-batch products, with weights stored as float and as bf16/fp16.
+ *  16-bit weights move half the bytes, while accumulation stays in float32.
+ */
+template<typename T>
+static double TimeWeightProduct(int M, int K, int N) {
+  std::vector<T> W(static_cast<size_t>(K) * N), X(static_cast<size_t>(M) * K), Y(static_cast<size_t>(M) * N);
+  for (size_t i = 0; i < W.size(); ++i) W[i] = T(static_cast<float>((i * 40503u) % 1000) / 1000.0f - 0.5f);
+  for (size_t i = 0; i < X.size(); ++i) X[i] = T(static_cast<float>((i * 7919u) % 1000) / 1000.0f - 0.5f);
+  return TimeBest([&]() {
+    util::Gemm(M, N, K, X.data(), K, 1, W.data(), N, 1, Y.data(), N);
+  }, 5);
+}
+CPP_NN_BENCHMARK(HalfPrecision) {
+  const std::vector<std::vector<int>> shapes = {{1, 4096, 4096}, {8, 4096, 4096}, {64, 2048, 2048}};
+
+  std::cout << std::setw(18) << "M x K x N" << std::setw(12) << "f32 ms" << std::setw(12) << "bf16 ms"
+            << std::setw(12) << "fp16 ms" << std::endl;
+  for (const std::vector<int>& shape : shapes) {
+    const int M = shape[0], K = shape[1], N = shape[2];
+    std::cout << std::setw(18) << (std::to_string(M) + "x" + std::to_string(K) + "x" + std::to_string(N))
+              << std::setw(12) << std::fixed << std::setprecision(2) << TimeWeightProduct<float>(M, K, N) * 1e3
+              << std::setw(12) << TimeWeightProduct<util::bf16>(M, K, N) * 1e3
+              << std::setw(12) << TimeWeightProduct<util::fp16>(M, K, N) * 1e3 << std::endl;
+  }
+}
+
+} // bench
+} // cpp_nn
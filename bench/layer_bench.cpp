@@ -0,0 +1,158 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include "bench.h"
+#include "CPPNeuralNet/layers.h"
+
+namespace cpp_nn {
+namespace bench {
+
+namespace {
+/** Copy of a matrix, transposed in storage */
+util::Tensor<double> Transposed(const util::Tensor<double>& matrix) {
+  const int rows = matrix.getDimension(0), cols = matrix.getDimension(1);
+  util::Tensor<double> res({cols, rows});
+  for (int r = 0; r < rows; ++r) {
+    for (int c = 0; c < cols; ++c) res.data()[c * rows + r] = matrix.data()[r * cols + c];
+  }
+  return res;
+}
+} // namespace
+
+/** Linear Layer
+ *  ReLU dense layer as Linear, against the same math composed of Tensor operations.
+ *  Composed forward: (x * W + b).Map(relu), three passes and three temporaries.
+ *  Composed backward: transposes of x and W copied out, then operator* and Sum(0).
+ */
+CPP_NN_BENCHMARK(LinearLayer) {
+  struct Shape {
+    int batch, in, out;
+  };
+  std::cout << std::setw(22) << "batch x in x out" << std::setw(14) << "fused fwd ms" << std::setw(14) << "composed ms"
+            << std::setw(10) << "speedup" << std::setw(14) << "fused bwd ms" << std::setw(14) << "composed ms"
+            << std::setw(10) << "speedup" << std::endl;
+  for (Shape shape : {Shape{64, 256, 256}, Shape{256, 784, 128}, Shape{256, 512, 512}, Shape{128, 1024, 1024}}) {
+    Linear layer(shape.in, shape.out, util::Activation::kReLU, 1);
+    layer.Prepare({shape.in}, shape.batch);
+    util::Tensor<double> x({shape.batch, shape.in});
+    util::Tensor<double> dy({shape.batch, shape.out});
+    for (int i = 0; i < x.getCapacity(); ++i) x.data()[i] = ((i * 7919) % 2003 - 1001) * 1e-3;
+    for (int i = 0; i < dy.getCapacity(); ++i) dy.data()[i] = ((i * 104729) % 4001 - 2000) * 1e-3;
+    util::Tensor<double>& W = layer.getWeight();
+    util::Tensor<double>& b = layer.getBias();
+    auto relu = [](double v) {return v > 0 ? v : 0.0;};
+
+    const double fused_forward = TimeBest([&]() {layer.Forward(x);}, 5);
+    const double composed_forward = TimeBest([&]() {
+      util::Tensor<double> y = (x * W + b).Map(relu);
+    }, 5);
+
+    layer.Forward(x);
+    const double fused_backward = TimeBest([&]() {layer.Backward(dy);}, 5);
+    const util::Tensor<double> y = layer.getOutput();
+    const double composed_backward = TimeBest([&]() {
+      util::Tensor<double> dz = dy.ElementwiseApply(y, [](double g, double v) {return v > 0 ? g : 0.0;});
+      util::Tensor<double> dW = Transposed(x) * dz;
+      util::Tensor<double> db = dz.Sum(0);
+      util::Tensor<double> dx = dz * Transposed(W);
+    }, 5);
+
+    std::cout << std::setw(8) << shape.batch << " x" << std::setw(5) << shape.in << " x" << std::setw(5) << shape.out
+              << std::fixed << std::setprecision(3)
+              << std::setw(14) << fused_forward * 1e3 << std::setw(14) << composed_forward * 1e3
+              << std::setprecision(2) << std::setw(9) << composed_forward / fused_forward << "x"
+              << std::setprecision(3)
+              << std::setw(14) << fused_backward * 1e3 << std::setw(14) << composed_backward * 1e3
+              << std::setprecision(2) << std::setw(9) << composed_backward / fused_backward << "x" << std::endl;
+  }
+}
+
+/** Conv2D Layer
+ *  Forward and backward throughput per layer shape, in both layouts, at batch 8.
+ *  Against NHWC forward with the whole [batch * pixels x K] unfolded at once, then one Gemm,
+ *    which is what the tiled im2col avoids.
+ */
+CPP_NN_BENCHMARK(Conv2DLayer) {
+  struct Shape {
+    int channels, out_channels, kernel, stride, pad, size;
+  };
+  const int batch = 8;
+  std::cout << std::setw(26) << "C -> O, k / s, HxW" << std::setw(7) << "layout" << std::setw(7) << "tile"
+            << std::setw(10) << "fwd ms" << std::setw(10) << "GFLOP/s" << std::setw(10) << "bwd ms"
+            << std::setw(10) << "GFLOP/s" << std::setw(12) << "whole ms" << std::setw(10) << "speedup" << std::endl;
+  for (Shape shape : {Shape{3, 64, 7, 2, 3, 64}, Shape{64, 64, 3, 1, 1, 32}, Shape{64, 128, 3, 2, 1, 32},
+                      Shape{128, 128, 3, 1, 1, 16}, Shape{256, 256, 1, 1, 0, 16}}) {
+    for (ImageLayout layout : {ImageLayout::kNCHW, ImageLayout::kNHWC}) {
+      const bool nchw = layout == ImageLayout::kNCHW;
+      Conv2DOptions options;
+      options.stride_h = options.stride_w = shape.stride;
+      options.pad_h = options.pad_w = shape.pad;
+      options.layout = layout;
+      Conv2D layer(shape.channels, shape.out_channels, shape.kernel, shape.kernel, options, 1);
+      const std::vector<int> input_shape = nchw ? std::vector<int>{shape.channels, shape.size, shape.size}
+                                                : std::vector<int>{shape.size, shape.size, shape.channels};
+      layer.Prepare(input_shape, batch);
+
+      util::Tensor<double> x({batch, input_shape[0], input_shape[1], input_shape[2]});
+      for (int i = 0; i < x.getCapacity(); ++i) x.data()[i] = ((i * 7919) % 2003 - 1001) * 1e-3;
+      std::vector<int> output_dims{batch};
+      for (const int& dim : layer.getOutputShape()) output_dims.push_back(dim);
+      util::Tensor<double> dy(output_dims);
+      for (int i = 0; i < dy.getCapacity(); ++i) dy.data()[i] = ((i * 104729) % 4001 - 2000) * 1e-3;
+
+      const double forward = TimeBest([&]() {layer.Forward(x);}, 5);
+      const double backward = TimeBest([&]() {layer.Backward(dy);}, 5);
+
+      const int out_size = layer.getOutputShape()[1];
+      const int pixels = batch * out_size * out_size;
+      const int depth = shape.kernel * shape.kernel * shape.channels;
+      // Backward is two products of forward's size
+      const double flops = 2.0 * pixels * depth * shape.out_channels;
+
+      double whole = 0;
+      if (!nchw) {
+        std::vector<double> columns(static_cast<size_t>(pixels) * depth);
+        util::Tensor<double> y(output_dims);
+        whole = TimeBest([&]() {
+          for (int p = 0; p < pixels; ++p) {
+            const int n = p / (out_size * out_size);
+            const int oy = p / out_size % out_size, ox = p % out_size;
+            for (int ky = 0; ky < shape.kernel; ++ky) {
+              for (int kx = 0; kx < shape.kernel; ++kx) {
+                const int iy = oy * shape.stride - shape.pad + ky, ix = ox * shape.stride - shape.pad + kx;
+                double* tap = columns.data() + static_cast<size_t>(p) * depth + (ky * shape.kernel + kx) * shape.channels;
+                if (iy < 0 || iy >= shape.size || ix < 0 || ix >= shape.size) {
+                  std::fill(tap, tap + shape.channels, 0.0);
+                } else {
+                  const double* source = x.data() + ((static_cast<size_t>(n) * shape.size + iy) * shape.size + ix) * shape.channels;
+                  std::copy(source, source + shape.channels, tap);
+                }
+              }
+            }
+          }
+          util::GemmEpilogue<double> epilogue;
+          epilogue.bias = layer.getBias().data();
+          util::Gemm(pixels, shape.out_channels, depth, columns.data(), depth, 1,
+                     layer.getWeight().data(), shape.out_channels, 1, y.data(), shape.out_channels, epilogue);
+        }, 5);
+      }
+
+      std::cout << std::setw(6) << shape.channels << " ->" << std::setw(4) << shape.out_channels << ", "
+                << shape.kernel << " / " << shape.stride << "," << std::setw(4) << shape.size << "x"
+                << std::setw(3) << shape.size << std::setw(7) << (nchw ? "NCHW" : "NHWC")
+                << std::setw(7) << layer.getTilePixels() << std::fixed << std::setprecision(3)
+                << std::setw(10) << forward * 1e3 << std::setprecision(2) << std::setw(10) << flops / forward / 1e9
+                << std::setprecision(3) << std::setw(10) << backward * 1e3
+                << std::setprecision(2) << std::setw(10) << 2 * flops / backward / 1e9;
+      if (!nchw) {
+        std::cout << std::setprecision(3) << std::setw(12) << whole * 1e3
+                  << std::setprecision(2) << std::setw(9) << whole / forward << "x";
+      }
+      std::cout << std::defaultfloat << std::endl;
+    }
+  }
+}
+
+} // bench
+} // cpp_nn
@@ -0,0 +1,62 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include "bench.h"
+#include "CPPNeuralNet/losses.h"
+
+namespace cpp_nn {
+namespace bench {
+
+/** Softmax Cross Entropy
+ *  Fused loss and gradient, against the same written with Tensor operations,
+ *    each making a temporary: shifted logits, exp, probabilities, one-hot targets and gradient.
+ */
+CPP_NN_BENCHMARK(CrossEntropyLoss) {
+  std::cout << std::setw(8) << "batch" << std::setw(10) << "classes" << std::setw(12) << "fused ms"
+            << std::setw(12) << "tensor ms" << std::setw(10) << "speedup" << std::setw(12) << "GB/s"
+            << std::setw(12) << "max diff" << std::endl;
+  const std::vector<std::pair<int, int>> shapes{{1024, 10}, {256, 1000}, {32, 32000}, {8, 128000}};
+  for (const std::pair<int, int>& shape : shapes) {
+    const int batch = shape.first, classes = shape.second;
+    util::Tensor<double> logits({batch, classes});
+    for (int i = 0; i < logits.getCapacity(); ++i) logits.data()[i] = std::sin(0.37 * i) * 8;
+    std::vector<int> labels(batch);
+    for (int r = 0; r < batch; ++r) labels[r] = (r * 7919) % classes;
+
+    SoftmaxCrossEntropy loss;
+    util::Tensor<double> gradient({batch, classes});
+    util::Tensor<double> reference({batch, classes});
+    const double fused_time = TimeBest([&]() {loss.Compute(logits, labels, gradient);}, 10);
+    const double tensor_time = TimeBest([&]() {
+      const util::Tensor<double> max = logits.Max(1);
+      util::Tensor<double> row_max({batch, 1});
+      for (int r = 0; r < batch; ++r) row_max.data()[r] = max.data()[r];
+      const util::Tensor<double> exp = logits.ElementwiseApply(row_max, [](double x, double m) {return std::exp(x - m);});
+      const util::Tensor<double> sum = exp.Sum(1);
+      util::Tensor<double> row_sum({batch, 1});
+      for (int r = 0; r < batch; ++r) row_sum.data()[r] = sum.data()[r] * batch;
+      util::Tensor<double> one_hot({batch, classes}, 0.0);
+      for (int r = 0; r < batch; ++r) one_hot.data()[static_cast<size_t>(r) * classes + labels[r]] = 1.0 / batch;
+      reference = exp.ElementwiseApply(row_sum, [](double e, double s) {return e / s;})
+                     .ElementwiseApply(one_hot, [](double p, double y) {return p - y;});
+    }, 10);
+
+    double max_diff = 0;
+    for (int i = 0; i < gradient.getCapacity(); ++i) {
+      max_diff = std::max(max_diff, std::abs(gradient.data()[i] - reference.data()[i]));
+    }
+    // Reads logits twice, writes gradient once
+    const double bytes = 3.0 * sizeof(double) * logits.getCapacity();
+    std::cout << std::setw(8) << batch << std::setw(10) << classes << std::fixed << std::setprecision(3)
+              << std::setw(12) << fused_time * 1e3 << std::setw(12) << tensor_time * 1e3
+              << std::setprecision(2) << std::setw(9) << tensor_time / fused_time << "x"
+              << std::setw(12) << bytes / fused_time / 1e9
+              << std::scientific << std::setprecision(1) << std::setw(12) << max_diff << std::defaultfloat << std::endl;
+  }
+}
+
+} // bench
+} // cpp_nn
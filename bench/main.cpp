@@ -0,0 +1,16 @@
+#include <iostream>
+#include <string>
+
+#include "bench.h"
+
+int main(int argc, char** argv) {
+  const std::string filter = argc > 1 ? argv[1] : "";
+
+  for (const cpp_nn::bench::Benchmark& benchmark : cpp_nn::bench::Registry()) {
+    if (benchmark.name.find(filter) == std::string::npos) continue;
+
+    std::cout << "== " << benchmark.name << " ==" << std::endl;
+    benchmark.run();
+    std::cout << std::endl;
+  }
+}
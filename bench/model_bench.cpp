@@ -0,0 +1,215 @@
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+#include "bench.h"
+#include "CPPNeuralNet/model.h"
+#include "CPPNeuralNet/layers.h"
+#include "CPPNeuralNet/optimizers.h"
+
+namespace cpp_nn {
+namespace bench {
+
+/** MLP Training Step
+ *  784-512-256-10 ReLU MLP: forward, squared error gradient, backward, SGD update.
+ *  Built with Linear -> ReLU fusion, and without, where every ReLU is its own pass.
+ */
+CPP_NN_BENCHMARK(MlpTrainingStep) {
+  auto build = [](Model& model, bool fuse, int batch) {
+    model.AddLayer<Linear>(784, 512, util::Activation::kNone, 1);
+    model.AddLayer<ActivationLayer>(util::Activation::kReLU);
+    model.AddLayer<Linear>(512, 256, util::Activation::kNone, 2);
+    model.AddLayer<ActivationLayer>(util::Activation::kReLU);
+    model.AddLayer<Linear>(256, 10, util::Activation::kNone, 3);
+    model.Build({784}, batch, fuse);
+  };
+
+  std::cout << std::setw(8) << "batch" << std::setw(14) << "fused ms" << std::setw(14) << "unfused ms"
+            << std::setw(10) << "speedup" << std::setw(14) << "arena KiB" << std::endl;
+  for (int batch : {32, 128}) {
+    util::Tensor<double> x({batch, 784});
+    util::Tensor<double> target({batch, 10}, 0.0);
+    util::Tensor<double> dy({batch, 10});
+    for (int i = 0; i < x.getCapacity(); ++i) x.data()[i] = ((i * 7919) % 256) / 255.0;
+    for (int i = 0; i < batch; ++i) target({i, i % 10}) = 1;
+
+    double times[2];
+    size_t arena_bytes = 0;
+    for (int fuse = 1; fuse >= 0; --fuse) {
+      Model model;
+      build(model, fuse, batch);
+      if (fuse) arena_bytes = model.getArenaBytes();
+      std::vector<util::Tensor<double>*> parameters = model.Parameters();
+      std::vector<util::Tensor<double>*> gradients = model.Gradients();
+
+      auto step = [&]() {
+        const util::Tensor<double>& y = model.Forward(x);
+        for (int i = 0; i < y.getCapacity(); ++i) dy.data()[i] = (y.data()[i] - target.data()[i]) / batch;
+        model.ZeroGradients();
+        model.Backward(dy);
+        for (size_t p = 0; p < parameters.size(); ++p) {
+          double* w = parameters[p]->data();
+          const double* g = gradients[p]->data();
+          for (int i = 0; i < parameters[p]->getCapacity(); ++i) w[i] -= 0.01 * g[i];
+        }
+      };
+      step();
+      times[fuse] = TimeBest(step, 15);
+    }
+
+    std::cout << std::setw(8) << batch << std::fixed << std::setprecision(3)
+              << std::setw(14) << times[1] * 1e3 << std::setw(14) << times[0] * 1e3
+              << std::setprecision(2) << std::setw(9) << times[0] / times[1] << "x"
+              << std::setw(14) << arena_bytes / 1024 << std::endl;
+  }
+}
+
+/** Memory Plan
+ *  Activation and gradient memory of a 784-(512 ReLU)x6-10 MLP at batch 128, fused and unfused:
+ *    every buffer apart, planned arena, and peak of live buffers.
+ *  Also the largest batch whose planned arena fits in what buffers apart took at batch 128.
+ */
+CPP_NN_BENCHMARK(MemoryPlan) {
+  const int batch = 128;
+  auto build = [](Model& model, bool fuse, int max_batch) {
+    model.AddLayer<Linear>(784, 512, util::Activation::kNone, 1);
+    model.AddLayer<ActivationLayer>(util::Activation::kReLU);
+    for (int l = 0; l < 5; ++l) {
+      model.AddLayer<Linear>(512, 512, util::Activation::kNone, l + 2);
+      model.AddLayer<ActivationLayer>(util::Activation::kReLU);
+    }
+    model.AddLayer<Linear>(512, 10, util::Activation::kNone, 7);
+    model.Build({784}, max_batch, fuse);
+  };
+
+  std::cout << std::setw(10) << "mode" << std::setw(14) << "apart KiB" << std::setw(14) << "arena KiB"
+            << std::setw(14) << "peak KiB" << std::setw(10) << "saving" << std::setw(14) << "batch fits" << std::endl;
+  for (int fuse = 1; fuse >= 0; --fuse) {
+    Model model;
+    build(model, fuse, batch);
+    const size_t budget = model.getUnplannedBytes();
+    int fits = batch;
+    for (int larger = batch + 16; ; larger += 16) {
+      Model trial;
+      build(trial, fuse, larger);
+      if (trial.getArenaBytes() > budget) break;
+      fits = larger;
+    }
+    std::cout << std::setw(10) << (fuse ? "fused" : "unfused") << std::setw(14) << model.getUnplannedBytes() / 1024
+              << std::setw(14) << model.getArenaBytes() / 1024 << std::setw(14) << model.getPeakBytes() / 1024
+              << std::fixed << std::setprecision(2) << std::setw(9)
+              << static_cast<double>(model.getUnplannedBytes()) / model.getArenaBytes() << "x"
+              << std::setw(14) << fits << std::endl;
+  }
+}
+
+/** Checkpointing
+ *  Training step of a 784-(256 ReLU)x16-10 MLP at batch 128, fused, whole and in segments.
+ *  sqrt(17) is about 4, so 4 segments should be about the least memory.
+ */
+CPP_NN_BENCHMARK(Checkpointing) {
+  const int batch = 128;
+  const int depth = 16;
+  util::Tensor<double> x({batch, 784});
+  util::Tensor<double> dy({batch, 10});
+  for (int i = 0; i < x.getCapacity(); ++i) x.data()[i] = ((i * 7919) % 256) / 255.0;
+  for (int i = 0; i < dy.getCapacity(); ++i) dy.data()[i] = ((i * 31) % 7 - 3) / 100.0;
+
+  std::cout << std::setw(10) << "segments" << std::setw(14) << "arena KiB" << std::setw(14) << "peak KiB"
+            << std::setw(10) << "memory" << std::setw(12) << "step ms" << std::setw(10) << "time" << std::endl;
+  double base_time = 0;
+  size_t base_bytes = 0;
+  for (int segments : {1, 2, 4, 8}) {
+    Model model;
+    for (int l = 0; l < depth; ++l) {
+      if (l > 0 && l % (depth / segments) == 0) model.AddCheckpoint();
+      model.AddLayer<Linear>(l == 0 ? 784 : 256, 256, util::Activation::kNone, l + 1);
+      model.AddLayer<ActivationLayer>(util::Activation::kReLU);
+    }
+    model.AddLayer<Linear>(256, 10, util::Activation::kNone, depth + 1);
+    model.Build({784}, batch);
+
+    auto step = [&]() {
+      model.Forward(x);
+      model.ZeroGradients();
+      model.Backward(dy);
+    };
+    step();
+    const double time = TimeBest(step, 10);
+    if (segments == 1) {
+      base_time = time;
+      base_bytes = model.getArenaBytes();
+    }
+    std::cout << std::setw(10) << model.getNumSegments() << std::setw(14) << model.getArenaBytes() / 1024
+              << std::setw(14) << model.getPeakBytes() / 1024 << std::fixed << std::setprecision(2)
+              << std::setw(9) << static_cast<double>(model.getArenaBytes()) / base_bytes << "x"
+              << std::setprecision(3) << std::setw(12) << time * 1e3
+              << std::setprecision(2) << std::setw(9) << time / base_time << "x" << std::endl;
+  }
+}
+
+/** Flat Parameters
+ *  Zero gradients, Adam step and Save of many small layers, Linear(n, n) x 64.
+ *  Over the model's flat buffers, against the same tensors as separate allocations,
+ *    zeroed tensor by tensor and written one by one.
+ */
+CPP_NN_BENCHMARK(FlatParameters) {
+  std::cout << std::setw(8) << "n" << std::setw(12) << "parameters" << std::setw(12) << "flat ms"
+            << std::setw(14) << "separate ms" << std::setw(10) << "speedup"
+            << std::setw(14) << "flat save ms" << std::setw(10) << "speedup" << std::endl;
+  const int depth = 64;
+  for (int n : {16, 64, 256}) {
+    Model model;
+    for (int l = 0; l < depth; ++l) model.AddLayer<Linear>(n, n, util::Activation::kNone, l + 1);
+    model.Build({n}, 1);
+
+    std::vector<util::Tensor<double>> parameters, gradients;
+    for (util::Tensor<double>* parameter : model.Parameters()) parameters.push_back(*parameter);
+    for (util::Tensor<double>* gradient : model.Gradients()) gradients.push_back(*gradient);
+    std::vector<util::Tensor<double>*> parameter_ptrs, gradient_ptrs;
+    for (size_t p = 0; p < parameters.size(); ++p) {
+      parameter_ptrs.push_back(&parameters[p]);
+      gradient_ptrs.push_back(&gradients[p]);
+    }
+
+    Adam flat_adam, separate_adam;
+    flat_adam.AddParameters({&model.getFlatParameters()}, {&model.getFlatGradients()});
+    separate_adam.AddParameters(parameter_ptrs, gradient_ptrs);
+    const double flat_time = TimeBest([&]() {
+      model.ZeroGradients();
+      flat_adam.Step();
+    }, 20);
+    const double separate_time = TimeBest([&]() {
+      for (util::Tensor<double>& gradient : gradients) {
+        std::fill(gradient.data(), gradient.data() + gradient.getCapacity(), 0.0);
+      }
+      separate_adam.Step();
+    }, 20);
+
+    std::ostringstream stream;
+    const double flat_save = TimeBest([&]() {
+      stream.str("");
+      model.Save(stream);
+    }, 20);
+    const double separate_save = TimeBest([&]() {
+      stream.str("");
+      for (const util::Tensor<double>& parameter : parameters) {
+        const int size = parameter.getCapacity();
+        stream.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        stream.write(reinterpret_cast<const char*>(parameter.data()), size * sizeof(double));
+      }
+    }, 20);
+
+    std::cout << std::setw(8) << n << std::setw(12) << model.getFlatParameters().getCapacity()
+              << std::fixed << std::setprecision(3) << std::setw(12) << flat_time * 1e3
+              << std::setw(14) << separate_time * 1e3 << std::setprecision(2)
+              << std::setw(9) << separate_time / flat_time << "x" << std::setprecision(3)
+              << std::setw(14) << flat_save * 1e3 << std::setprecision(2)
+              << std::setw(9) << separate_save / flat_save << "x" << std::defaultfloat << std::endl;
+  }
+}
+
+} // bench
+} // cpp_nn
@@ -0,0 +1,49 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include "bench.h"
+#include "CPPNeuralNet/Utils/tensor.h"
+
+namespace cpp_nn {
+namespace bench {
+
+/** NUMA Placement
+ *  Construction of a large Tensor, filled by one thread against first-touched in parallel,
+ *    and batched matmul over it with and without pinned, socket-partitioned threads.
+ *  Gains need more than one node, see the printed node count; on one node columns should match.
+ */
+CPP_NN_BENCHMARK(NumaPlacement) {
+  const int batch = 64, n = 128;
+  std::cout << "NUMA nodes: " << util::getNumaNodes() << ", threads: " << util::getNumThreads() << std::endl;
+
+  double serial_fill = TimeBest([&]() {
+    std::vector<float> storage(static_cast<size_t>(batch) * n * n * 8, 1.0f);
+  });
+  double first_touch = TimeBest([&]() {
+    util::Tensor<float> storage({batch * 8, n, n}, 1.0f);
+  });
+
+  util::Tensor<float> A({batch, n, n}, 0.5f);
+  util::Tensor<float> B({batch, n, n}, 0.25f);
+  util::Tensor<float> C({batch, n, n});
+  double balanced = TimeBest([&]() {C.BatchedMultiplyInto(A, B);});
+
+  util::SetThreadAffinity(true);
+  util::SetSocketPartitioning(true);
+  util::Tensor<float> A_local({batch, n, n}, 0.5f);
+  util::Tensor<float> B_local({batch, n, n}, 0.25f);
+  util::Tensor<float> C_local({batch, n, n});
+  double partitioned = TimeBest([&]() {C_local.BatchedMultiplyInto(A_local, B_local);});
+  util::SetSocketPartitioning(false);
+  util::SetThreadAffinity(false);
+
+  std::cout << std::fixed << std::setprecision(2)
+            << std::setw(28) << "serial fill ms" << std::setw(12) << serial_fill * 1e3 << std::endl
+            << std::setw(28) << "first-touch fill ms" << std::setw(12) << first_touch * 1e3 << std::endl
+            << std::setw(28) << "batched matmul ms" << std::setw(12) << balanced * 1e3 << std::endl
+            << std::setw(28) << "pinned, by socket ms" << std::setw(12) << partitioned * 1e3 << std::endl;
+}
+
+} // bench
+} // cpp_nn
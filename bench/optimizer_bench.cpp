@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include "bench.h"
+#include "CPPNeuralNet/optimizers.h"
+
+namespace cpp_nn {
+namespace bench {
+
+/** Adam Step
+ *  Parameters of a 784-512-256-10 MLP, and of a 4096 x 1024 layer.
+ *  Fused optimizer pass, against the same update written with Tensor operations,
+ *    each making a temporary: m, v, and the step itself.
+ */
+CPP_NN_BENCHMARK(AdamStep) {
+  std::cout << std::setw(12) << "parameters" << std::setw(12) << "fused ms" << std::setw(12) << "tensor ms"
+            << std::setw(10) << "speedup" << std::setw(12) << "GB/s" << std::setw(12) << "max diff" << std::endl;
+  const std::vector<std::vector<std::vector<int>>> models{
+      {{784, 512}, {512}, {512, 256}, {256}, {256, 10}, {10}},
+      {{4096, 1024}, {1024}}};
+  for (const std::vector<std::vector<int>>& shapes : models) {
+    std::vector<util::Tensor<double>> parameters, gradients, reference, first_moments, second_moments;
+    int size = 0;
+    for (const std::vector<int>& shape : shapes) {
+      parameters.emplace_back(shape);
+      gradients.emplace_back(shape);
+      first_moments.emplace_back(shape, 0.0);
+      second_moments.emplace_back(shape, 0.0);
+      for (int i = 0; i < parameters.back().getCapacity(); ++i) {
+        parameters.back().data()[i] = std::sin(0.001 * (size + i));
+        gradients.back().data()[i] = std::cos(0.003 * (size + i));
+      }
+      size += parameters.back().getCapacity();
+    }
+    reference = parameters;
+
+    Adam adam(1e-3);
+    std::vector<util::Tensor<double>*> parameter_ptrs, gradient_ptrs;
+    for (size_t p = 0; p < parameters.size(); ++p) {
+      parameter_ptrs.push_back(&parameters[p]);
+      gradient_ptrs.push_back(&gradients[p]);
+    }
+    adam.AddParameters(parameter_ptrs, gradient_ptrs);
+
+    int step = 0;
+    auto tensor_step = [&]() {
+      ++step;
+      const double step_size = 1e-3 / (1 - std::pow(0.9, step));
+      const double root_bias2 = 1 / std::sqrt(1 - std::pow(0.999, step));
+      for (size_t p = 0; p < reference.size(); ++p) {
+        const util::Tensor<double>& g = gradients[p];
+        first_moments[p] = first_moments[p].ElementwiseApply(g, [](double m, double x) {return 0.9 * m + 0.1 * x;});
+        second_moments[p] = second_moments[p].ElementwiseApply(g, [](double v, double x) {return 0.999 * v + 0.001 * x * x;});
+        const util::Tensor<double> update = first_moments[p].ElementwiseApply(second_moments[p],
+            [&](double m, double v) {return step_size * m / (std::sqrt(v) * root_bias2 + 1e-8);});
+        reference[p] = reference[p].ElementwiseApply(update, [](double w, double u) {return w - u;});
+      }
+    };
+
+    // Equal step counts before comparing
+    const int repeats = 10;
+    const double fused_time = TimeBest([&]() {adam.Step();}, repeats);
+    const double tensor_time = TimeBest(tensor_step, repeats);
+    double max_diff = 0;
+    for (size_t p = 0; p < parameters.size(); ++p) {
+      for (int i = 0; i < parameters[p].getCapacity(); ++i) {
+        max_diff = std::max(max_diff, std::abs(parameters[p].data()[i] - reference[p].data()[i]));
+      }
+    }
+    // Reads w, g, m, v and writes w, m, v
+    const double bytes = 7.0 * sizeof(double) * size;
+    std::cout << std::setw(12) << size << std::fixed << std::setprecision(3)
+              << std::setw(12) << fused_time * 1e3 << std::setw(12) << tensor_time * 1e3
+              << std::setprecision(2) << std::setw(9) << tensor_time / fused_time << "x"
+              << std::setw(12) << bytes / fused_time / 1e9
+              << std::scientific << std::setprecision(1) << std::setw(12) << max_diff << std::defaultfloat << std::endl;
+  }
+}
+
+} // bench
+} // cpp_nn
@@ -0,0 +1,52 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include "bench.h"
+#include "CPPNeuralNet/Utils/gemm.h"
+#include "CPPNeuralNet/Utils/quantization.h"
+
+namespace cpp_nn {
+namespace bench {
+
+/** Int8 against Float GEMM
+ *  Dense-layer shaped products, [batch x K] * [K x N], in float32 and in u8 x s8 -> int32.
+ */
+CPP_NN_BENCHMARK(QuantizedGemm) {
+  const std::vector<std::vector<int>> shapes = {{1, 1024, 1024}, {32, 1024, 1024}, {256, 1024, 1024}};
+
+  std::cout << std::setw(18) << "M x K x N" << std::setw(14) << "f32 GOP/s" << std::setw(14) << "int8 GOP/s"
+            << std::setw(10) << "speedup" << std::endl;
+  for (const std::vector<int>& shape : shapes) {
+    const int M = shape[0], K = shape[1], N = shape[2];
+    std::vector<float> A(static_cast<size_t>(M) * K), B(static_cast<size_t>(K) * N), C(static_cast<size_t>(M) * N);
+    util::QuantizedTensor<uint8_t> qa({M, K}, {0.02f}, {128});
+    util::QuantizedTensor<int8_t> qb({K, N}, {0.01f}, {0});
+    for (size_t i = 0; i < A.size(); ++i) {
+      qa.data()[i] = static_cast<uint8_t>((i * 31) % 256);
+      A[i] = 0.02f * (qa.data()[i] - 128);
+    }
+    for (size_t i = 0; i < B.size(); ++i) {
+      qb.data()[i] = static_cast<int8_t>((i * 17) % 255 - 127);
+      B[i] = 0.01f * qb.data()[i];
+    }
+    util::QuantizedGemmWeight packed(qb);
+    std::vector<float> D(static_cast<size_t>(M) * N);
+
+    const double ops = 2.0 * M * N * K;
+    double f32 = TimeBest([&]() {
+      util::Gemm(M, N, K, A.data(), K, 1, B.data(), N, 1, C.data(), N);
+    });
+    double int8 = TimeBest([&]() {
+      util::QuantizedGemm(M, qa.data(), K, 128, 0.02f, packed, D.data(), N, util::RequantizeEpilogue());
+    });
+
+    std::cout << std::setw(18) << (std::to_string(M) + "x" + std::to_string(K) + "x" + std::to_string(N))
+              << std::setw(14) << std::fixed << std::setprecision(2) << ops / f32 * 1e-9
+              << std::setw(14) << ops / int8 * 1e-9
+              << std::setw(9) << f32 / int8 << "x" << std::endl;
+  }
+}
+
+} // bench
+} // cpp_nn
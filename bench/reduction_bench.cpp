@@ -0,0 +1,71 @@
+#include <iostream>
+#include <iomanip>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "CPPNeuralNet/Utils/tensor.h"
+
+namespace cpp_nn {
+namespace bench {
+
+/** Deterministic Reductions
+ *  Sum of a whole tensor, and column sums as in a bias gradient, in fast and deterministic mode.
+ *  Deterministic mode cuts fixed kReductionLeaf leaves, so it keeps more partials and tree levels.
+ *  'same' tells whether results were bitwise equal over 1..8 threads.
+ */
+CPP_NN_BENCHMARK(DeterministicReduction) {
+  const int default_threads = util::getNumThreads();
+  const bool default_deterministic = util::getDeterministicReductions();
+
+  util::Tensor<float> flat({1 << 24});
+  util::Tensor<float> columns({1 << 16, 256});
+  for (int i = 0; i < flat.getCapacity(); ++i) flat.data()[i] = ((i * 7919) % 2003 - 1001) * 1e-3f;
+  for (int i = 0; i < columns.getCapacity(); ++i) columns.data()[i] = ((i * 104729) % 4001 - 2000) * 1e-3f;
+
+  struct Case {
+    std::string name;
+    std::function<std::vector<float>()> run;
+  };
+  std::vector<Case> cases = {
+    {"Sum [16M]", [&]() {return std::vector<float>{flat.Sum()};}},
+    {"Sum(0) [64K x 256]", [&]() {
+      util::Tensor<float> res = columns.Sum(0);
+      return std::vector<float>(res.data(), res.data() + res.getCapacity());
+    }},
+    {"Max(1) [64K x 256]", [&]() {
+      util::Tensor<float> res = columns.Max(1);
+      return std::vector<float>(res.data(), res.data() + res.getCapacity());
+    }},
+  };
+
+  std::cout << std::setw(22) << "case" << std::setw(14) << "fast ms" << std::setw(10) << "same"
+            << std::setw(14) << "determ ms" << std::setw(10) << "same" << std::setw(10) << "cost" << std::endl;
+  for (const Case& c : cases) {
+    std::cout << std::setw(22) << c.name;
+    double times[2];
+    for (int mode = 0; mode < 2; ++mode) {
+      util::SetDeterministicReductions(mode == 1);
+      bool same = true;
+      util::SetNumThreads(1);
+      const std::vector<float> serial = c.run();
+      for (int threads : {2, 3, 8}) {
+        util::SetNumThreads(threads);
+        same = same && c.run() == serial;
+      }
+
+      util::SetNumThreads(default_threads);
+      times[mode] = TimeBest([&]() {c.run();}, 5);
+      std::cout << std::fixed << std::setprecision(3) << std::setw(14) << times[mode] * 1e3
+                << std::setw(10) << (same ? "yes" : "no");
+    }
+    std::cout << std::setprecision(2) << std::setw(9) << times[1] / times[0] << "x" << std::endl;
+  }
+
+  util::SetDeterministicReductions(default_deterministic);
+  util::SetNumThreads(default_threads);
+}
+
+} // bench
+} // cpp_nn
@@ -0,0 +1,52 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include "bench.h"
+#include "CPPNeuralNet/Utils/gemm.h"
+#include "CPPNeuralNet/Utils/sparse_tensor.h"
+
+namespace cpp_nn {
+namespace bench {
+
+/** Sparse against Dense
+ *  Pruned [1024 x 1024] weight times [1024 x 64] activations, and times a single vector,
+ *    at decreasing density. Speedup > 1 means SpMM/SpMV beats dense Gemm.
+ */
+CPP_NN_BENCHMARK(SparseDensity) {
+  const int M = 1024, K = 1024, N = 64;
+  const std::vector<double> densities = {0.5, 0.25, 0.1, 0.05, 0.01};
+
+  util::Tensor<float> B({K, N});
+  for (int i = 0; i < B.getCapacity(); ++i) B.data()[i] = static_cast<float>(i % 17) - 8.0f;
+  util::Tensor<float> x({K, 1}, 1.0f);
+
+  std::cout << std::setw(10) << "density" << std::setw(12) << "dense ms" << std::setw(12) << "SpMM ms"
+            << std::setw(10) << "speedup" << std::setw(12) << "SpMV x" << std::setw(14) << "sparse bytes" << std::endl;
+  for (double density : densities) {
+    util::Tensor<float> W({M, K});
+    const unsigned keep = static_cast<unsigned>(density * 1000);
+    for (int i = 0; i < W.getCapacity(); ++i) {
+      W.data()[i] = (static_cast<unsigned>(i) * 2654435761u >> 8) % 1000 < keep ? 0.01f * (i % 13) + 0.1f : 0.0f;
+    }
+    auto W_sparse = util::CsrTensor<float>::FromDense(W);
+    util::Tensor<float> C({M, N});
+    util::Tensor<float> y({M, 1});
+
+    double dense = TimeBest([&]() {C.MultiplyInto(W, B);}, 5);
+    double sparse = TimeBest([&]() {W_sparse.MultiplyInto(B, C);}, 5);
+    double dense_mv = TimeBest([&]() {y.MultiplyInto(W, x);}, 5);
+    double sparse_mv = TimeBest([&]() {W_sparse.MultiplyInto(x, y);}, 5);
+    const size_t bytes = W_sparse.getNonZeros() * (sizeof(float) + sizeof(int)) + (M + 1) * sizeof(int);
+
+    std::cout << std::setw(10) << std::fixed << std::setprecision(3) << W_sparse.getDensity()
+              << std::setw(12) << std::setprecision(2) << dense * 1e3
+              << std::setw(12) << sparse * 1e3
+              << std::setw(9) << dense / sparse << "x"
+              << std::setw(11) << dense_mv / sparse_mv << "x"
+              << std::setw(14) << bytes << std::endl;
+  }
+}
+
+} // bench
+} // cpp_nn
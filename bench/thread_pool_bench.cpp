@@ -0,0 +1,49 @@
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+#include "CPPNeuralNet/Utils/thread_pool.h"
+
+namespace cpp_nn {
+namespace bench {
+
+/** Parallel Dispatch Overhead
+ *  Cost of one parallel call over a trivial range, pooled ParallelFor against starting threads per call,
+ *    as ParallelChunks used to. Small kernels pay this on every call.
+ */
+CPP_NN_BENCHMARK(ParallelForOverhead) {
+  const int default_threads = util::getNumThreads();
+  const int calls = 200;
+  std::vector<int> data(1 << 12, 1);
+
+  std::cout << std::setw(10) << "threads" << std::setw(14) << "pool us" << std::setw(14) << "spawn us" << std::endl;
+  for (int threads : {2, 4, 8}) {
+    util::SetNumThreads(threads);
+    auto body = [&](int begin, int end) {
+      for (int i = begin; i < end; ++i) data[i] += 1;
+    };
+
+    double pool = TimeBest([&]() {
+      for (int c = 0; c < calls; ++c) util::ParallelFor(0, data.size(), body, data.size() / threads);
+    });
+    double spawn = TimeBest([&]() {
+      for (int c = 0; c < calls; ++c) {
+        const int chunk = data.size() / threads;
+        std::vector<std::thread> workers;
+        for (int t = 1; t < threads; ++t) workers.emplace_back(body, t * chunk, (t + 1) * chunk);
+        body(0, chunk);
+        for (std::thread& worker : workers) worker.join();
+      }
+    });
+
+    std::cout << std::setw(10) << threads << std::fixed << std::setprecision(2)
+              << std::setw(14) << pool / calls * 1e6
+              << std::setw(14) << spawn / calls * 1e6 << std::endl;
+  }
+  util::SetNumThreads(default_threads);
+}
+
+} // bench
+} // cpp_nn
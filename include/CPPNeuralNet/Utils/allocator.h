@@ -0,0 +1,138 @@
+#ifndef CPP_NN_ALLOCATOR
+#define CPP_NN_ALLOCATOR
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <stdexcept>
+
+namespace cpp_nn {
+namespace util {
+
+/**
+ * Tensor Storage Allocation.
+ *
+ * On NUMA machines a page lives on the node of the thread that first writes it.
+ *  std::vector zero-fills on construction, so a large tensor built by one thread lands entirely
+ *  on that thread's node, and half of a two-socket pool then reads it remotely.
+ *
+ * TensorAllocator leaves elements default-initialized, ie) untouched for arithmetic types,
+ *  and Tensor fills its storage with FirstTouchFill / FirstTouchCopy instead.
+ *  These split storage with ParallelChunks, the same contiguous split kernels use over the same storage,
+ *  so each thread first-touches the pages it will later work on.
+ *  Placement only follows threads when they stay on their node, see SetThreadAffinity in thread_pool.h.
+ *
+ * Storage is also aligned to kTensorAlignment, a cache line and one AVX-512 register.
+ */
+constexpr size_t kTensorAlignment = 64;
+
+/** Aligned, Default-Initializing Allocator */
+template<typename T>
+struct TensorAllocator {
+  using value_type = T;
+
+  TensorAllocator() = default;
+  template<typename U>
+  TensorAllocator(const TensorAllocator<U>&) {}
+
+  inline T* allocate(size_t n) {
+    return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(kTensorAlignment)));
+  }
+  inline void deallocate(T* p, size_t) {
+    ::operator delete(p, std::align_val_t(kTensorAlignment));
+  }
+/** No arguments, ie) vector::resize(n): default-initialize rather than value-initialize */
+  template<typename U>
+  inline void construct(U* p) noexcept(std::is_nothrow_default_constructible<U>::value) {
+    ::new(static_cast<void*>(p)) U;
+  }
+  template<typename U, typename... Args>
+  inline void construct(U* p, Args&&... args) {
+    ::new(static_cast<void*>(p)) U(std::forward<Args>(args)...);
+  }
+
+  template<typename U>
+  inline bool operator==(const TensorAllocator<U>&) const {return true;}
+  template<typename U>
+  inline bool operator!=(const TensorAllocator<U>&) const {return false;}
+};
+
+/** Tensor Storage
+ *  Elements of a Tensor: either owned, in an aligned vector, or a view of memory owned elsewhere,
+ *    ie) a slice of an arena holding many tensors.
+ *  resize keeps storage when shrinking. Growing past capacity reallocates owned storage,
+ *    while a view throws 'View Overflow' as it cannot move.
+ */
+template<typename T>
+class TensorStorage {
+ private:
+  std::vector<T, TensorAllocator<T>> owned_;
+  T* view_;
+  int view_size_;
+  int view_capacity_;
+ public:
+  TensorStorage() : view_(nullptr), view_size_(0), view_capacity_(0) {}
+/** View of capacity elements at storage */
+  TensorStorage(T* storage, int capacity) : view_(storage), view_size_(capacity), view_capacity_(capacity) {}
+
+  inline void resize(int size) {
+    if (view_ == nullptr) {
+      owned_.resize(size);
+      return;
+    }
+    if (size > view_capacity_) throw std::invalid_argument("TensorStorage Resize- View Overflow");
+    view_size_ = size;
+  }
+  inline bool isView() const {return view_ != nullptr;}
+  inline int size() const {return view_ != nullptr ? view_size_ : static_cast<int>(owned_.size());}
+  inline T* data() {return view_ != nullptr ? view_ : owned_.data();}
+  inline const T* data() const {return view_ != nullptr ? view_ : owned_.data();}
+  inline T& operator[](int i) {return data()[i];}
+  inline const T& operator[](int i) const {return data()[i];}
+};
+
+/** Scratch Buffer
+ *  Temporary storage of a kernel call, ie) packed Gemm panels, leased for the lease's scope
+ *    from a stack of buffers kept per thread.
+ *  Buffers are only ever grown, so once warmed up, kernels of equal or smaller sizes allocate nothing.
+ *    Warm-up is per thread: a pool thread allocates on its first lease, whichever call that falls in.
+ *  Leases on one thread nest, ie) a pool task run while the thread waits, each taking the next buffer,
+ *    so storage is never shared by two live leases. Contents start unspecified.
+ */
+template<typename T>
+class ScratchBuffer {
+ private:
+  struct Stack {
+    std::vector<std::vector<T, TensorAllocator<T>>> buffers;
+    size_t depth = 0;
+  };
+  static Stack& LocalStack();
+  T* data_;
+ public:
+  explicit ScratchBuffer(size_t size);
+  ~ScratchBuffer();
+  ScratchBuffer(const ScratchBuffer&) = delete;
+  ScratchBuffer& operator=(const ScratchBuffer&) = delete;
+  inline T* data() {return data_;}
+  inline const T* data() const {return data_;}
+};
+
+/** First-Touch Fill
+ *  Sets size elements to value, split among threads as kernels split the same storage.
+ */
+template<typename T>
+void FirstTouchFill(T* data, int size, const T& value);
+/** First-Touch Copy
+ *  Copies size elements from source, split as FirstTouchFill.
+ */
+template<typename T>
+void FirstTouchCopy(T* data, const T* source, int size);
+
+} // util
+} // cpp_nn
+
+#include "../src/CPPNeuralNet/Utils/allocator.tpp"
+
+#endif // CPP_NN_ALLOCATOR
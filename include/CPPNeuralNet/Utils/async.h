@@ -0,0 +1,152 @@
+#ifndef CPP_NN_ASYNC
+#define CPP_NN_ASYNC
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+#include "CPPNeuralNet/Utils/tensor.h"
+#include "CPPNeuralNet/Utils/thread_pool.h"
+
+namespace cpp_nn {
+namespace util {
+
+/**
+ * Asynchronous Execution.
+ * ExecutionStream queues tensor ops and at once returns TensorFuture handles to their results.
+ * Each op records the futures it reads as dependencies, and is submitted to the thread pool
+ *  as soon as the last of them is ready, so ops with no path between them run concurrently.
+ *  ie) two heads of a network fed by one trunk both start once the trunk is done.
+ * Kernels inside an op still spread over the pool, see ThreadPool::Submit.
+ *
+ * Nothing blocks until a value is read, by Get, Wait or Synchronize.
+ *  A thread blocked on a future runs queued pool tasks meanwhile.
+ *
+ * A failing op stores its exception in its future. Ops reading it fail with the same exception
+ *  without running, and it is rethrown wherever one of them is read.
+ *
+ *  ExecutionStream stream;
+ *  auto x = stream.Ready(input);
+ *  auto trunk = stream.Multiply(x, stream.Ready(W));
+ *  auto head1 = stream.Map(trunk, relu);                       // head1 and head2 run concurrently
+ *  auto head2 = stream.Multiply(trunk, stream.Ready(W2));
+ *  head1.Get();                                                // waits for trunk and head1 only
+ */
+
+/** Completion State
+ *  Shared by a future and the op producing it. Non-template part of TensorFuture.
+ */
+class AsyncState {
+ private:
+  mutable std::mutex mutex_;
+  mutable std::condition_variable ready_cv_;
+  bool ready_;
+  std::exception_ptr error_;
+  std::vector<std::function<void()>> continuations_;
+ public:
+  AsyncState() : ready_(false) {}
+  virtual ~AsyncState() = default;
+
+  bool isReady() const;
+/** Exception of failed op, null while pending or on success */
+  std::exception_ptr getError() const;
+/** Blocks until ready, running queued pool tasks meanwhile. Does not throw */
+  void Wait() const;
+/** Runs continuation once ready, right away if already */
+  void Then(std::function<void()> continuation);
+/** Marks ready, with error on failure, and runs continuations */
+  void Complete(std::exception_ptr error = nullptr);
+};
+
+/** Tensor Future
+ *  Handle to a Tensor that an ExecutionStream op is producing. Copies share the same result.
+ */
+template<typename T>
+class TensorFuture {
+ private:
+  struct State : AsyncState {
+    std::optional<Tensor<T>> value;
+  };
+  std::shared_ptr<State> state_;
+
+  friend class ExecutionStream;
+ public:
+/** Empty handle, not valid until assigned */
+  TensorFuture() = default;
+
+  inline bool isValid() const {return state_ != nullptr;}
+  inline bool isReady() const {return state_ != nullptr && state_->isReady();}
+/** Blocks until ready. Rethrows exception of failed op */
+  void Wait() const;
+/** Result, waits when not ready. Rethrows exception of failed op */
+  const Tensor<T>& Get() const;
+};
+
+/** Element type of Tensor returned by op called on Tensor<Ts>... */
+template<typename>
+struct TensorElementOf;
+template<typename T>
+struct TensorElementOf<Tensor<T>> {
+  using type = T;
+};
+template<typename Op, typename... Ts>
+using OpResultElement = typename TensorElementOf<std::decay_t<std::invoke_result_t<Op, const Tensor<Ts>&...>>>::type;
+
+/** Execution Stream
+ *  Records dependencies between queued ops and runs each on the thread pool once its inputs are ready.
+ *  Destructor waits for every op of the stream.
+ */
+class ExecutionStream {
+ private:
+  std::mutex mutex_;
+  std::vector<std::shared_ptr<AsyncState>> in_flight_;  // Ops not yet known to be done
+
+  void Track(std::shared_ptr<AsyncState> state);
+ public:
+  ExecutionStream() = default;
+  ExecutionStream(const ExecutionStream&) = delete;
+  ExecutionStream& operator=(const ExecutionStream&) = delete;
+  ~ExecutionStream();
+
+/** Ready Future, holding value as is */
+  template<typename T>
+  TensorFuture<T> Ready(Tensor<T> value);
+/** Enqueue
+ *  Queues op(inputs.Get()...), which returns a Tensor, to run once every input is ready.
+ *  Throws when an input is not a valid future.
+ */
+  template<typename Op, typename... Ts>
+  TensorFuture<OpResultElement<Op, Ts...>> Enqueue(Op op, const TensorFuture<Ts>&... inputs);
+
+// Operations ---------------------------------------------------
+/** a * b, see Tensor's operator* */
+  template<typename T>
+  TensorFuture<T> Multiply(const TensorFuture<T>& a, const TensorFuture<T>& b);
+/** Batched a * b, see Tensor's BatchedMatmul */
+  template<typename T>
+  TensorFuture<T> BatchedMatmul(const TensorFuture<T>& a, const TensorFuture<T>& b);
+/** a + b, see Tensor's operator+ */
+  template<typename T>
+  TensorFuture<T> Add(const TensorFuture<T>& a, const TensorFuture<T>& b);
+/** a.Map(operations...), see Tensor's Map */
+  template<typename T, typename... UnaryOps>
+  TensorFuture<T> Map(const TensorFuture<T>& a, UnaryOps... operations);
+// End of Operations --------------------------------------------
+
+/** Synchronize
+ *  Waits for every op queued so far. Rethrows the first exception among them.
+ */
+  void Synchronize();
+};
+
+} // util
+} // cpp_nn
+
+#include "../src/CPPNeuralNet/Utils/async.tpp"
+
+#endif // CPP_NN_ASYNC
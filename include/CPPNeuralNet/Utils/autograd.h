@@ -0,0 +1,183 @@
+#ifndef CPP_NN_AUTOGRAD
+#define CPP_NN_AUTOGRAD
+
+#include <deque>
+#include <vector>
+
+#include "CPPNeuralNet/Utils/tensor.h"
+
+namespace cpp_nn {
+namespace util {
+
+/**
+ * Reverse-Mode Automatic Differentiation.
+ *
+ * Operations on Variables are run at once and recorded onto a Tape, in order.
+ * Backward then sweeps the tape in reverse, so every node is reached after all of its consumers,
+ *  and adds each node's gradient into its inputs' gradients.
+ *
+ * ie)
+ *  Tape<double> tape;
+ *  Variable<double> x = tape.Leaf(input, false), W = tape.Leaf(weight), b = tape.Leaf(bias);
+ *  Variable<double> loss = tape.Mean(tape.Apply(x * W + b, Activation::kReLU));
+ *  tape.Backward(loss);
+ *  tape.getGradient(W);  // dloss/dW
+ *
+ * Overhead per operation is kept to a fixed record:
+ *  Nodes are plain structs, dispatched in backward by a switch over TapeOp, never a std::function.
+ *  Clear keeps node records and buffers, so a training loop that rebuilds the same graph every step
+ *    reuses them and stops allocating after the first step.
+ *
+ * Memory:
+ *  Values and gradients live in a pool of buffers. A buffer goes back to the pool as soon as it is dead:
+ *  - A value is kept only while some pending backward step reads it, ie) Matmul reads both inputs,
+ *    Add reads neither. Values no backward step reads are released as soon as Backward starts.
+ *  - An intermediate gradient is released once added into its inputs.
+ *  Later nodes take released buffers, so the sweep needs far fewer buffers than there are nodes.
+ *  Leaves and the root keep their values, and leaves their gradients.
+ */
+
+/** Recorded Operations */
+enum class TapeOp {
+  kLeaf,
+  kMatmul,     // [..., n, m] * [m, d], as Tensor operator*
+  kAdd,        // Broadcasting, as ElementwiseApply
+  kSubtract,
+  kMultiply,   // Elementwise
+  kScale,      // By constant
+  kActivation, // Elementwise, see Activation in gemm.h
+  kSum,        // Of every element, into [1]
+  kSumAxis,
+  kMean,       // Of every element, into [1]
+  kReshape,
+  kTranspose   // Of two axes, moving the elements
+};
+
+template<typename T>
+class Tape;
+
+/** Variable
+ *  Handle to a node of a Tape. Cheap to copy. Invalidated by Tape::Clear.
+ */
+template<typename T = double>
+class Variable {
+ private:
+  Tape<T>* tape_;
+  int index_;
+ public:
+  Variable() : tape_(nullptr), index_(-1) {}
+  Variable(Tape<T>* tape, int index) : tape_(tape), index_(index) {}
+
+  inline Tape<T>* getTape() const {return tape_;}
+  inline int getIndex() const {return index_;}
+  inline bool isValid() const {return tape_ != nullptr;}
+  const Tensor<T>& getValue() const;
+  const Tensor<T>& getGradient() const;
+
+/** Operators, recorded on the Variable's tape. operator* is Matmul */
+  Variable<T> operator*(const Variable<T>& other) const;
+  Variable<T> operator+(const Variable<T>& other) const;
+  Variable<T> operator-(const Variable<T>& other) const;
+};
+
+template<typename T = double>
+class Tape {
+ private:
+  struct Node {
+    TapeOp op;
+    int inputs[2];           // -1 if none
+    int axis;                // kSumAxis, kTranspose
+    int axis_two;            // kTranspose
+    T scalar;                // kScale
+    Activation activation;   // kActivation
+    std::vector<int> shape;  // Of value
+    const Tensor<T>* external; // Value of leaf, not owned
+    int value;               // Buffer of value, -1 once released
+    int gradient;            // Buffer of gradient, -1 until first contribution
+    int saved_uses;          // Pending backward steps that read value
+    bool requires_gradient;
+  };
+  std::vector<Node> nodes_;  // Only first num_nodes_ are live, the rest kept for reuse
+  int num_nodes_;
+  int root_;
+  bool backward_done_;
+
+  std::deque<Tensor<T>> buffers_; // deque, so references stay valid as the pool grows
+  std::vector<int> free_buffers_;
+  std::vector<AccumulatorType<T>> scratch_;
+
+// Housekeeping -------------------------------------------------
+/** Appends node of given op and value shape, with value buffer acquired */
+  int Record(TapeOp op, int input_one, int input_two, const std::vector<int>& shape);
+/** Checks variable is a live node of this tape, and returns its index */
+  int IndexOf(const Variable<T>& variable) const;
+  Tensor<T>& ValueOf(int node);
+/** Buffer of given shape, from pool when one is free */
+  int Acquire(const std::vector<int>& shape);
+  void Release(int& buffer);
+/** Gradient of node, zeroed on first contribution */
+  T* GradientOf(int node);
+/** One fewer backward step reads node's value, released at none unless leaf or root */
+  void Unuse(int node);
+/** Adds gradient of broadcast result, of out_shape, into gradient of node, summing broadcast axes */
+  void Unbroadcast(const T* gradient, const std::vector<int>& out_shape, int node);
+  void BackwardNode(int index);
+// End of Housekeeping ------------------------------------------
+ public:
+  Tape();
+  Tape(const Tape&) = delete;
+  Tape& operator=(const Tape&) = delete;
+
+// Recording ----------------------------------------------------
+/** Leaf
+ *  Records given Tensor as input. It is referred to, not copied,
+ *    so must stay alive and unchanged until Backward.
+ *  Gradient is only computed for leaves, and nodes depending on leaves, that require it.
+ */
+  Variable<T> Leaf(const Tensor<T>& value, bool requires_gradient = true);
+/** Matrix Multiplication, [..., n, m] * [m, d] -> [..., n, d]
+ *  Throws 'Unsupported Shapes' for other shapes, and 'Dimension Mismatch' if m differs.
+ */
+  Variable<T> Matmul(const Variable<T>& a, const Variable<T>& b);
+/** Elementwise, broadcasting as Tensor::BroadcastedWith */
+  Variable<T> Add(const Variable<T>& a, const Variable<T>& b);
+  Variable<T> Subtract(const Variable<T>& a, const Variable<T>& b);
+  Variable<T> Multiply(const Variable<T>& a, const Variable<T>& b);
+  Variable<T> Scale(const Variable<T>& a, T scalar);
+  Variable<T> Apply(const Variable<T>& a, Activation activation);
+/** Reductions, see Tensor::Sum */
+  Variable<T> Sum(const Variable<T>& a);
+  Variable<T> Sum(const Variable<T>& a, int axis);
+  Variable<T> Mean(const Variable<T>& a);
+/** Shape, see Tensor::Reshape. Transpose moves elements, so data() follows the new shape */
+  Variable<T> Reshape(const Variable<T>& a, const std::vector<int>& dims);
+  Variable<T> Transpose(const Variable<T>& a, int axis_one, int axis_two);
+// End of Recording ---------------------------------------------
+
+// Backward -----------------------------------------------------
+/** Backward
+ *  Computes gradient of root, which must be of a single element, with respect to every node requiring it.
+ *  Runs once per recording. Throws 'Already Run' on a second call before Clear.
+ */
+  void Backward(const Variable<T>& root);
+/** Value of node. Throws 'Value Released' for intermediate values freed by Backward */
+  const Tensor<T>& getValue(const Variable<T>& variable);
+/** Gradient of leaf, after Backward. Throws 'No Gradient' if none was computed */
+  const Tensor<T>& getGradient(const Variable<T>& variable);
+/** Clear
+ *  Forgets every node, keeping records and buffers for the next recording.
+ */
+  void Clear();
+// End of Backward ----------------------------------------------
+
+  inline int getNumNodes() const {return num_nodes_;}
+/** Number of buffers pool has ever made */
+  inline int getNumBuffers() const {return buffers_.size();}
+};
+
+} // util
+} // cpp_nn
+
+#include "../src/CPPNeuralNet/Utils/autograd.tpp"
+
+#endif // CPP_NN_AUTOGRAD
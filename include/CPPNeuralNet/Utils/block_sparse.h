@@ -0,0 +1,188 @@
+#ifndef CPP_NN_BLOCK_SPARSE
+#define CPP_NN_BLOCK_SPARSE
+
+#include <vector>
+#include <cstdint>
+
+#include "CPPNeuralNet/Utils/gemm.h"
+
+namespace cpp_nn {
+namespace util {
+
+/**
+ * Structured Sparsity.
+ * Formats and GEMM kernels for pruned [K x N] weights B, in products C = A * B with dense A.
+ * Unlike CSR, non-zeros come in fixed shapes, so the inner loops have fixed trip counts
+ *  over contiguous columns of C and vectorize like the dense micro kernel.
+ *
+ * BlockSparseMatrix :: [K x N] cut into [block_rows x block_cols] blocks, only non-zero blocks kept.
+ *                      Stored block column by block column, so each thread sweeps one strip of C
+ *                        and touches only the blocks that feed it.
+ *                      Supported shapes are 4x4, 1x16 (16 output columns of one input row)
+ *                        and 16x1 (16 input rows of one output column).
+ *
+ * TwoFourSparseMatrix :: N:M 2:4 sparsity. Every group of 4 consecutive rows of a column holds
+ *                          at most 2 non-zeros, kept with their 2-bit position in the group.
+ *                        Exactly half the multiply-adds of dense.
+ *
+ * StructuredSparseMatrix :: weight checked once for the above, and kept in the format that pays off,
+ *                             so a pruned Linear layer runs on these transparently.
+ */
+
+// Block Sparse -------------------------------------------------
+/** Block Sparse Matrix */
+template<typename T>
+class BlockSparseMatrix {
+ private:
+  int K_;
+  int N_;
+  int block_rows_;
+  int block_cols_;
+  std::vector<int> col_offsets_;         // Per block column, into block_row_indices_. Block columns + 1
+  std::vector<int> block_row_indices_;   // Block row of each kept block
+  std::vector<T> blocks_;                // Kept blocks, each [block_rows x block_cols] row-major, zero-padded at edges
+ public:
+  BlockSparseMatrix() : K_(0), N_(0), block_rows_(1), block_cols_(1) {}
+/** Packs B, keeping blocks with any non-zero.
+ *  Throws for unsupported block shape. */
+  void Pack(int K, int N, const T* B, int b_row_stride, int b_col_stride, int block_rows, int block_cols);
+/** Copies B's values into the kept blocks, leaving the pattern as packed. B outside it is read as zero */
+  void Refill(const T* B, int b_row_stride, int b_col_stride);
+/** Zeroes [K x N] matrix D outside the kept blocks */
+  void Mask(T* D, int d_row_stride, int d_col_stride) const;
+
+  inline int getRows() const {return K_;}
+  inline int getCols() const {return N_;}
+  inline int getBlockRows() const {return block_rows_;}
+  inline int getBlockCols() const {return block_cols_;}
+  inline int getNonZeroBlocks() const {return block_row_indices_.size();}
+  inline const int* getColOffsets() const {return col_offsets_.data();}
+  inline const int* getBlockRowIndices() const {return block_row_indices_.data();}
+  inline const T* getBlocks() const {return blocks_.data();}
+
+/** Fraction of all-zero blocks of B for given block shape.
+ *  Stops early and returns 0 once the fraction is certain to be below at_least. */
+  static double ZeroBlockFraction(int K, int N, const T* B, int b_row_stride, int b_col_stride,
+                                  int block_rows, int block_cols, double at_least = 0.0);
+};
+// End of Block Sparse ------------------------------------------
+
+// 2:4 Sparse ---------------------------------------------------
+/** 2:4 Structured Sparse Matrix */
+template<typename T>
+class TwoFourSparseMatrix {
+ private:
+  int K_;
+  int N_;
+  int stride_;                    // N rounded up to 16, padding holds zeros
+  std::vector<T> values_;         // [2 * groups x stride_], two kept values of each group, row-major
+  std::vector<uint8_t> indices_;  // Same layout, position of value within its group of 4
+ public:
+  TwoFourSparseMatrix() : K_(0), N_(0), stride_(0) {}
+/** Packs B. Throws if some group holds more than 2 non-zeros.
+ *  Groups with fewer keep zeros in the free slots, so every group names exactly 2 positions. */
+  void Pack(int K, int N, const T* B, int b_row_stride, int b_col_stride);
+/** Copies B's values at the kept positions, leaving the pattern as packed. B outside it is read as zero */
+  void Refill(const T* B, int b_row_stride, int b_col_stride);
+/** Zeroes [K x N] matrix D outside the kept positions */
+  void Mask(T* D, int d_row_stride, int d_col_stride) const;
+
+  inline int getRows() const {return K_;}
+  inline int getCols() const {return N_;}
+  inline int getGroups() const {return (K_ + 3) / 4;}
+  inline int getStride() const {return stride_;}
+  inline const T* getValues() const {return values_.data();}
+  inline const uint8_t* getIndices() const {return indices_.data();}
+
+/** Whether B follows 2:4 pattern, stops at first violating group */
+  static bool Matches(int K, int N, const T* B, int b_row_stride, int b_col_stride);
+};
+// End of 2:4 Sparse --------------------------------------------
+
+// Structured Sparse --------------------------------------------
+/** Format a StructuredSparseMatrix keeps its weight in */
+enum class StructuredFormat {
+  kDense,      // Too few zeros, nothing packed
+  kBlockSparse,
+  kTwoFour
+};
+
+/** Structured Sparse Matrix
+ *  Row-major [K x N] weight B, checked once for zero blocks and 2:4 pattern by Pack,
+ *    and packed in the format that pays off, see SetBlockSparseThreshold.
+ *  The pattern then stays fixed while B's values change, ie) under training:
+ *    Refill copies them in, O(kept) and without allocating, and Mask keeps dC/dB inside the pattern.
+ *  Block patterns are packed transposed as well, so products with B^T skip the same blocks.
+ */
+template<typename T>
+class StructuredSparseMatrix {
+ private:
+  StructuredFormat format_;
+  BlockSparseMatrix<T> blocks_;
+  BlockSparseMatrix<T> transposed_blocks_;  // B^T, [N x K]
+  TwoFourSparseMatrix<T> two_four_;
+ public:
+  StructuredSparseMatrix() : format_(StructuredFormat::kDense) {}
+/** Checks B and packs it when enough is structurally zero. Returns the format chosen */
+  StructuredFormat Pack(int K, int N, const T* B, int ldb);
+/** Copies B's values into the pattern of last Pack. Nothing to do when dense */
+  void Refill(const T* B, int ldb);
+/** Zeroes [K x N] matrix D, ie) dC/dB, outside the pattern of last Pack. Nothing to do when dense */
+  void Mask(T* D, int ldd) const;
+
+  inline StructuredFormat getFormat() const {return format_;}
+  inline const BlockSparseMatrix<T>& getBlocks() const {return blocks_;}
+  inline const BlockSparseMatrix<T>& getTransposedBlocks() const {return transposed_blocks_;}
+  inline const TwoFourSparseMatrix<T>& getTwoFour() const {return two_four_;}
+};
+// End of Structured Sparse -------------------------------------
+
+// Kernels ------------------------------------------------------
+/** Block Sparse GEMM
+ *  C[M x N] = epilogue(A[M x K] * B), skipping B's zero blocks.
+ *  Rows of A are taken 4 at a time, so each loaded block is used for 4 rows of C.
+ */
+template<typename T, typename Acc = AccumulatorType<T>>
+void BlockSparseGemm(int M, const T* A, int a_row_stride, int a_col_stride,
+                     const BlockSparseMatrix<T>& B, T* C, int ldc,
+                     const GemmEpilogue<T>& epilogue = GemmEpilogue<T>());
+/** 2:4 Sparse GEMM
+ *  C[M x N] = epilogue(A[M x K] * B), half the multiply-adds of dense.
+ */
+template<typename T, typename Acc = AccumulatorType<T>>
+void TwoFourSparseGemm(int M, const T* A, int a_row_stride, int a_col_stride,
+                       const TwoFourSparseMatrix<T>& B, T* C, int ldc,
+                       const GemmEpilogue<T>& epilogue = GemmEpilogue<T>());
+/** Structured Sparse GEMM
+ *  C[M x N] = epilogue(A[M x K] * B), by the kernel of B's format.
+ *  Returns false, having done nothing, when B is dense or M is below the kernel's row tile;
+ *    caller then runs Gemm on B unpacked.
+ */
+template<typename T, typename Acc = AccumulatorType<T>>
+bool StructuredSparseGemm(int M, const T* A, int a_row_stride, int a_col_stride,
+                          const StructuredSparseMatrix<T>& B, T* C, int ldc,
+                          const GemmEpilogue<T>& epilogue = GemmEpilogue<T>());
+/** Structured Sparse GEMM, Transposed
+ *  C[M x K] = epilogue(A[M x N] * B^T). Only block formats keep B^T, so also returns false for 2:4.
+ */
+template<typename T, typename Acc = AccumulatorType<T>>
+bool StructuredSparseGemmTransposed(int M, const T* A, int a_row_stride, int a_col_stride,
+                                    const StructuredSparseMatrix<T>& B, T* C, int ldc,
+                                    const GemmEpilogue<T>& epilogue = GemmEpilogue<T>());
+// End of Kernels -----------------------------------------------
+
+/** Block Sparse Threshold
+ *  Fraction of zero blocks at which StructuredSparseMatrix::Pack chooses a block format over dense.
+ *  2:4 is chosen when B follows it and the threshold is at most 0.5.
+ *  0 or below disables. Default is 0.7, about where 4x4 blocks overtake dense Gemm.
+ *    Tuned value depends on the machine, see 'make bench'.
+ */
+void SetBlockSparseThreshold(double threshold);
+double getBlockSparseThreshold();
+
+} // util
+} // cpp_nn
+
+#include "../src/CPPNeuralNet/Utils/block_sparse.tpp"
+
+#endif // CPP_NN_BLOCK_SPARSE
@@ -28,7 +28,7 @@ class ElementReference : public TensorReference<T> { // ========================
   virtual const T& getElement() const;
   /** Getter */
   inline T& operator()() {return getElement();}
-  inline const T& operator()() __EDG_CONSTEXPR_ENABLED__ {return getElement();}
+  inline const T& operator()() const {return getElement();}
 // End of Accessors ---------------------------------------------
 
 }; // End of ElementReference =============================================================================
@@ -39,11 +39,16 @@ class ElementReference : public TensorReference<T> { // ========================
  * Think of as: 1-Chunk-order TensorReference with custum Iteration by given shape
  */
 template<typename T = double>
-class BroadcastReference : ElementReference<T> { // ========================================================
+class BroadcastReference : public ElementReference<T> { // =================================================
  private:
   const std::vector<int> kBroadcastShape; // shape of the target. iteration will follow the broadcastes shape
                                     // empty if not broadcasted, then will follow original shape
   std::vector<int> indices_; // For this, we need to go back to using vector of indicies
+  std::vector<int> strides_; // Address jump for each broadcast axis. 
+                             // 0 for broadcasted axes, so that index moves but address does not
+
+/** Sets strides_ from tensor and broadcast shape */
+  void ComputeStrides();
  public:
  // Constructor --------------------------------------------------
 /** Tensor-Referencing with Broadcasting
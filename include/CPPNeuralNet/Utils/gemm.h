@@ -0,0 +1,182 @@
+#ifndef CPP_NN_GEMM
+#define CPP_NN_GEMM
+
+#include <vector>
+#include <cmath>
+
+#include "CPPNeuralNet/Utils/numeric_types.h"
+
+namespace cpp_nn {
+namespace util {
+
+/**
+ * GEMM Kernels.
+ * Raw, pointer-level matrix multiplcation used by Tensor and MatrixReference.
+ *
+ * Matrices are described by pointer and strides, so that the same kernel reads
+ *  row-major, column-major or transposed operands without moving data.
+ *  ie) element [r][c] of A is A[r * row_stride + c * col_stride]
+ *
+ * Multiplcation is blocked so that packed panels of A and B fit in cache,
+ *  and the innermost kernel keeps a small [kGemmMR x kGemmNR] tile of C in registers.
+ * The epilogue is applied to this tile before it is written back,
+ *  so bias, activation and residual cost no extra pass over C.
+ *
+ * Products are accumulated in Acc, by default AccumulatorType<T>, see numeric_types.h.
+ *  Operands are widened to Acc as they are packed, and the sum over all of K is kept in Acc,
+ *    so that the result is rounded (or for integers, saturated) only once at writeback.
+ *  ie) bf16 and fp16 move 16-bit data while all arithmetic is float32,
+ *      int products accumulate in int64, and float may request double by Gemm<float, double>.
+ */
+
+// Blocking Parameters ------------------------------------------
+constexpr int kGemmMR = 4;   // Rows of register tile
+constexpr int kGemmNR = 8;   // Cols of register tile
+constexpr int kGemmMC = 64;  // Rows of packed A block
+constexpr int kGemmKC = 256; // Depth of packed A and B panels
+constexpr int kGemmNC = 1024;// Cols of packed B panel
+// End of Blocking Parameters -----------------------------------
+
+/** Activation to be fused into writeback */
+enum class Activation {
+  kNone,
+  kReLU,
+  kGELU,    // tanh approximation
+  kSigmoid
+};
+
+/** Which axis the bias vector runs along
+ *  kRow: bias has one entry per column, added to every row. ie) Dense layer bias
+ *  kCol: bias has one entry per row, added to every column
+ */
+enum class BiasAxis {
+  kRow,
+  kCol
+};
+
+/** Epilogue Descriptor
+ *  Result of C = A * B is written as
+ *    C = activation(alpha * A * B + beta * C + bias) + residual
+ *  C is only read when beta is non-zero.
+ */
+template<typename T>
+struct GemmEpilogue {
+  T alpha = T(1);
+  T beta = T(0);
+  const T* bias = nullptr;          // nullptr if no bias
+  BiasAxis bias_axis = BiasAxis::kRow;
+  Activation activation = Activation::kNone;
+  const T* residual = nullptr;      // nullptr if no residual, else matrix of C's shape
+  int residual_ld = 0;              // row stride of residual
+};
+
+/** Activation Function */
+template<typename T>
+inline T ApplyActivation(Activation activation, T x) {
+  switch (activation) {
+    case Activation::kReLU:
+      return x > T(0) ? x : T(0);
+    case Activation::kGELU:
+      return T(0.5 * x * (1.0 + std::tanh(0.7978845608028654 * (x + 0.044715 * x * x * x))));
+    case Activation::kSigmoid:
+      return T(1.0 / (1.0 + std::exp(-double(x))));
+    default:
+      return x;
+  }
+}
+/** Activation Derivative
+ *  dy/dx of y = ApplyActivation(activation, x), given both x and y.
+ */
+template<typename T>
+inline T ActivationDerivative(Activation activation, T x, T y) {
+  switch (activation) {
+    case Activation::kReLU:
+      return x > T(0) ? T(1) : T(0);
+    case Activation::kGELU: {
+      const double t = std::tanh(0.7978845608028654 * (x + 0.044715 * x * x * x));
+      return T(0.5 * (1 + t) + 0.5 * x * (1 - t * t) * 0.7978845608028654 * (1 + 3 * 0.044715 * x * x));
+    }
+    case Activation::kSigmoid:
+      return T(y * (T(1) - y));
+    default:
+      return T(1);
+  }
+}
+
+/** General Matrix Multiplcation
+ *  C[M x N] = epilogue(A[M x K] * B[K x N])
+ *  C is row-major with row stride ldc.
+ * 
+ *  Vector-shaped products are dispatched to bandwidth-bound kernels below,
+ *    as packing and tiling only pay off when operands are reused.
+ *  - [1 x K] * [K x 1] : GemmDot
+ *  - [M x K] * [K x 1] : GemmMatrixVector
+ *  - [1 x K] * [K x N] : GemmVectorMatrix
+ *  - [M x 1] * [1 x N] : GemmOuter
+ * 
+ *  Very large row-major products go to StrassenGemm when opted in, see strassen.h
+ */
+template<typename T, typename Acc = AccumulatorType<T>>
+void Gemm(int M, int N, int K,
+          const T* A, int a_row_stride, int a_col_stride,
+          const T* B, int b_row_stride, int b_col_stride,
+          T* C, int ldc,
+          const GemmEpilogue<T>& epilogue = GemmEpilogue<T>());
+
+/** Packed B Operand
+ *  Whole [K x N] matrix laid out as the panels Gemm would pack it into.
+ *  When same B is multiplied against many A, ie) [batch, n, m] * [m, d],
+ *    it is packed once here and reused by GemmPacked for every A.
+ */
+template<typename T, typename Acc = AccumulatorType<T>>
+class GemmPackedB {
+ private:
+  int K_;
+  int N_;
+  std::vector<Acc> panels_;  // Already widened to accumulator type
+ public:
+  GemmPackedB() : K_(0), N_(0) {}
+/** Packs B, reusing storage of previous packing when possible */
+  void Pack(int K, int N, const T* B, int b_row_stride, int b_col_stride);
+/** Panel of [kc x nc] block starting at [pc][jc] */
+  const Acc* getPanel(int pc, int jc) const;
+  inline int getRows() const {return K_;}
+  inline int getCols() const {return N_;}
+};
+
+/** Matrix Multiplcation with Prepacked B
+ *  C[M x N] = epilogue(A[M x K] * B[K x N]), where B was packed by GemmPackedB.
+ */
+template<typename T, typename Acc>
+void GemmPacked(int M, const T* A, int a_row_stride, int a_col_stride,
+                const GemmPackedB<T, Acc>& B, T* C, int ldc,
+                const GemmEpilogue<T>& epilogue = GemmEpilogue<T>());
+
+// Vector Kernels -----------------------------------------------
+/** Dot Product
+ *  Returns sum of x[i] * y[i] for K elements with given strides, in accumulator type */
+template<typename T, typename Acc = AccumulatorType<T>>
+Acc GemmDot(int K, const T* x, int x_stride, const T* y, int y_stride);
+/** Matrix-Vector Product
+ *  C[M x 1] = epilogue(A[M x K] * x[K x 1]) */
+template<typename T, typename Acc = AccumulatorType<T>>
+void GemmMatrixVector(int M, int K, const T* A, int a_row_stride, int a_col_stride,
+                      const T* x, int x_stride, T* C, int ldc, const GemmEpilogue<T>& epilogue);
+/** Vector-Matrix Product
+ *  C[1 x N] = epilogue(x[1 x K] * B[K x N]) */
+template<typename T, typename Acc = AccumulatorType<T>>
+void GemmVectorMatrix(int N, int K, const T* x, int x_stride,
+                      const T* B, int b_row_stride, int b_col_stride, T* C, const GemmEpilogue<T>& epilogue);
+/** Outer Product, Rank-1 Update
+ *  C[M x N] = epilogue(x[M x 1] * y[1 x N]) */
+template<typename T, typename Acc = AccumulatorType<T>>
+void GemmOuter(int M, int N, const T* x, int x_stride, const T* y, int y_stride,
+               T* C, int ldc, const GemmEpilogue<T>& epilogue);
+// End of Vector Kernels ----------------------------------------
+
+} // util
+} // cpp_nn
+
+#include "../src/CPPNeuralNet/Utils/gemm.tpp"
+
+#endif // CPP_NN_GEMM
@@ -0,0 +1,53 @@
+#ifndef CPP_NN_MEMORY_PLANNER
+#define CPP_NN_MEMORY_PLANNER
+
+#include <cstddef>
+#include <vector>
+
+namespace cpp_nn {
+namespace util {
+
+/**
+ * Static Memory Planning.
+ *
+ * When every buffer of a computation is known ahead, with its size and the steps that write and last read it,
+ *  buffers whose lifetimes do not overlap can share storage. PlanMemory places them all in one arena.
+ *
+ * Lifetimes are intervals [first, last] of steps, so buffers that may not share storage form an interval graph.
+ * Placing them is interval graph coloring with sizes: buffers are taken largest first,
+ *  and each goes to the lowest offset not taken by a placed buffer overlapping it in time.
+ *
+ * Shared Storage:
+ *  A buffer may take over storage of an earlier buffer once that one is dead, ie) a recomputed output.
+ *  Writing at the very step that last reads the other is in place, so that step must work element by element,
+ *  ie) ReLU forward. Buffers sharing storage are placed as one, so together they cost a single buffer.
+ */
+
+/** Lifetime of one buffer, steps inclusive */
+struct BufferLifetime {
+  size_t size = 0;        // In elements
+  int first = 0;          // Step that writes it
+  int last = 0;           // Last step that reads it
+  int in_place_of = -1;   // Index of buffer whose storage this one takes over, -1 if none
+};
+
+struct MemoryPlan {
+  std::vector<size_t> offsets; // Of each buffer, in elements
+  size_t arena_size = 0;       // Elements spanned by all buffers
+  size_t peak_size = 0;        // Most elements live at any one step, shared storage once
+  size_t total_size = 0;       // Elements of all buffers, the arena without any sharing
+};
+
+/** Plan Memory
+ *  Offsets of given buffers in one arena, such that buffers live at the same step never overlap.
+ *  Sizes are rounded up to a multiple of alignment, so every offset is one too.
+ *  Throws 'Invalid Lifetime' if last precedes first,
+ *    and 'Invalid In-Place' unless in_place_of names an earlier buffer, at least as large,
+ *    and every earlier buffer of that storage is last read at or before the step that writes this one.
+ */
+MemoryPlan PlanMemory(const std::vector<BufferLifetime>& buffers, size_t alignment = 1);
+
+} // util
+} // cpp_nn
+
+#endif // CPP_NN_MEMORY_PLANNER
@@ -0,0 +1,217 @@
+#ifndef CPP_NN_NUMERIC_TYPES
+#define CPP_NN_NUMERIC_TYPES
+
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+#if defined(__F16C__)
+#include <immintrin.h>
+#endif
+
+namespace cpp_nn {
+namespace util {
+
+/**
+ * 16-bit Floating Point Types.
+ * Storage-only types, halving memory traffic of float32 for bandwidth-bound work.
+ *
+ * bf16: 1 sign, 8 exponent, 7 mantissa bits. ie) top half of float32, same range, ~3 significant digits
+ * fp16: 1 sign, 5 exponent, 10 mantissa bits. IEEE half, range +-65504, ~3.3 significant digits
+ *
+ * Neither defines arithmetic of its own. Both convert implicitly to and from float,
+ *  so every expression on them is evaluated in float32 and only rounded on store.
+ *  ie) Tensor<bf16> works as is, loading 16 bits and computing in float registers.
+ * Conversion from float rounds to nearest even. NaN stays NaN, overflow of fp16 goes to infinity.
+ *
+ * Kernels that sum many products (Gemm and its vector kernels) accumulate in AccumulatorType<T>,
+ *  which is float32 for both, so long sums do not suffer 16-bit rounding at every step.
+ */
+
+// Scalar Conversion --------------------------------------------
+/** float -> bf16 bits, round to nearest even */
+inline uint16_t FloatToBF16Bits(float value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  if ((bits & 0x7fffffffu) > 0x7f800000u) return static_cast<uint16_t>((bits >> 16) | 0x0040u); // Quiet NaN
+  bits += 0x7fffu + ((bits >> 16) & 1u);
+  return static_cast<uint16_t>(bits >> 16);
+}
+/** bf16 bits -> float, exact */
+inline float BF16BitsToFloat(uint16_t half) {
+  const uint32_t bits = static_cast<uint32_t>(half) << 16;
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+/** float -> fp16 bits, round to nearest even */
+inline uint16_t FloatToFP16Bits(float value) {
+#if defined(__F16C__)
+  return static_cast<uint16_t>(_cvtss_sh(value, _MM_FROUND_TO_NEAREST_INT));
+#else
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  const uint32_t sign = (bits >> 16) & 0x8000u;
+  bits &= 0x7fffffffu;
+
+  if (bits >= 0x7f800000u) return sign | (bits > 0x7f800000u ? 0x7e00u : 0x7c00u); // NaN, Inf
+  if (bits >= 0x477ff000u) return sign | 0x7c00u;    // Rounds beyond 65504
+  if (bits < 0x38800000u) {
+    // Subnormal fp16, in units of 2^-24
+    if (bits < 0x33000000u) return sign;             // At most 2^-25, rounds to 0
+    const int exponent = bits >> 23;
+    const int shift = 126 - exponent;
+    const uint32_t mantissa = (bits & 0x7fffffu) | 0x800000u;
+    uint32_t half = mantissa >> shift;
+    const uint32_t remainder = mantissa & ((1u << shift) - 1);
+    const uint32_t midpoint = 1u << (shift - 1);
+    if (remainder > midpoint || (remainder == midpoint && (half & 1u))) ++half;
+    return sign | half;
+  }
+  // Normal, rebias exponent from 127 to 15 and keep top 10 mantissa bits
+  uint32_t half = (bits >> 13) - (112u << 10);
+  const uint32_t remainder = bits & 0x1fffu;
+  if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) ++half;
+  return static_cast<uint16_t>(sign | half);
+#endif
+}
+/** fp16 bits -> float, exact */
+inline float FP16BitsToFloat(uint16_t half) {
+#if defined(__F16C__)
+  return _cvtsh_ss(half);
+#else
+  const uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16;
+  const uint32_t exponent = (half >> 10) & 0x1fu;
+  const uint32_t mantissa = half & 0x3ffu;
+
+  uint32_t bits;
+  if (exponent == 0) {
+    const float value = static_cast<float>(mantissa) * 5.9604644775390625e-8f; // 2^-24
+    return sign ? -value : value;
+  } else if (exponent == 31) {
+    bits = sign | 0x7f800000u | (mantissa << 13);
+  } else {
+    bits = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+  }
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+#endif
+}
+// End of Scalar Conversion -------------------------------------
+
+/** bfloat16 */
+struct bf16 {
+  uint16_t bits;
+
+  bf16() : bits(0) {}
+  bf16(float value) : bits(FloatToBF16Bits(value)) {}
+  inline operator float() const {return BF16BitsToFloat(bits);}
+
+  inline bf16& operator+=(float other) {return *this = float(*this) + other;}
+  inline bf16& operator-=(float other) {return *this = float(*this) - other;}
+  inline bf16& operator*=(float other) {return *this = float(*this) * other;}
+  inline bf16& operator/=(float other) {return *this = float(*this) / other;}
+
+  static inline bf16 FromBits(uint16_t bits) {bf16 res; res.bits = bits; return res;}
+};
+
+/** IEEE 754 half precision */
+struct fp16 {
+  uint16_t bits;
+
+  fp16() : bits(0) {}
+  fp16(float value) : bits(FloatToFP16Bits(value)) {}
+  inline operator float() const {return FP16BitsToFloat(bits);}
+
+  inline fp16& operator+=(float other) {return *this = float(*this) + other;}
+  inline fp16& operator-=(float other) {return *this = float(*this) - other;}
+  inline fp16& operator*=(float other) {return *this = float(*this) * other;}
+  inline fp16& operator/=(float other) {return *this = float(*this) / other;}
+
+  static inline fp16 FromBits(uint16_t bits) {fp16 res; res.bits = bits; return res;}
+};
+
+/** Accumulator Type
+ *  Default type in which sums of T are carried before being stored back as T.
+ *  - bf16, fp16:     float
+ *  - 8-bit int:      int32, as a product of two needs at most 16 bits
+ *  - 16, 32-bit int: int64
+ *  - otherwise:      T itself. float may still be accumulated in double where explicitly requested.
+ */
+template<typename T>
+struct Accumulator {
+  using type = T;
+};
+template<>
+struct Accumulator<bf16> {
+  using type = float;
+};
+template<>
+struct Accumulator<fp16> {
+  using type = float;
+};
+template<>
+struct Accumulator<int8_t> {
+  using type = int32_t;
+};
+template<>
+struct Accumulator<uint8_t> {
+  using type = int32_t;
+};
+template<>
+struct Accumulator<int16_t> {
+  using type = int64_t;
+};
+template<>
+struct Accumulator<uint16_t> {
+  using type = int64_t;
+};
+template<>
+struct Accumulator<int32_t> {
+  using type = int64_t;
+};
+template<>
+struct Accumulator<uint32_t> {
+  using type = int64_t;
+};
+template<typename T>
+using AccumulatorType = typename Accumulator<T>::type;
+
+/** Narrowing of Accumulator
+ *  Converts accumulated value back to storage type T.
+ *  Integers saturate at T's limits rather than wrap, floating point simply rounds.
+ */
+template<typename T, typename Acc>
+inline T NarrowAccumulator(Acc value) {
+  if constexpr (std::is_integral<T>::value && std::is_integral<Acc>::value && sizeof(Acc) > sizeof(T)) {
+    if (value < static_cast<Acc>(std::numeric_limits<T>::min())) return std::numeric_limits<T>::min();
+    if (value > static_cast<Acc>(std::numeric_limits<T>::max())) return std::numeric_limits<T>::max();
+  }
+  return static_cast<T>(value);
+}
+
+// Bulk Conversion ----------------------------------------------
+/** Converts n contiguous elements
+ *  Uses F16C for fp16 and AVX-512 BF16 for float -> bf16 when compiled for them, else AVX2 or scalar code.
+ *  Results match scalar conversion, except that AVX-512 BF16 flushes float subnormals to zero.
+ */
+void ConvertElements(const bf16* source, float* destination, size_t n);
+void ConvertElements(const float* source, bf16* destination, size_t n);
+void ConvertElements(const fp16* source, float* destination, size_t n);
+void ConvertElements(const float* source, fp16* destination, size_t n);
+/** Generic conversion, static_cast element by element */
+template<typename S, typename D>
+inline void ConvertElements(const S* source, D* destination, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    destination[i] = static_cast<D>(source[i]);
+  }
+}
+// End of Bulk Conversion ---------------------------------------
+
+} // util
+} // cpp_nn
+
+#endif // CPP_NN_NUMERIC_TYPES
@@ -0,0 +1,151 @@
+#ifndef CPP_NN_QUANTIZATION
+#define CPP_NN_QUANTIZATION
+
+#include "CPPNeuralNet/Utils/tensor.h"
+#include "CPPNeuralNet/Utils/gemm.h"
+
+#include <vector>
+#include <cstdint>
+
+namespace cpp_nn {
+namespace util {
+
+/**
+ * Int8 Quantization.
+ * Low precision storage and GEMM for inference.
+ *
+ * Affine mapping between real value r and quantized value q:
+ *    r = scale * (q - zero_point)
+ * Parameters are either per-tensor, or per-channel along one axis.
+ *
+ * Convention followed by QuantizedGemm:
+ *  - Activations are uint8, asymmetric (any zero point), usually per-tensor.
+ *  - Weights are int8, symmetric (zero point 0), per-tensor or per output channel.
+ *  Then (a - za) * w sums as a * w - za * sum(w), where sum(w) is precomputed per column,
+ *    so the inner loop is pure u8 x s8 products accumulated in int32.
+ */
+
+/** Quantized Tensor
+ *  Q is storage type, uint8_t for asymmetric or int8_t for symmetric quantization.
+ */
+template<typename Q>
+class QuantizedTensor { // ================================================================================
+ private:
+  std::vector<int> dimensions_;
+  std::vector<Q> elements_;
+  std::vector<float> scales_;      // One per channel, or single for per-tensor
+  std::vector<int> zero_points_;   // Same size as scales_
+  int axis_;                       // Channel axis, -1 for per-tensor
+  int channel_block_;              // Product of dimensions after axis, ie) address jump of one channel
+ public:
+// Constructor --------------------------------------------------
+/** Dimension Constructor
+ *  Elements are set to zero_point, ie) real value 0.
+ *  For per-channel, scales and zero_points must have an entry for each index along axis.
+ */
+  QuantizedTensor(const std::vector<int>& dims, const std::vector<float>& scales,
+                  const std::vector<int>& zero_points, int axis = -1);
+// End of Constructor -------------------------------------------
+
+// Conversion ---------------------------------------------------
+/** Quantize
+ *  Chooses parameters from range of tensor's values, per-tensor or per-channel along axis.
+ *  uint8_t uses full [min, max] range (always including 0), int8_t uses symmetric [-max|r|, max|r|].
+ */
+  template<typename T>
+  static QuantizedTensor<Q> Quantize(const Tensor<T>& tensor, int axis = -1);
+/** Quantize with given parameters */
+  template<typename T>
+  static QuantizedTensor<Q> Quantize(const Tensor<T>& tensor, const std::vector<float>& scales,
+                                     const std::vector<int>& zero_points, int axis = -1);
+/** Dequantize
+ *  Returns real-valued Tensor of same shape */
+  template<typename T = float>
+  Tensor<T> Dequantize() const;
+// End of Conversion --------------------------------------------
+
+// Accessors ----------------------------------------------------
+  inline const std::vector<int>& getShape() const {return dimensions_;}
+  inline int getCapacity() const {return elements_.size();}
+  inline int getAxis() const {return axis_;}
+  inline float getScale(int channel = 0) const {return scales_[axis_ < 0 ? 0 : channel];}
+  inline int getZeroPoint(int channel = 0) const {return zero_points_[axis_ < 0 ? 0 : channel];}
+  inline Q* data() {return elements_.data();}
+  inline const Q* data() const {return elements_.data();}
+// End of Accessors ---------------------------------------------
+
+// Housekeeping -------------------------------------------------
+/** Channel of element at flat address, 0 for per-tensor */
+  int ChannelOf(int address) const;
+// End of Housekeeping ------------------------------------------
+}; // End of QuantizedTensor ==============================================================================
+
+
+/** Packed Int8 Weight
+ *  [K x N] int8 weight, stored column by column so that every output's dot product
+ *    runs over contiguous K. Column sums are kept for zero-point correction.
+ */
+class QuantizedGemmWeight {
+ private:
+  int K_;
+  int N_;
+  std::vector<int8_t> columns_;     // N columns of K, ie) weight transposed
+  std::vector<int32_t> column_sums_;
+  std::vector<float> scales_;       // One per column
+ public:
+/** Packs weight of shape [K, N]
+ *  Must be symmetric, and per-tensor or per-channel along axis 1 (output columns).
+ */
+  explicit QuantizedGemmWeight(const QuantizedTensor<int8_t>& weight);
+
+  inline int getRows() const {return K_;}
+  inline int getCols() const {return N_;}
+  inline const int8_t* getColumn(int c) const {return columns_.data() + static_cast<size_t>(c) * K_;}
+  inline int32_t getColumnSum(int c) const {return column_sums_[c];}
+  inline float getScale(int c) const {return scales_[c];}
+};
+
+/** Requantizing Epilogue
+ *  Applied to int32 accumulator of output [r][c]:
+ *    real = a_scale * w_scale[c] * acc + bias[c]
+ *    real = activation(real)
+ *  and, for uint8 output,
+ *    q = clamp(round(real / output_scale) + output_zero_point, 0, 255)
+ */
+struct RequantizeEpilogue {
+  const float* bias = nullptr;             // nullptr for no bias, else one per column
+  Activation activation = Activation::kNone;
+  float output_scale = 1.0f;
+  int output_zero_point = 0;
+};
+
+// Int8 GEMM ----------------------------------------------------
+/** Int8 Dot Product
+ *  Sum of a[k] * w[k] in int32.
+ *  Uses AVX-512 VNNI or AVX2 when compiled for them, which are exact as no int16 saturation is involved.
+ */
+int32_t QuantizedDot(int K, const uint8_t* a, const int8_t* w);
+/** Int8 GEMM, int32 result
+ *  C[M x N] = (A[M x K] - a_zero_point) * W
+ */
+void QuantizedGemm(int M, const uint8_t* A, int lda, int a_zero_point,
+                   const QuantizedGemmWeight& W, int32_t* C, int ldc);
+/** Int8 GEMM, float result with requantizing epilogue (output scale and zero point are ignored) */
+void QuantizedGemm(int M, const uint8_t* A, int lda, int a_zero_point, float a_scale,
+                   const QuantizedGemmWeight& W, float* C, int ldc, const RequantizeEpilogue& epilogue);
+/** Int8 GEMM, uint8 result with requantizing epilogue */
+void QuantizedGemm(int M, const uint8_t* A, int lda, int a_zero_point, float a_scale,
+                   const QuantizedGemmWeight& W, uint8_t* C, int ldc, const RequantizeEpilogue& epilogue);
+/** Quantized Matmul
+ *  [dims..., M, K] per-tensor uint8 input times packed [K, N] weight -> [dims..., M, N] float
+ */
+Tensor<float> QuantizedMatmul(const QuantizedTensor<uint8_t>& input, const QuantizedGemmWeight& weight,
+                              const RequantizeEpilogue& epilogue = RequantizeEpilogue());
+// End of Int8 GEMM ---------------------------------------------
+
+} // util
+} // cpp_nn
+
+#include "../src/CPPNeuralNet/Utils/quantization.tpp"
+
+#endif // CPP_NN_QUANTIZATION
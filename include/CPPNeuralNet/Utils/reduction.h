@@ -0,0 +1,47 @@
+#ifndef CPP_NN_REDUCTION
+#define CPP_NN_REDUCTION
+
+namespace cpp_nn {
+namespace util {
+
+/**
+ * Parallel Reductions.
+ * A reduced axis is cut into leaves, each folded in order by one thread,
+ *  and leaf results are combined by a pairwise tree: ((l0 + l1) + (l2 + l3)) + ...
+ * Floating point addition is not associative, so the result depends on where leaves are cut.
+ *
+ * Fast mode (default): leaves are sized to the thread count, so there are only as many partials as threads.
+ *  Results may differ in the last bits between thread counts.
+ * Deterministic mode: leaves are kReductionLeaf elements whatever the thread count,
+ *  so the cuts and the tree depend only on the shape, and results are bitwise reproducible
+ *  across thread counts and runs. Costs extra partials and tree levels, see 'make bench'.
+ *
+ * Matmul kernels split output elements among threads and never the summed dimension,
+ *  so they are deterministic in either mode.
+ */
+
+/** Elements along reduced axis folded in order, per leaf, in deterministic mode */
+constexpr int kReductionLeaf = 1024;
+
+/** Deterministic Reductions
+ *  Global toggle, default from environment variable CPP_NN_DETERMINISTIC, else off.
+ */
+void SetDeterministicReductions(bool deterministic);
+bool getDeterministicReductions();
+
+/** Parallel Axis Reduction
+ *  Reads data as [outer x length x inner] row-major, and for every o < outer, i < inner sets
+ *    result[o * inner + i] = combine over l of data[(o * length + l) * inner + i], converted to Acc.
+ *  combine must be commutative and associative up to rounding, ie) sum, max, min.
+ *  Empty axis gives identity.
+ */
+template<typename Acc, typename T, typename CombineOp>
+void ParallelReduceAxis(const T* data, int outer, int length, int inner,
+                        Acc identity, CombineOp combine, Acc* result);
+
+} // util
+} // cpp_nn
+
+#include "../src/CPPNeuralNet/Utils/reduction.tpp"
+
+#endif // CPP_NN_REDUCTION
@@ -0,0 +1,159 @@
+#ifndef CPP_NN_SPARSE_TENSOR
+#define CPP_NN_SPARSE_TENSOR
+
+#include <vector>
+
+#include "CPPNeuralNet/Utils/tensor.h"
+#include "CPPNeuralNet/Utils/gemm.h"
+
+namespace cpp_nn {
+namespace util {
+
+/**
+ * Sparse Tensors.
+ * Storage and multiplcation for mostly-zero tensors, ie) pruned weights.
+ * Memory and work are proportional to number of non-zeros (nnz), not to capacity.
+ *
+ * CooTensor :: Coordinate format, any order. List of (indices, value).
+ *              Easy to build element by element, converted to CSR for computation.
+ *
+ * CsrTensor :: Compressed Sparse Row, of [dims..., n, m] understood as in Tensor's operator*,
+ *                ie) multiarray of [n x m] matrices.
+ *              Matrix chunks are stacked into one [(dims...) * n x m] matrix, so row r of chunk c
+ *                is stacked row (c * n + r). Row i's non-zeros are
+ *                  col_indices_[row_offsets_[i] ... row_offsets_[i + 1]), with values_ alongside,
+ *                in increasing column order.
+ *
+ * Sparse x dense products (SpMM, SpMV) split rows among threads,
+ *  each row reading only the dense rows its non-zeros select.
+ * As a rule of thumb SpMM beats dense Gemm below roughly 25% density and SpMV below 15%, see 'make bench'.
+ */
+
+template<typename T>
+class CsrTensor;
+
+/** Coordinate Sparse Tensor */
+template<typename T = double>
+class CooTensor { // ======================================================================================
+ private:
+  std::vector<int> dimensions_;
+  std::vector<int> indices_;  // nnz * order, indices of ith entry at [i * order, (i + 1) * order)
+  std::vector<T> values_;
+ public:
+// Constructors -------------------------------------------------
+/** Empty Tensor of given dimensions */
+  explicit CooTensor(const std::vector<int>& dims);
+/** From Dense
+ *  Keeps every element whose magnitude is above threshold. */
+  static CooTensor<T> FromDense(const Tensor<T>& tensor, T threshold = T(0));
+// End of Constructors ------------------------------------------
+
+// Accessors ----------------------------------------------------
+  inline const std::vector<int>& getShape() const {return dimensions_;}
+  inline int getOrder() const {return dimensions_.size();}
+  inline int getNonZeros() const {return values_.size();}
+  inline const int* getIndices(int entry) const {return indices_.data() + entry * getOrder();}
+  inline const T& getValue(int entry) const {return values_[entry];}
+// End of Accessors ---------------------------------------------
+
+// Modifiers ----------------------------------------------------
+/** Insert
+ *  Appends entry. Repeated indices are summed by Coalesce.
+ *  Throws when indices are out of bounds. */
+  void Insert(const std::vector<int>& indices, T value);
+/** Coalesce
+ *  Sorts entries in row-major order of indices, and sums duplicates. */
+  void Coalesce();
+// End of Modifiers ---------------------------------------------
+
+// Conversion ---------------------------------------------------
+/** To Dense */
+  Tensor<T> ToDense() const;
+/** To CSR
+ *  Order must be at least 2. */
+  CsrTensor<T> ToCsr() const;
+// End of Conversion --------------------------------------------
+}; // End of CooTensor ====================================================================================
+
+
+/** Compressed Sparse Row Tensor */
+template<typename T = double>
+class CsrTensor { // ======================================================================================
+ private:
+  std::vector<int> dimensions_;
+  int rows_;                       // Stacked rows, product of all but last dimension
+  int cols_;
+  std::vector<int> row_offsets_;   // rows_ + 1 entries
+  std::vector<int> col_indices_;   // nnz
+  std::vector<T> values_;          // nnz
+ public:
+// Constructors -------------------------------------------------
+/** From Components
+ *  dims of order at least 2. row_offsets must be non-decreasing from 0 to nnz,
+ *    and column indices within bounds and increasing within a row. */
+  CsrTensor(const std::vector<int>& dims, std::vector<int> row_offsets,
+            std::vector<int> col_indices, std::vector<T> values);
+/** From Dense
+ *  Keeps every element whose magnitude is above threshold. */
+  static CsrTensor<T> FromDense(const Tensor<T>& tensor, T threshold = T(0));
+// End of Constructors ------------------------------------------
+
+// Accessors ----------------------------------------------------
+  inline const std::vector<int>& getShape() const {return dimensions_;}
+  inline int getRows() const {return rows_;}
+  inline int getCols() const {return cols_;}
+  inline int getNonZeros() const {return values_.size();}
+  inline const int* getRowOffsets() const {return row_offsets_.data();}
+  inline const int* getColIndices() const {return col_indices_.data();}
+  inline const T* getValues() const {return values_.data();}
+  inline T* getValues() {return values_.data();}
+/** Density, nnz / capacity */
+  double getDensity() const;
+// End of Accessors ---------------------------------------------
+
+// Conversion ---------------------------------------------------
+/** To Dense */
+  Tensor<T> ToDense() const;
+/** To COO */
+  CooTensor<T> ToCoo() const;
+// End of Conversion --------------------------------------------
+
+// Operations ---------------------------------------------------
+/** Sparse x Dense Multiplcation
+ *  [dims..., n, m] * [m, d] -> [dims..., n, d]
+ *  Dense operand is a single matrix, shared by every chunk. [m, 1] runs as Sparse Matrix-Vector.
+ */
+  Tensor<T> operator*(const Tensor<T>& dense) const;
+/** Sparse x Dense Multiplcation Into
+ *  Sets result as operator* would, with epilogue fused into writeback.
+ *  Result must already be of the product's shape.
+ */
+  void MultiplyInto(const Tensor<T>& dense, Tensor<T>& result,
+                    const MatmulEpilogue<T>& epilogue = MatmulEpilogue<T>()) const;
+// End of Operations --------------------------------------------
+}; // End of CsrTensor ====================================================================================
+
+
+// Sparse Kernels -----------------------------------------------
+/** Sparse Matrix x Dense Matrix
+ *  C[rows x N] = epilogue(A * B[cols x N]), B and C row-major with row strides ldb, ldc.
+ *  Each row of C accumulates the B rows selected by A's non-zeros, scaled by their values.
+ *  Rows are split among threads. Column-bias and residual are indexed by stacked row.
+ */
+template<typename T, typename Acc = AccumulatorType<T>>
+void SpMM(const CsrTensor<T>& A, int N, const T* B, int ldb, T* C, int ldc,
+          const GemmEpilogue<T>& epilogue = GemmEpilogue<T>());
+/** Sparse Matrix x Dense Vector
+ *  y[rows] = epilogue(A * x[cols]), strides of x and y given.
+ */
+template<typename T, typename Acc = AccumulatorType<T>>
+void SpMV(const CsrTensor<T>& A, const T* x, int x_stride, T* y, int y_stride,
+          const GemmEpilogue<T>& epilogue = GemmEpilogue<T>());
+// End of Sparse Kernels ----------------------------------------
+
+} // util
+} // cpp_nn
+
+#include "../src/CPPNeuralNet/Utils/sparse_tensor.tpp"
+
+#endif // CPP_NN_SPARSE_TENSOR
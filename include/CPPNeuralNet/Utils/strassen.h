@@ -0,0 +1,81 @@
+#ifndef CPP_NN_STRASSEN
+#define CPP_NN_STRASSEN
+
+#include <vector>
+#include <cstddef>
+
+namespace cpp_nn {
+namespace util {
+
+/**
+ * Strassen-Winograd Multiplcation.
+ * Sub-cubic, O(n^2.81), matrix multiplcation for very large products.
+ *
+ * Each level splits A, B, C into quadrants and forms C from 7 quadrant products instead of 8,
+ *  at the cost of 15 quadrant additions. Recursion stops at the cutoff,
+ *  below which the blocked Gemm kernel is faster than the extra additions are worth.
+ * Odd dimensions are peeled: the even part recurses, the leftover row, column and depth
+ *  are fixed up with vector kernels.
+ *
+ * Opt-in only, see SetStrassenCutoff.
+ *
+ * Numerical Error:
+ *  Strassen-type algorithms are not elementwise stable like the triple loop, only normwise.
+ *  For square n with recursion stopping at n0, the Winograd variant satisfies
+ *    max|C - C_computed| <= [(n / n0)^log2(18) * (n0^2 + 6 n0) - 6n] * u * max|A| * max|B| + O(u^2)
+ *  where u is unit roundoff (Higham, Accuracy and Stability of Numerical Algorithms, 2nd ed., 23.2.2).
+ *  Compared to n^2 * u for the conventional product, each level multiplies the bound by about 18/4.
+ *  In practice with n = 4096, n0 = 512 this is 3 levels, so expect ~2 fewer correct digits
+ *    in elements much smaller than max|A| * max|B|. Keep it to float64 or well-scaled float32.
+ */
+
+/** Workspace Arena
+ *  Temporaries of every recursion level are carved out of a single preallocated buffer.
+ *  Each level releases what it took before returning, so usage is stack-like.
+ */
+template<typename T>
+class StrassenWorkspace {
+ private:
+  std::vector<T> buffer_;
+  size_t used_;
+ public:
+  StrassenWorkspace() : used_(0) {}
+/** Ensures capacity of at least given number of elements. Must not be called while in use. */
+  void Reserve(size_t capacity);
+/** Takes size elements from the arena */
+  T* Allocate(size_t size);
+/** Returns arena to given mark, as returned by getMark */
+  inline void Release(size_t mark) {used_ = mark;}
+  inline size_t getMark() const {return used_;}
+  inline size_t getCapacity() const {return buffer_.size();}
+
+/** Elements of workspace needed by StrassenGemm for given shape and cutoff */
+  static size_t RequiredSize(int M, int N, int K, int cutoff);
+};
+
+/** Strassen-Winograd Matrix Multiplcation
+ *  C[M x N] = A[M x K] * B[K x N], all row-major with given row strides.
+ *  Recursion stops when any dimension falls to cutoff or below.
+ *
+ *  Workspace is grown to RequiredSize if too small.
+ */
+template<typename T>
+void StrassenGemm(int M, int N, int K,
+                  const T* A, int lda, const T* B, int ldb, T* C, int ldc,
+                  int cutoff, StrassenWorkspace<T>& workspace);
+
+/** Strassen Cutoff
+ *  When set to positive n0, Gemm on row-major operands with every dimension above 2 * n0
+ *    is computed with StrassenGemm, with recursion stopping at n0.
+ *  0 disables, which is the default.
+ *  Tuned value depends on the machine, see 'make bench' for crossover.
+ */
+void SetStrassenCutoff(int cutoff);
+int getStrassenCutoff();
+
+} // util
+} // cpp_nn
+
+#include "../src/CPPNeuralNet/Utils/strassen.tpp"
+
+#endif // CPP_NN_STRASSEN
@@ -81,6 +81,10 @@
 #include <functional>
 #include <stdexcept>
 
+#include "CPPNeuralNet/Utils/gemm.h"
+#include "CPPNeuralNet/Utils/allocator.h"
+#include "CPPNeuralNet/Utils/reduction.h"
+
 namespace cpp_nn {
 namespace util {
 
@@ -93,8 +97,28 @@ template <typename>
 class ElementReference;
 template <typename>
 class BroadcastReference;
+template <typename>
+class Tensor;
 // End of Forward Declarations ------------------------
 
+/** Matmul Epilogue
+ *  Tensor-level descriptor of GemmEpilogue, see gemm.h.
+ *  Result is written as
+ *    C = activation(alpha * A * B + beta * C + bias) + residual
+ * 
+ *  bias:     [cols] for BiasAxis::kRow, [rows] for BiasAxis::kCol. Shared by every matrix of result.
+ *  residual: Tensor of the result's shape.
+ */
+template<typename T>
+struct MatmulEpilogue {
+  T alpha = T(1);
+  T beta = T(0);
+  const Tensor<T>* bias = nullptr;
+  BiasAxis bias_axis = BiasAxis::kRow;
+  Activation activation = Activation::kNone;
+  const Tensor<T>* residual = nullptr;
+};
+
 template<typename T = double>
 class Tensor { // =========================================================================================
  private:
@@ -105,7 +129,7 @@ class Tensor { // ==============================================================
   class TensorElement { // =================================================================
    private:
     std::vector<int> dimensions_;
-    std::vector<T> elements_;
+    TensorStorage<T> elements_; // Aligned, and first-touched in parallel, or a view, see allocator.h
     int kCapacity; // Total Number of elements in Tensor, = Product of Dimensions
     std::vector<int> transpose_map_; // Map maintaining tranpose mapping. 
                                       // tm_[i] will give which stored-axes corresponds to ith order's dimension
@@ -145,9 +169,14 @@ class Tensor { // ==============================================================
    public:
 
   // TensorElement Constructor ----------------------------------
-  /** Dimension Constructor Init List */
-    TensorElement(const std::initializer_list<int>& dims, T initial_value = T());
-  /** Copy Constructor */
+  /** Dimension Constructor
+   *  Accepts both init list and vector of dimensions */
+    TensorElement(const std::vector<int>& dims, T initial_value = T());
+  /** View Constructor
+   *  Elements are not owned, but read and written in given storage, left as is */
+    TensorElement(const std::vector<int>& dims, T* storage);
+  /** Copy Constructor
+   *  Always owns its copy, even of a view */
     TensorElement(const TensorElement& other);
   // End of TensorElement Constructor ---------------------------
 
@@ -176,6 +205,13 @@ class Tensor { // ==============================================================
     inline int getCapacity() const {
       return kCapacity;
     }
+    inline bool isView() const {return elements_.isView();}
+  /** Raw Storage
+   *  Elements are stored contiguously, in row-major order of the (transposed) dimensions.
+   *  Used by kernels that iterate over the whole storage at once.
+   */
+    inline T* data() {return elements_.data();}
+    inline const T* data() const {return elements_.data();}
   /** Parenthesis Getter
    *  Same as Element Getter but with More accessible notation.
    * In Practice, intended to be used with init_list {i,j,...}
@@ -196,6 +232,11 @@ class Tensor { // ==============================================================
    */
     void Transpose(int axis_one, int axis_two); 
     // TODO: if axes' dimension is 1, maybe no need to tranpose but just move the dimension only in dimensions?
+  /** Resize
+   *  Sets new dimensions, clearing any transpose. Leading elements are kept, new ones are uninitialized.
+   *  Storage is only reallocated when it grows past the largest capacity it has held.
+   */
+    void Resize(const std::vector<int>& dims);
   // End of TensorElement Modifiers -------------------------------
 
   // friend ===================================
@@ -205,6 +246,15 @@ class Tensor { // ==============================================================
   TensorElement* elements_;
   bool ownership_; // indicates if elements_ are owned by current Tensor
                    // If owned, must delete upon destrcutor
+
+/** Adopting Constructor, takes ownership of elements */
+  explicit Tensor(TensorElement* elements);
+
+/** Epilogue Conversion
+ *  Checks bias and residual of epilogue against current Tensor as result, 
+ *    and returns kernel-level descriptor. Residual is left unset, as it differs per chunk.
+ */
+  GemmEpilogue<T> ToGemmEpilogue(const MatmulEpilogue<T>& epilogue) const;
  public:
 // Constructors -------------------------------------------------
 /** Dimension Contructors */
@@ -215,6 +265,19 @@ class Tensor { // ==============================================================
   Tensor(const Tensor<T>& other);
 /** Move Constrcutor */
   Tensor(Tensor<T>&& other);
+/** View Constructor
+ *  Tensor of given dimensions over storage owned elsewhere, ie) a slice of an arena.
+ *  Storage must hold product of dims elements and outlive the Tensor. Its contents are left as is.
+ *  Copies of a view own their elements, as does a view assigned to by operator=.
+ *  Resize may shrink a view and grow it back, but not past its original capacity.
+ */
+  static Tensor<T> View(const std::vector<int>& dims, T* storage);
+/** Destructor */
+  ~Tensor();
+/** Copy Assignment */
+  Tensor<T>& operator=(const Tensor<T>& other);
+/** Move Assignment */
+  Tensor<T>& operator=(Tensor<T>&& other);
 // End of Constructors ------------------------------------------
 
 // Accessors ----------------------------------------------------
@@ -241,11 +304,40 @@ class Tensor { // ==============================================================
   inline int getDimension(int axis) const {
     return elements_->getDimension(axis);
   }
+  inline int getCapacity() const {
+    return elements_->getCapacity();
+  }
+/** Whether elements are a view of storage owned elsewhere, see View */
+  inline bool isView() const {
+    return elements_->isView();
+  }
+/** Shape Getter
+ *  Returns dimensions of every axis, in (transposed) order */
+  std::vector<int> getShape() const;
+/** Raw Storage
+ *  getCapacity() elements, contiguous in row-major order of getShape().
+ *  Meant for kernels that work on raw pointers, ie) gemm.h
+ */
+  inline T* data() {return elements_->data();}
+  inline const T* data() const {return elements_->data();}
 // End of Accessors ---------------------------------------------
 
 // Tensor Modifiers ---------------------------------------------
 /** Transpose */
   inline void Transpose(int axis1, int axis2) {this->elements_->Transpose(axis1, axis2);}
+/** Reshape
+ *  Gives same elements new dimensions, read in row-major order of current shape.
+ *  Throws 'Capacity Mismatch' if product of dimensions differs from capacity.
+ */
+  void Reshape(const std::vector<int>& dims);
+/** Resize
+ *  Gives the Tensor new dimensions of any capacity, keeping leading elements.
+ *  Elements past the current capacity are uninitialized, as TensorAllocator default-initializes,
+ *    so a grown Tensor must be written before it is read.
+ *  Storage is only reallocated when it grows past the largest capacity it has held,
+ *    so a buffer allocated for the largest batch is resized to smaller batches without allocating.
+ */
+  inline void Resize(const std::vector<int>& dims) {this->elements_->Resize(dims);}
 // End of Tensor Modifiers --------------------------------------
 
 // Operations ---------------------------------------------------
@@ -272,13 +364,82 @@ class Tensor { // ==============================================================
  *    -reshape-> [dim1.., dim2.., 1] 
  * Outter Product are implemented by
  *  [dim1..., n, 1] * [dim2..., 1, m] -> [dim1..., dim2..., n, m] 
+ * 
+ * Each of these vector shapes, along with matrix-vector and vector-matrix products,
+ *  is detected per chunk and dispatched to its own kernel. See Gemm in gemm.h
+ * B is taken as dense whatever its zeros. A pruned weight is checked once and packed instead,
+ *  see StructuredSparseMatrix in block_sparse.h
+ * 
+ * Products are summed in AccumulatorType<T>, see numeric_types.h.
+ *  ie) float for bf16/fp16, int64 for int. Use Multiply<Acc> for another accumulator.
  */
   Tensor<T> operator*(const Tensor<T>& other) const;
+/** Tensor Multiplcation, with Accumulator
+ *  Same as operator*, with products summed in Acc and converted to T once per element.
+ *  ie) A.Multiply<double>(B) for a long float product.
+ */
+  template<typename Acc = AccumulatorType<T>>
+  Tensor<T> Multiply(const Tensor<T>& other, const MatmulEpilogue<T>& epilogue = MatmulEpilogue<T>()) const;
+/** Tensor Multiplcation Into
+ *  Sets current Tensor as A * B, following same rules as operator*.
+ *  Current Tensor must already be of the product's shape.
+ * 
+ *  Epilogue is fused into the multiplication, 
+ *    so bias, activation and residual do not require separate passes over the result.
+ */
+  template<typename Acc = AccumulatorType<T>>
+  void MultiplyInto(const Tensor<T>& A, const Tensor<T>& B, 
+                    const MatmulEpilogue<T>& epilogue = MatmulEpilogue<T>());
+/** Batched Tensor Multiplcation
+ *  Numpy-like matmul, in contrast to every-combination rule of operator*.
+ *  
+ * Rules of Batched Multiplcation:
+ * If [dims1..., n, m] * [dims2..., m, d] -> [broadcast(dims1, dims2)..., n, d]
+ *  Batch axes dims1 and dims2 are paired up following BroadcastedWith rules,
+ *    and only the paired matrices are multiplied.
+ *  ie) [4, n, m] * [4, m, d] -> [4, n, d]
+ *      [4, 1, n, m] * [3, m, d] -> [4, 3, n, d]
+ * 
+ *  Pairs are split among threads, each multiplied by Gemm.
+ *  See SetSocketPartitioning in thread_pool.h for keeping pairs on the NUMA node that holds them.
+ */
+  template<typename Acc = AccumulatorType<T>>
+  Tensor<T> BatchedMatmul(const Tensor<T>& other, 
+                          const MatmulEpilogue<T>& epilogue = MatmulEpilogue<T>()) const;
+/** Batched Tensor Multiplcation Into
+ *  Sets current Tensor as BatchedMatmul of A and B.
+ *  Current Tensor must already be of the product's shape.
+ */
+  template<typename Acc = AccumulatorType<T>>
+  void BatchedMultiplyInto(const Tensor<T>& A, const Tensor<T>& B, 
+                           const MatmulEpilogue<T>& epilogue = MatmulEpilogue<T>());
 /** Elementwise
  *  Given a Tensor that is broadcastable in shape as currewnt, and binary function f: X,Y -> Z
  *  returns new instance of Tensor where element-wise operations are applied in broadcasted manner
+ * 
+ *  Operation is taken as template functor so it may be inlined into the loop.
+ *  Equal shapes, and other broadcasting only along leading axes (ie bias [n] onto [b, n]),
+ *    skip the broadcast iterator and run over contiguous storage.
+ */
+  template<typename BinaryOp>
+  Tensor<T> ElementwiseApply(const Tensor<T>& other, BinaryOp operation) const;
+/** Unary Elementwise
+ *  Given unary function f: X -> X, returns new instance of Tensor with f applied to every element.
+ * 
+ *  Fused: When multiple functions are given, Map(f, g, h) applies h(g(f(x))) in a single pass.
+ */
+  template<typename UnaryOp, typename... UnaryOps>
+  Tensor<T> Map(UnaryOp operation, UnaryOps... operations) const;
+/** Unary Elementwise, Casting
+ *  Given f: T -> U, returns new Tensor<U> of same shape.
+ */
+  template<typename U, typename UnaryOp>
+  Tensor<U> MapTo(UnaryOp operation) const;
+/** In-Place Unary Elementwise
+ *  Same as Map, but overwrites current Tensor. Returns self for chaining.
  */
-  Tensor<T> ElementwiseApply(const Tensor<T>& other, const std::function<T(T, T)>& operation) const;
+  template<typename UnaryOp, typename... UnaryOps>
+  Tensor<T>& Apply(UnaryOp operation, UnaryOps... operations);
 /** Tensor Summation
  * 
  * Returned Tensor is another instance of the resulting Sum.
@@ -290,7 +451,50 @@ class Tensor { // ==============================================================
   Tensor<T> operator+(const Tensor<T>& other) const;
 // End of Operations --------------------------------------------
 
+// Reductions ---------------------------------------------------
+/** Full Reductions
+ *  Reduce every element to one value. Sums are taken in AccumulatorType<T>.
+ *  Mean, Max and Min throw on an empty Tensor.
+ * 
+ *  Split among threads as in ParallelReduceAxis, see reduction.h.
+ *  Under SetDeterministicReductions(true), results are bitwise equal for any thread count.
+ */
+  T Sum() const;
+  T Mean() const;
+  T Max() const;
+  T Min() const;
+/** Axis Reductions
+ *  Reduce along given axis, which is removed from the shape. ie) [b, n].Sum(0) -> [n]
+ *  Reducing the only axis gives shape [1].
+ *  Throws 'Axis Out of Bounds' for invalid axis.
+ */
+  Tensor<T> Sum(int axis) const;
+  Tensor<T> Mean(int axis) const;
+  Tensor<T> Max(int axis) const;
+  Tensor<T> Min(int axis) const;
+// End of Reductions --------------------------------------------
+
 // Housekeeping -------------------------------------------------
+/** Fused Unary Operation
+ *  Applies operations in order, ie) ApplyFused(x, f, g) = g(f(x))
+ */
+  template<typename UnaryOp, typename... UnaryOps>
+  static inline T ApplyFused(T x, UnaryOp& operation, UnaryOps&... operations) {
+    if constexpr (sizeof...(operations) == 0) {
+      return operation(x);
+    } else {
+      return ApplyFused(operation(x), operations...);
+    }
+  }
+/** Multiplication Dimensions.
+ *  Returns shape of this * other, following rules of operator*.
+ *  Throws if either is not a Matrix, or if inner dimensions mismatch.
+ */
+  std::vector<int> MultipliedWith(const Tensor<T>& other) const;
+/** Batched Multiplication Dimensions.
+ *  Returns shape of BatchedMatmul of this and other.
+ */
+  std::vector<int> BatchMultipliedWith(const Tensor<T>& other) const;
 /** Broadcasting Dimensions.
  *  Returns shape of broadcasted tensor. The shape then becomes compatible with both this and other.
  *  
@@ -305,6 +509,14 @@ class Tensor { // ==============================================================
  * [4, 3, 2, 3, 2]
  */
   std::vector<int> BroadcastedWith(const Tensor<T>& other) const;
+/** Broadcasting Dimensions, of given shapes */
+  static std::vector<int> BroadcastShapes(const std::vector<int>& shape_one, const std::vector<int>& shape_two);
+/** Axis Reduction
+ *  Folds along axis with combine in Acc, starting from identity,
+ *    and writes finalize(result) of every fold into a new Tensor. Shared by the axis reductions.
+ */
+  template<typename Acc, typename CombineOp, typename FinalizeOp>
+  Tensor<T> ReduceAxis(int axis, Acc identity, CombineOp combine, FinalizeOp finalize) const;
 // End of Housekeeping ------------------------------------------
 
 /**
@@ -312,11 +524,13 @@ class Tensor { // ==============================================================
  * Broadcasting : used for operations like adding bias to activations and applying layer weights to input tensors DONE
  * Concat and Splitting : Not needed now just yet, used in CNN so maybe soon
  * Elementwise Operations (+,-,/)     DONE
- * Tensor Reduction Operations (sum, mean, max, min) : Loss function and Pooling Layers
+ * Tensor Reduction Operations (sum, mean, max, min) : Loss function and Pooling Layers    DONE
  * Transpose      DONE
  */
 
 // friends =======================
+  template<typename>
+  friend class Tensor;
   friend class TensorReference<T>;
   friend class MatrixReference<T>;
   friend class ElementReference<T>;
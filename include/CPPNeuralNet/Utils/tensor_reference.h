@@ -2,6 +2,7 @@
 #define CPP_NN_TENSOR_REF
 
 #include "CPPNeuralNet/Utils/tensor.h"
+#include "CPPNeuralNet/Utils/gemm.h"
 
 #include <vector>
 #include <initializer_list>
@@ -19,9 +20,9 @@ namespace util {
  */
 template <typename T = double>
 class TensorReference { // ================================================================================
- private:
+ protected:
 // Members ------------------------------------------------------
-  Tensor<T>::TensorElement* elements_; // ownership is never given
+  typename Tensor<T>::TensorElement* elements_; // ownership is never given
   const int kChunkOrder;   // size of TensorChunk to be iterating
   const int kChunkCapacity; // Capacity of individual Chunks
 
@@ -30,6 +31,9 @@ class TensorReference { // =====================================================
 // End of Members -----------------------------------------------
 
 // Housekeeping -------------------------------------------------
+/** Chunk Capacity
+ *  Product of last chunkOrder dimensions of tensor */
+  static int ComputeChunkCapacity(const Tensor<T>& tensor, const int chunkOrder);
 /** Chunk Index to Address
  * This is index within the current chunk block,
  *  Must be summed with index_address_ for absolute address */
@@ -106,6 +110,12 @@ class MatrixReference : public TensorReference<T> { // =========================
  *  for [row][col] on the index_th Matrix of referencing Tensor */
   T& getElement(int row, int col);
   const T& getElement(int row, int col) const;
+/** Raw Chunk
+ *  Pointer to [0][0] of current matrix. Rows are contiguous, with getCols() elements each */
+  inline T* data() {return &this->elements_->getElementByAddress(this->index_address_);}
+  inline const T* data() const {return &this->elements_->getElementByAddress(this->index_address_);}
+  inline int getRows() const {return kRows;}
+  inline int getCols() const {return kCols;}
 /** Getter Parenthesis Notation */
   inline T& operator()(int row, int col) {return getElement(row, col);}
   inline const T& operator()(int row, int col) const {return getElement(row, col);}
@@ -115,8 +125,13 @@ class MatrixReference : public TensorReference<T> { // =========================
 /** Multiply Into
  * Given MatrixReferences A,B, set the current chunk as A*B, where A,B point to their respective chunks
  * Throws dimension check errors as necessary. 
+ * 
+ * Epilogue, if given, is applied as product is written back. See gemm.h
+ * Products are summed in Acc, see AccumulatorType in numeric_types.h
  */
-  void MultiplyInto(const MatrixReference<T>& A, const MatrixReference<T>& B);
+  template<typename Acc = AccumulatorType<T>>
+  void MultiplyInto(const MatrixReference<T>& A, const MatrixReference<T>& B,
+                    const GemmEpilogue<T>& epilogue = GemmEpilogue<T>());
 // End of Matrix Operations -------------------------------------
 }; // End of MatrixReference ==============================================================================
 
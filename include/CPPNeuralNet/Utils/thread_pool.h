@@ -0,0 +1,150 @@
+#ifndef CPP_NN_THREAD_POOL
+#define CPP_NN_THREAD_POOL
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cpp_nn {
+namespace util {
+
+/** Scheduling of ParallelFor tasks */
+enum class Schedule {
+  kDynamic,    // Any idle thread may steal any task
+  kNodeLocal,  // Tasks are only stolen by threads of the same NUMA node as their owner
+};
+
+/**
+ * Thread Pool.
+ * One process-wide pool of threads runs every parallel kernel of the library,
+ *  so threads are started once rather than per operation.
+ *
+ * A parallel range is cut into tasks of at least grain indices, dealt out in contiguous runs
+ *  to per-thread deques. Each thread works through its own deque front to back,
+ *  and once empty steals from the back of the others', so uneven tasks still balance.
+ * The calling thread takes part as one of the pool's threads, and returns once every task is done.
+ *
+ * Nested parallelism: a ParallelFor issued from inside a task runs inline on that thread,
+ *  ie) batched matmul splits batches and each batch's Gemm runs serially, instead of
+ *  oversubscribing the cores.
+ *
+ * Thread count, including the calling thread, is taken from environment variable CPP_NN_NUM_THREADS
+ *  when set, else std::thread::hardware_concurrency. SetNumThreads overrides either.
+ *
+ * NUMA: with SetThreadAffinity (or CPP_NN_PIN_THREADS=1) workers are pinned one per CPU,
+ *  filling NUMA nodes in order, so the contiguous runs of tasks of thread q always land on the same node.
+ *  Schedule::kNodeLocal then keeps stealing within a node, so a range is worked on by the node
+ *  whose threads first-touched its memory, see allocator.h.
+ */
+class ThreadPool {
+ public:
+/** Type-erased range operation, fn(context, begin, end) */
+  using RangeFunction = void (*)(void*, int, int);
+ private:
+  struct Job;
+  struct Task {
+    Job* job;  // On caller's stack, valid until the job's last task finishes
+    int begin;
+    int end;
+  };
+  struct TaskQueue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  const int num_threads_;
+  std::vector<std::unique_ptr<TaskQueue>> queues_;  // Queue 0 belongs to calling threads
+  std::vector<int> thread_cpus_;                    // CPU each worker is pinned to, -1 when not pinned
+  std::vector<int> thread_nodes_;                   // NUMA node of each thread, all 0 when not pinned
+  std::vector<std::thread> workers_;
+
+  std::mutex sleep_mutex_;
+  std::condition_variable wake_;
+  std::atomic<int> queued_;                         // Tasks waiting in any queue
+  bool stopping_;
+
+  void WorkerLoop(int index);
+/** Pops from own queue's front, else steals from back of another. False when every queue is empty */
+  bool RunOneTask(int index);
+  static void RunTask(const Task& task);
+ public:
+/** Starts num_threads - 1 workers, calling thread being the last.
+ *  When pinned, worker q is bound to a CPU of node q * nodes / num_threads. Calling thread is left as is. */
+  explicit ThreadPool(int num_threads, bool pinned = false);
+  ~ThreadPool();
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  inline int getNumThreads() const {return num_threads_;}
+  inline bool isPinned() const {return thread_cpus_.size() > 1 && thread_cpus_[1] >= 0;}
+  inline int getThreadNode(int thread) const {return thread_nodes_[thread];}
+
+/** Run
+ *  Calls fn(context, b, e) over disjoint [b, e) covering [begin, end), each at least grain_size long
+ *    except the last, and returns when all are done.
+ *  First exception thrown by a task is rethrown here, after the remaining tasks finish.
+ */
+  void Run(int begin, int end, int grain_size, RangeFunction fn, void* context,
+           Schedule schedule = Schedule::kDynamic);
+/** Submit
+ *  Queues task to run on some pool thread and returns at once. Task must not throw.
+ *  Unlike Run, task is not a parallel region, so kernels it calls still spread over the pool.
+ *  Tasks still queued when the pool is destroyed are run first.
+ */
+  void Submit(std::function<void()> task);
+/** Runs one queued task on the calling thread, if any. For threads waiting on submitted work */
+  bool RunPendingTask();
+
+/** Whether calling thread is currently inside a pool task */
+  static bool InParallelRegion();
+};
+
+/** Global Thread Pool, created on first use */
+ThreadPool& GlobalThreadPool();
+
+/** Number of Threads
+ *  Sets size of global pool, replacing it. 0 or below restores the default.
+ *  Not to be called while parallel work is running.
+ */
+void SetNumThreads(int num_threads);
+int getNumThreads();
+
+// NUMA ---------------------------------------------------------
+/** Thread Affinity
+ *  Pins pool threads to CPUs, node by node, replacing the global pool. Default from CPP_NN_PIN_THREADS.
+ *  Only supported on Linux, elsewhere threads are left unpinned.
+ */
+void SetThreadAffinity(bool pinned);
+bool getThreadAffinity();
+/** Number of NUMA nodes holding CPUs this process may run on, 1 when unknown */
+int getNumaNodes();
+/** Socket Partitioning
+ *  When enabled and pool threads are pinned, BatchedMatmul deals its matrix pairs to threads
+ *    in contiguous runs and keeps them on their node, instead of letting any thread steal them.
+ *  Pays off when batch tensors were first-touched by the same pool, off by default.
+ */
+void SetSocketPartitioning(bool enabled);
+bool getSocketPartitioning();
+// End of NUMA --------------------------------------------------
+
+/** Parallel For
+ *  Runs range_op(b, e) over disjoint subranges covering [begin, end), on the global pool.
+ *  Each subrange holds at least grain_size indices, so tiny ranges stay on the calling thread
+ *    without touching the pool. Default grain splits down to single indices, for coarse tasks.
+ */
+template<typename RangeOp>
+void ParallelFor(int begin, int end, RangeOp range_op, int grain_size = 1,
+                 Schedule schedule = Schedule::kDynamic);
+
+} // util
+} // cpp_nn
+
+#include "../src/CPPNeuralNet/Utils/thread_pool.tpp"
+
+#endif // CPP_NN_THREAD_POOL
@@ -5,14 +5,29 @@
 #include <vector>
 #include <initializer_list>
 #include <utility>
+#include <algorithm>
+
+#include "CPPNeuralNet/Utils/thread_pool.h"
 
 namespace cpp_nn {
 namespace util {
 
+/** Minimum number of elements each thread should receive when an operation is split */
+constexpr int kParallelGrainSize = 1 << 15;
+
+/** Parallel Chunking
+ *  Splits [0, size) into contiguous chunks and runs chunk_op(begin, end) on each, concurrently.
+ *  Ranges too small to give each chunk at least grain_size elements are split into fewer chunks,
+ *    down to only the calling thread.
+ *  Runs on the global thread pool, see ParallelFor in thread_pool.h.
+ */
+template<typename ChunkOp>
+void ParallelChunks(int size, ChunkOp chunk_op, int grain_size = kParallelGrainSize);
 
 } // util
 } // cpp_nn
 
+#include "../src/CPPNeuralNet/Utils/utils.tpp"
 
 #endif  // CPP_NN_UTIL
 
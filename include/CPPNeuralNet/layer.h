@@ -1,53 +1,148 @@
 #ifndef CPP_NN_LAYER
 #define CPP_NN_LAYER
 
+#include <vector>
+
 #include "CPPNeuralNet/Utils/utils.h"
+#include "CPPNeuralNet/Utils/tensor.h"
 
 namespace cpp_nn {
 
 /***
- * Layer is interface for any object that defines a layer in a Model. 
- * Both linear weight-linkages and activation functions will inherit from Layer. 
- * Running and updating weights of layers will be done through its methods and not externally. 
- * 
- * Ideally, layers will also maintain last run deriviates for faster training.
+ * Layer is interface for any object that defines a layer in a Model.
+ * Both linear weight-linkages and activation functions will inherit from Layer.
+ * Running and updating weights of layers will be done through its methods and not externally.
+ *
+ * Layers maintain last run buffers, so that backward reuses what forward computed.
 */
 class Layer {
  private:
+  std::vector<int> input_shape_;  // Per sample, without batch axis
+  std::vector<int> output_shape_; // Per sample, without batch axis
+  int max_batch_;
 
- public:
-
-/** WAIT TILL TENSOR IS COMPLETE ---------------------------------------------------
-  // Compute forward pass of input through the layer.
-  virtual util::Vector<double> forward(const util::Vector<double>& input); 
-  // Update the layer according to last run input. 
-  // Gradient from net layer is passed. Current gradient is returned.
-  virtual util::Vector<double> backward(const util::Vector<double>& gradient); 
----------------------------------------------------------------------------------- */
-
+  util::Tensor<double> output_;          // y of last Forward
+  util::Tensor<double> input_gradient_;  // dC/dx of last Backward
+  const util::Tensor<double>* input_;    // x of last Forward, not owned
 
+ public:
   /**
    * Each Layer is a function where input is passed and forwarded.
    * Therefore, each layer will have their own local gradient.
-   * 
+   *
    * y = L(x)
-   * 
+   *
    * In backward, we will be passed dC/dy where C is cost function.
    * Let the current layer be Linear, meaning it has weights W and biases b.
-   * We will compute gradiatents for W and b as 
+   * We will compute gradiatents for W and b as
    *   dC/dy * dy/dW and dC/dy * dy/db
-   * respectively and use such to update the paramaters. 
-   * At the end, we will however return 
-   *   dC/dy * dy/dx 
+   * respectively and use such to update the paramaters.
+   * At the end, we will however return
+   *   dC/dy * dy/dx
    * So that it may propagate backwards and continue updating on previous layers.
-   * 
-   * Activation Layers, such as sigmoid and ReLU will not need to update any terms. 
+   *
+   * Activation Layers, such as sigmoid and ReLU will not need to update any terms.
    * It will however be forced still to return correct dC/dy * dy/dx
-   * 
-   * Therefore, it may be good implementation to store dy/dx at each layer.
+   *
+   * Buffers:
+   *  Prepare allocates y, dC/dx and any workspace of the layer once, for the largest batch.
+   *  Forward and Backward write into them, resizing down to the batch at hand,
+   *    so steady-state training allocates nothing. See Tensor::Resize.
+   *  Returned references stay valid, and are overwritten by the next pass.
    */
+  Layer();
+  virtual ~Layer() = default;
+  Layer(const Layer&) = delete;
+  Layer& operator=(const Layer&) = delete;
+
+// Setup --------------------------------------------------------
+/** Prepare
+ *  Fixes per-sample input shape and largest batch, then allocates every buffer of the layer.
+ *  Must be called before Forward. Calling again with new shapes reallocates.
+ *  Throws 'Invalid Shape' for an input shape the layer cannot take.
+ * 
+ *  When storage is given, output and dC/dx buffers are instead views into it, see Tensor::View,
+ *    each of max_batch times its per-sample size. Used by Model to place every buffer in one arena.
+ */
+  void Prepare(const std::vector<int>& input_shape, int max_batch,
+               double* output_storage = nullptr, double* input_gradient_storage = nullptr);
+/** Output Shape, per sample, for given per-sample input shape. Throws as Prepare */
+  inline std::vector<int> InferOutputShape(const std::vector<int>& input_shape) const {
+    return ComputeOutputShape(input_shape);
+  }
+  inline bool isPrepared() const {return max_batch_ > 0;}
+  inline const std::vector<int>& getInputShape() const {return input_shape_;}
+  inline const std::vector<int>& getOutputShape() const {return output_shape_;}
+  inline int getMaxBatch() const {return max_batch_;}
+// End of Setup -------------------------------------------------
+
+// Passes -------------------------------------------------------
+/** Forward
+ *  Computes y = L(x) for x of shape [batch, input_shape...], batch at most max_batch.
+ *  Returns output buffer, of shape [batch, output_shape...].
+ *  x is kept by reference for Backward, so must stay alive and unchanged until then.
+ */
+  const util::Tensor<double>& Forward(const util::Tensor<double>& input);
+/** Backward
+ *  Given dC/dy of last Forward's output shape, adds dC/dθ into Gradients(),
+ *    and returns dC/dx buffer, of last Forward's input shape.
+ *  Gradients accumulate over calls until ZeroGradients.
+ */
+  const util::Tensor<double>& Backward(const util::Tensor<double>& output_gradient);
+/** Buffers of last passes */
+  inline const util::Tensor<double>& getOutput() const {return output_;}
+  inline const util::Tensor<double>& getInputGradient() const {return input_gradient_;}
+// End of Passes ------------------------------------------------
+
+// Buffer Use ---------------------------------------------------
+/** Whether Backward reads x, and y, of last Forward. Tells a memory plan how long each must live */
+  virtual bool BackwardReadsInput() const {return true;}
+  virtual bool BackwardReadsOutput() const {return true;}
+/** In Place
+ *  Whether output storage may be input's, so y is written over x,
+ *    and whether dC/dx storage may be dC/dy's. Only for layers working element by element.
+ *  Forward in place also requires Backward not to read x. Neither by default.
+ */
+  virtual bool ForwardInPlace() const {return false;}
+  virtual bool BackwardInPlace() const {return false;}
+// End of Buffer Use --------------------------------------------
+
+// Parameters ---------------------------------------------------
+/** Trainable Tensors
+ *  Parameters()[i] is updated by Gradients()[i], which is of same shape. Empty if layer has none.
+ *  Pointers stay valid for the layer's lifetime.
+ */
+  virtual std::vector<util::Tensor<double>*> Parameters() {return {};}
+  virtual std::vector<util::Tensor<double>*> Gradients() {return {};}
+/** Sets every gradient to 0 */
+  void ZeroGradients();
+// End of Parameters --------------------------------------------
+
+ protected:
+// Layer Implementation -----------------------------------------
+/** Output Shape
+ *  Per-sample output shape for given per-sample input shape.
+ *  Throws 'Invalid Shape' when layer cannot take the input.
+ */
+  virtual std::vector<int> ComputeOutputShape(const std::vector<int>& input_shape) const = 0;
+/** Workspace
+ *  Allocates any buffer of the layer's own, for inputs of up to max_batch. Called by Prepare.
+ */
+  virtual void PrepareWorkspace(int max_batch) {}
+/** Forward Into
+ *  Writes L(input) into output, both already of the batch's shape.
+ */
+  virtual void ForwardInto(const util::Tensor<double>& input, util::Tensor<double>& output) = 0;
+/** Backward Into
+ *  Adds parameter gradients, and writes dC/dx into input_gradient, already of input's shape.
+ *  input and output are those of last Forward.
+ */
+  virtual void BackwardInto(const util::Tensor<double>& input, const util::Tensor<double>& output,
+                            const util::Tensor<double>& output_gradient,
+                            util::Tensor<double>& input_gradient) = 0;
+// End of Layer Implementation ----------------------------------
 };
 
 } // cpp_nn
 
-#endif  // CPP_NN_LAYER
\ No newline at end of file
+#endif  // CPP_NN_LAYER
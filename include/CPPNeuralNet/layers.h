@@ -0,0 +1,228 @@
+#ifndef CPP_NN_LAYERS
+#define CPP_NN_LAYERS
+
+#include <cstddef>
+#include <vector>
+
+#include "CPPNeuralNet/layer.h"
+#include "CPPNeuralNet/Utils/gemm.h"
+#include "CPPNeuralNet/Utils/block_sparse.h"
+
+namespace cpp_nn {
+
+/***
+ * Activation Layer.
+ * Applies one of util::Activation elementwise, y = f(x). Output shape is input shape.
+ * Has no parameters. Backward gives dC/dx = dC/dy * f'(x).
+*/
+class ActivationLayer : public Layer {
+ private:
+  util::Activation activation_;
+ public:
+  explicit ActivationLayer(util::Activation activation);
+  inline util::Activation getActivation() const {return activation_;}
+
+/** Only GELU's derivative needs x. ReLU's is read off y as well, so the rest run in place */
+  bool BackwardReadsInput() const override {return activation_ == util::Activation::kGELU;}
+  bool BackwardReadsOutput() const override {
+    return activation_ == util::Activation::kReLU || activation_ == util::Activation::kSigmoid;
+  }
+  bool ForwardInPlace() const override {return !BackwardReadsInput();}
+  bool BackwardInPlace() const override {return true;}
+ protected:
+  std::vector<int> ComputeOutputShape(const std::vector<int>& input_shape) const override;
+  void ForwardInto(const util::Tensor<double>& input, util::Tensor<double>& output) override;
+  void BackwardInto(const util::Tensor<double>& input, const util::Tensor<double>& output,
+                    const util::Tensor<double>& output_gradient,
+                    util::Tensor<double>& input_gradient) override;
+};
+
+/***
+ * Linear Layer, fully connected.
+ * y = f(x * W + b), for x [batch, in], W [in, out], b [out], and f one of util::Activation.
+ *
+ * Forward is a single Gemm call, with bias and activation fused into its epilogue.
+ *  GELU is the exception: its derivative needs x * W + b, which is then kept in workspace
+ *  and activated in a second pass.
+ * Backward, with dZ = dC/dy * f'
+ *  dC/dW += x^T * dZ,  dC/dx = dZ * W^T,  as Gemm on strided views, so no transpose is materialized
+ *  dC/db += column sums of dZ, by ParallelReduceAxis
+ *
+ * Pruned weights: Prepare checks W once for zero blocks and 2:4 pattern, see StructuredSparseMatrix.
+ *  When enough is zero, forward and dC/dx run structured sparse kernels on W packed in the layer.
+ *  The pattern is then fixed: forward refills the packed W from W's current values, and dC/dW is zeroed
+ *  outside the pattern so training keeps W pruned. To prune further, Prepare (or Build the Model) again.
+ *
+ * Weights are drawn uniformly from +-sqrt(6 / in) for ReLU and GELU (He), else +-sqrt(6 / (in + out)) (Glorot).
+ * Bias starts at 0.
+*/
+class Linear : public Layer {
+ private:
+  int in_features_;
+  int out_features_;
+  util::Activation activation_;
+
+  util::Tensor<double> weight_;
+  util::Tensor<double> bias_;
+  util::Tensor<double> weight_gradient_;
+  util::Tensor<double> bias_gradient_;
+
+  // Workspace
+  util::StructuredSparseMatrix<double> sparse_weight_;  // W packed by Prepare, when pruned
+  std::vector<double> delta_;          // dZ, [max_batch x out]
+  std::vector<double> pre_activation_; // x * W + b, [max_batch x out], GELU only
+  std::vector<double> column_sums_;    // [out]
+ public:
+/** Constructor
+ *  Weights are initialized from seed, so equal seeds give equal layers.
+ *  Throws 'Non-Positive Features' for non-positive feature counts.
+ */
+  Linear(int in_features, int out_features, util::Activation activation = util::Activation::kNone,
+         unsigned int seed = 0);
+
+  inline int getInFeatures() const {return in_features_;}
+  inline int getOutFeatures() const {return out_features_;}
+  inline util::Activation getActivation() const {return activation_;}
+  inline util::Tensor<double>& getWeight() {return weight_;}
+  inline util::Tensor<double>& getBias() {return bias_;}
+  inline const util::Tensor<double>& getWeightGradient() const {return weight_gradient_;}
+  inline const util::Tensor<double>& getBiasGradient() const {return bias_gradient_;}
+/** Format W was packed in by Prepare, kDense when not pruned */
+  inline util::StructuredFormat getWeightFormat() const {return sparse_weight_.getFormat();}
+
+/** Fuse Activation
+ *  Takes on an activation applied right after the layer, so forward computes both in one Gemm.
+ *  Returns false, changing nothing, if layer already has an activation.
+ *  Layer must be prepared again afterwards. Weights keep their initialization.
+ */
+  bool FuseActivation(util::Activation activation);
+
+  std::vector<util::Tensor<double>*> Parameters() override {return {&weight_, &bias_};}
+  std::vector<util::Tensor<double>*> Gradients() override {return {&weight_gradient_, &bias_gradient_};}
+/** y is read for the derivative of ReLU and Sigmoid. GELU keeps x * W + b in workspace instead */
+  bool BackwardReadsOutput() const override {
+    return activation_ == util::Activation::kReLU || activation_ == util::Activation::kSigmoid;
+  }
+ protected:
+  std::vector<int> ComputeOutputShape(const std::vector<int>& input_shape) const override;
+  void PrepareWorkspace(int max_batch) override;
+  void ForwardInto(const util::Tensor<double>& input, util::Tensor<double>& output) override;
+  void BackwardInto(const util::Tensor<double>& input, const util::Tensor<double>& output,
+                    const util::Tensor<double>& output_gradient,
+                    util::Tensor<double>& input_gradient) override;
+};
+
+/** Memory order of an image batch. N batch, C channels, H and W spatial axes */
+enum class ImageLayout {
+  kNCHW,
+  kNHWC
+};
+
+/** Conv2D Geometry, per spatial axis. Padding is zeros, on both sides */
+struct Conv2DOptions {
+  int stride_h = 1;
+  int stride_w = 1;
+  int pad_h = 0;
+  int pad_w = 0;
+  int dilation_h = 1;
+  int dilation_w = 1;
+  ImageLayout layout = ImageLayout::kNCHW;
+};
+
+/** Bytes of one unfolded im2col tile of Conv2D. With its gradient, both take half of a 2 MiB L2 */
+constexpr size_t kConvTileBytes = 1 << 19;
+
+/***
+ * 2D Convolution Layer.
+ * Per sample x [C, H, W] (or [H, W, C] for NHWC) to y [O, OH, OW] (or [OH, OW, O]), where
+ *  y[o, oy, ox] = b[o] + sum over c, ky, kx of W[ky, kx, c, o] * x[c, oy * sh - ph + ky * dh, ox * sw - pw + kx * dw]
+ *  OH = (H + 2 * ph - dh * (kh - 1) - 1) / sh + 1, and likewise OW.
+ * Weight is [kh, kw, C, O] whatever the layout, so it reads as a [K x O] matrix, K = kh * kw * C.
+ *
+ * Lowered to Gemm by im2col: each output pixel's receptive field is unfolded into a row of K.
+ *  Pixels are unfolded a tile at a time, sized so the tile's [pixels x K] fits in kConvTileBytes,
+ *  then multiplied while still in L2, so the whole unfolded matrix is never materialized.
+ *  A tile holds at least kGemmMC pixels, so each Gemm still fills its row blocks.
+ *  NHWC: y[pixels, O] = col[pixels, K] * W, as output is pixel-major.  Tiles run across samples.
+ *    W is packed once per pass, see GemmPackedB, rather than once per tile.
+ *  NCHW: y_n[O, pixels] = W^T * col[K, pixels], W^T read as column-major view.  Tiles run within a sample.
+ *  A 1x1 kernel of stride 1 and no padding needs no unfolding, x itself is read as col.
+ * Forward splits tiles among slots, one per pool thread, each unfolding into its own prepared buffer.
+ *
+ * Backward, tile by tile, each Gemm parallel within
+ *  dC/dW += col^T * dy,  dcol = dy * W^T,  then dcol folded back (col2im) and added into dC/dx,
+ *    split among threads by input channel, so no two threads add into one element.
+ *  dC/db += sums of dy over batch and pixels, by ParallelReduceAxis
+ *
+ * Weights are drawn uniformly from +-sqrt(6 / (K + kh * kw * O)) (Glorot). Bias starts at 0.
+*/
+class Conv2D : public Layer {
+ private:
+  int in_channels_;
+  int out_channels_;
+  int kernel_h_;
+  int kernel_w_;
+  Conv2DOptions options_;
+
+  util::Tensor<double> weight_;
+  util::Tensor<double> bias_;
+  util::Tensor<double> weight_gradient_;
+  util::Tensor<double> bias_gradient_;
+
+  // Geometry of prepared input
+  int height_, width_;
+  int out_height_, out_width_;
+  int tile_pixels_;
+  int num_slots_;
+
+  // Workspace
+  util::GemmPackedB<double> packed_weight_;  // W for NHWC forward, W^T for NHWC backward
+  std::vector<double> columns_;          // Unfolded tile of each slot, [num_slots x tile_pixels x K]
+  std::vector<double> column_gradient_;  // dC/dcol of tile, [tile_pixels x K]
+  std::vector<double> channel_sums_;     // [max_batch x O]
+
+/** Kernel is 1x1, of stride 1 and no padding, so x is its own unfolding */
+  bool isPointwise() const;
+/** Unfold
+ *  im2col of pixels [first, first + count) into columns, in the layout's order.
+ *  NHWC pixels are counted across the batch, NCHW pixels within sample n.
+ *  Returns pointer to the unfolding, and sets its leading dimension.
+ *    For a pointwise kernel that is x itself, and columns is untouched.
+ */
+  const double* Unfold(const double* x, int n, int first, int count, double* columns, int& ld) const;
+/** Fold, col2im. Adds column_gradient of pixels [first, first + count) into dx */
+  void Fold(const double* column_gradient, int n, int first, int count, double* dx) const;
+ public:
+/** Constructor
+ *  Weights are initialized from seed, so equal seeds give equal layers.
+ *  Throws 'Non-Positive Size' for non-positive channels or kernel,
+ *    and 'Invalid Options' for non-positive stride or dilation, or negative padding.
+ */
+  Conv2D(int in_channels, int out_channels, int kernel_h, int kernel_w,
+         const Conv2DOptions& options = Conv2DOptions(), unsigned int seed = 0);
+
+  inline int getInChannels() const {return in_channels_;}
+  inline int getOutChannels() const {return out_channels_;}
+  inline const Conv2DOptions& getOptions() const {return options_;}
+  inline util::Tensor<double>& getWeight() {return weight_;}
+  inline util::Tensor<double>& getBias() {return bias_;}
+  inline const util::Tensor<double>& getWeightGradient() const {return weight_gradient_;}
+  inline const util::Tensor<double>& getBiasGradient() const {return bias_gradient_;}
+/** Output pixels unfolded at once, set by Prepare */
+  inline int getTilePixels() const {return tile_pixels_;}
+
+  std::vector<util::Tensor<double>*> Parameters() override {return {&weight_, &bias_};}
+  std::vector<util::Tensor<double>*> Gradients() override {return {&weight_gradient_, &bias_gradient_};}
+  bool BackwardReadsOutput() const override {return false;}
+ protected:
+  std::vector<int> ComputeOutputShape(const std::vector<int>& input_shape) const override;
+  void PrepareWorkspace(int max_batch) override;
+  void ForwardInto(const util::Tensor<double>& input, util::Tensor<double>& output) override;
+  void BackwardInto(const util::Tensor<double>& input, const util::Tensor<double>& output,
+                    const util::Tensor<double>& output_gradient,
+                    util::Tensor<double>& input_gradient) override;
+};
+
+} // cpp_nn
+
+#endif  // CPP_NN_LAYERS
@@ -0,0 +1,50 @@
+#ifndef CPP_NN_LOSSES
+#define CPP_NN_LOSSES
+
+#include <vector>
+
+#include "CPPNeuralNet/Utils/tensor.h"
+
+namespace cpp_nn {
+
+/***
+ * Softmax Cross Entropy, fused.
+ * For logits z [batch, classes] and integer labels y [batch], the mean over rows of
+ *  C = -log softmax(z)[y] = logsumexp(z) - z[y]
+ * and its gradient dC/dz = (softmax(z) - onehot(y)) / batch.
+ *
+ * Per row: a pass for the max, one writing exp(z - max) straight into the gradient while summing it,
+ *  and one normalizing it in place and taking 1 off at the label. So exp is taken once per element,
+ *  and no probabilities or one-hot targets are stored apart from the gradient.
+ * Logsumexp is taken around the row's max, so large logits do not overflow.
+ * Loss alone takes a single pass per row, rescaling its sum whenever the max grows.
+ * Rows are split among threads. Per row losses are summed in row order, so the loss is deterministic.
+ *
+ * Gradient may be the logits Tensor itself, then it is overwritten in place.
+*/
+class SoftmaxCrossEntropy {
+ private:
+  util::Tensor<double> gradient_;
+  std::vector<double> row_losses_;
+ public:
+  SoftmaxCrossEntropy();
+
+/** Loss and Gradient
+ *  Returns mean loss over rows of logits, and writes dC/dlogits into gradient, of logits' shape.
+ *  Throws 'Invalid Shape' unless logits is [batch, classes], 'Label Count Mismatch' unless one label per row,
+ *    'Label Out Of Range' for a label outside [0, classes), and 'Gradient Shape Mismatch'.
+ *  Labels are checked before anything is written.
+ */
+  double Compute(const util::Tensor<double>& logits, const std::vector<int>& labels,
+                 util::Tensor<double>& gradient);
+/** As above, into the loss's own gradient buffer, kept across calls and only grown. See getGradient */
+  double Compute(const util::Tensor<double>& logits, const std::vector<int>& labels);
+/** Gradient of the last Compute into own buffer. ie) model.Backward(loss.getGradient()) */
+  inline const util::Tensor<double>& getGradient() const {return gradient_;}
+/** Loss only, without writing a gradient */
+  double Loss(const util::Tensor<double>& logits, const std::vector<int>& labels);
+};
+
+} // cpp_nn
+
+#endif  // CPP_NN_LOSSES
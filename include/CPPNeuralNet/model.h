@@ -1,39 +1,154 @@
 #ifndef CPP_NN_MODEL
 #define CPP_NN_MODEL
 
-// TODO preferably find better lower level alternative. Consider array of pointers. 
-#include "vector" 
+#include <iosfwd>
+#include <memory>
+#include <utility>
+#include <vector>
 
 #include "CPPNeuralNet/layer.h"
 #include "CPPNeuralNet/Utils/utils.h"
+#include "CPPNeuralNet/Utils/tensor.h"
+#include "CPPNeuralNet/Utils/memory_planner.h"
 
 namespace cpp_nn {
 
 /***
- * Model is top-level wrapper for all neural net models. 
- * Layers can be added to Models to define behaviour such as input and output dimensions along with activation functions to be used. 
+ * Model is top-level wrapper for all neural net models.
+ * Layers can be added to Models to define behaviour such as input and output dimensions along with activation functions to be used.
  * Training and testing will also be called through Model's methods.
- * 
- * Specific types of neural net models, such as Perceptrons, will inherit from Model. 
+ *
+ * Specific types of neural net models, such as Perceptrons, will inherit from Model.
+ *
+ * Build:
+ *  Fusion: Linear followed by an ActivationLayer becomes one Linear with that activation,
+ *    so the pair runs as one Gemm with fused epilogue. Linear already carries its bias.
+ *  Arena: every layer output and dC/dx buffer is a view into one allocation, see memory_planner.h.
+ *    Forward and backward run in a fixed order of steps, so the step each buffer is written at,
+ *    and the last step reading it, are known from the layers alone, see Layer::BackwardReadsInput.
+ *    Buffers never live at the same step share storage, ie) an output backward does not read
+ *    is dead once the next layer has run.
+ *    Layers working element by element take their input's storage, see Layer::ForwardInPlace.
+ *
+ * Checkpointing:
+ *  AddCheckpoint splits layers into segments. Forward then keeps only each segment's input,
+ *    letting every other output die once the next layer has read it.
+ *  Backward, segment by segment from the last, runs forward over the segment again from its input,
+ *    then backward through it. The last segment is not run again, as its outputs are still live.
+ *  With about sqrt(L) segments of L layers, live outputs go from L to about 2 sqrt(L),
+ *    for one more forward over all but the last segment.
+ *
+ * Flat Parameters:
+ *  Build also moves every layer's parameters into one aligned buffer, and every gradient into another,
+ *    leaving each layer's Tensors as views into them, in layer order.
+ *  Every parameter starts on a cache line. Padding between them is kept 0, in both buffers.
+ *  So zeroing gradients, an optimizer step over getFlatParameters, reducing gradients across replicas,
+ *    or Save and Load, each take one linear sweep over one buffer.
 */
 class Model {
-/** WAIT TILL TENSOR IS FINISHED  ---------------------------------------------------------------------------------------
  private:
-  std::vector<Layer> layers;
- public: 
+  std::vector<std::unique_ptr<Layer>> layers_;
+  std::vector<int> input_shape_; // Per sample, without batch axis
+  int max_batch_;
+  int num_fused_;
+  std::vector<int> checkpoints_;           // Layers starting a segment, besides the first
+  const util::Tensor<double>* input_;      // x of last Forward, not owned
 
+  util::MemoryPlan memory_plan_;
+  size_t unplanned_size_;
+
+  std::vector<double, util::TensorAllocator<double>> parameter_buffer_;
+  std::vector<double, util::TensorAllocator<double>> gradient_buffer_;
+  util::Tensor<double> flat_parameters_;  // View of all of parameter_buffer_
+  util::Tensor<double> flat_gradients_;
+
+/** Moves layers' parameters and gradients into flat buffers, keeping values. Called by Build */
+  void FlattenParameters();
+  std::vector<double, util::TensorAllocator<double>> arena_;
+ public:
   Model();
-  
-  Model& const addLayer(Layer layer);
-
-  // Compute forward pass of input through all the layer.
-  util::Vector<> forward(util::Vector<> input); 
-  // Update all the layer according to last run input. 
-  // Graident of Loss is passed as arguement.
-  void backward(util::Vector<double>& const gradient); // TODO see if return should be current gradient.
-------------------------------------------------------------------------------------------------------------- */
+  Model(const Model&) = delete;
+  Model& operator=(const Model&) = delete;
+
+// Layers -------------------------------------------------------
+/** Add Layer
+ *  Appends layer, constructed from args, and returns it. Model must be built again before running.
+ *  ie) model.AddLayer<Linear>(784, 128);
+ */
+  template<typename LayerType, typename... Args>
+  LayerType& AddLayer(Args&&... args) {
+    std::unique_ptr<LayerType> layer = std::make_unique<LayerType>(std::forward<Args>(args)...);
+    LayerType& res = *layer;
+    AddLayer(std::move(layer));
+    return res;
+  }
+  void AddLayer(std::unique_ptr<Layer> layer);
+  inline int getNumLayers() const {return layers_.size();}
+  inline Layer& getLayer(int index) {return *layers_[index];}
+/** Add Checkpoint
+ *  Starts a new checkpointed segment at the next layer added. Model must be built again before running.
+ *  Fusion keeps segments, a fused activation going to its Linear's segment.
+ */
+  void AddCheckpoint();
+/** Number of segments, in last Build */
+  inline int getNumSegments() const {return checkpoints_.size() + 1;}
+// End of Layers ------------------------------------------------
+
+// Build --------------------------------------------------------
+/** Build
+ *  Fuses adjacent layers when fuse is set, then prepares every layer for
+ *    per-sample input_shape and batches of up to max_batch, with buffers in one arena.
+ *  Throws 'No Layers' for an empty model, and as Layer::Prepare for shapes layers cannot take.
+ */
+  void Build(const std::vector<int>& input_shape, int max_batch, bool fuse = true);
+  inline bool isBuilt() const {return max_batch_ > 0;}
+/** Number of layers removed by fusion in last Build */
+  inline int getNumFused() const {return num_fused_;}
+/** Size of buffer arena, in bytes */
+  inline size_t getArenaBytes() const {return arena_.size() * sizeof(double);}
+/** Most bytes of buffers live at once, which no arena can go below */
+  inline size_t getPeakBytes() const {return memory_plan_.peak_size * sizeof(double);}
+/** Bytes of an output and a dC/dx buffer per layer, as an arena without any sharing would take */
+  inline size_t getUnplannedBytes() const {return unplanned_size_ * sizeof(double);}
+// End of Build -------------------------------------------------
+
+// Passes -------------------------------------------------------
+/** Forward
+ *  Runs input [batch, input_shape...] through every layer, and returns the last output.
+ *  Input must stay alive and unchanged until Backward. Output is valid until Backward, which reuses its storage.
+ */
+  const util::Tensor<double>& Forward(const util::Tensor<double>& input);
+/** Backward
+ *  Given dC/dy of last Forward's output, adds every layer's parameter gradients,
+ *    and returns dC/dx of the model's input.
+ *  Checkpointed segments but the last run forward again first.
+ */
+  const util::Tensor<double>& Backward(const util::Tensor<double>& output_gradient);
+// End of Passes ------------------------------------------------
+
+// Parameters ---------------------------------------------------
+/** Trainable Tensors of every layer, in layer order. Parameters()[i] is updated by Gradients()[i] */
+  std::vector<util::Tensor<double>*> Parameters();
+  std::vector<util::Tensor<double>*> Gradients();
+/** Sets every gradient to 0, in one sweep once built */
+  void ZeroGradients();
+/** Flat Buffers
+ *  Every parameter, and every gradient, of the built model as one Tensor of shape [n], padding included.
+ *  ie) optimizer.AddParameters({&model.getFlatParameters()}, {&model.getFlatGradients()});
+ *  Empty until Build.
+ */
+  inline util::Tensor<double>& getFlatParameters() {return flat_parameters_;}
+  inline util::Tensor<double>& getFlatGradients() {return flat_gradients_;}
+/** Save and Load
+ *  Writes the flat parameter buffer, after its length, in one binary write, and reads it back.
+ *  Model must be built, and for Load, be of the same layers as the saved one.
+ *  Throws 'Model Not Built', 'Parameter Count Mismatch' for another layout, and 'Stream Error'.
+ */
+  void Save(std::ostream& out) const;
+  void Load(std::istream& in);
+// End of Parameters --------------------------------------------
 };
 
-}
+} // cpp_nn
 
 #endif  // CPP_NN_MODEL
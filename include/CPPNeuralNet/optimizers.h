@@ -0,0 +1,164 @@
+#ifndef CPP_NN_OPTIMIZERS
+#define CPP_NN_OPTIMIZERS
+
+#include <vector>
+
+#include "CPPNeuralNet/Utils/allocator.h"
+#include "CPPNeuralNet/Utils/tensor.h"
+
+namespace cpp_nn {
+
+/***
+ * Optimizer is interface for any rule updating parameters from their gradients, ie) SGD, Adam.
+ *
+ * Parameters are added in groups, each with its own learning rate and weight decay.
+ * Step updates every group in place, one pass per group:
+ *  A group's tensors are treated as one flat range of elements, split among threads,
+ *  and each thread runs one fused loop reading gradient and state, and writing state and parameter,
+ *  so no temporary is made, and every element is read and written once.
+ *
+ * State, ie) moments of Adam, lives in one flat aligned buffer, group after group,
+ *  with each kind of state for a group contiguous, so a pass walks it front to back.
+ *
+ * Gradient Clipping:
+ *  With a max gradient norm set, Step first takes L2 norm of all gradients, over every group,
+ *  and when above the max, scales every gradient by max / norm as it is read. Gradients themselves are unchanged.
+*/
+class Optimizer {
+ protected:
+  struct Group {
+    std::vector<util::Tensor<double>*> parameters;
+    std::vector<util::Tensor<double>*> gradients;
+    std::vector<int> bounds;   // bounds[i] is first element of parameters[i], in the group's flat range
+    double learning_rate;
+    double weight_decay;
+    size_t state_offset;       // Of group's first state, in state_
+    inline int size() const {return bounds.back();}
+  };
+  std::vector<Group> groups_;
+  std::vector<double, util::TensorAllocator<double>> state_;
+  double learning_rate_;
+  double weight_decay_;
+  double max_gradient_norm_;
+  int num_steps_;
+
+/** Span Pass
+ *  Runs span(parameter, gradient, state_index, count) over every element of group,
+ *    in contiguous spans of one tensor each, split among threads.
+ *  state_index is position of the span's first element in the group's flat range.
+ */
+  template<typename SpanOp>
+  void ForEachSpan(const Group& group, SpanOp span) const;
+
+// Optimizer Implementation -------------------------------------
+/** Flat states kept per element, ie) 2 for Adam */
+  virtual int getNumStates() const = 0;
+/** Update Group
+ *  Updates every parameter of group in place, reading gradients times gradient_scale.
+ *  States of group start at state_.data() + group.state_offset, each group.size() long.
+ *  getStepCount() is already that of the step being taken.
+ */
+  virtual void UpdateGroup(const Group& group, double gradient_scale) = 0;
+// End of Optimizer Implementation ------------------------------
+ public:
+/** Constructor
+ *  Learning rate and weight decay given are those of groups added without their own.
+ *  Throws 'Negative Hyperparameter' for a negative one.
+ */
+  Optimizer(double learning_rate, double weight_decay);
+  virtual ~Optimizer() = default;
+  Optimizer(const Optimizer&) = delete;
+  Optimizer& operator=(const Optimizer&) = delete;
+
+// Parameters ---------------------------------------------------
+/** Add Parameter Group
+ *  parameters[i] is updated by gradients[i], of same capacity. Tensors must outlive the optimizer.
+ *  State of the group starts at 0.
+ *  Throws 'Parameter Gradient Mismatch' for unequal counts or capacities.
+ *  ie) optimizer.AddParameters(model.Parameters(), model.Gradients());
+ */
+  void AddParameters(const std::vector<util::Tensor<double>*>& parameters,
+                     const std::vector<util::Tensor<double>*>& gradients);
+  void AddParameterGroup(const std::vector<util::Tensor<double>*>& parameters,
+                         const std::vector<util::Tensor<double>*>& gradients,
+                         double learning_rate, double weight_decay);
+  inline int getNumGroups() const {return groups_.size();}
+/** Sets learning rate of every group, ie) for a schedule */
+  void setLearningRate(double learning_rate);
+/** Max Gradient Norm. 0 turns clipping off, as by default */
+  void setMaxGradientNorm(double max_norm);
+  inline double getMaxGradientNorm() const {return max_gradient_norm_;}
+// End of Parameters --------------------------------------------
+
+// Step ---------------------------------------------------------
+/** Step
+ *  Updates every parameter from its gradient, clipped if a max norm is set.
+ *  Returns L2 norm of all gradients, before clipping. Only taken with clipping on, else 0.
+ */
+  double Step();
+/** L2 norm of all gradients, over every group. Partial sums in fixed order, so deterministic */
+  double GradientNorm() const;
+/** Sets every gradient to 0 */
+  void ZeroGradients();
+  inline int getStepCount() const {return num_steps_;}
+/** Size of state buffer, in bytes */
+  inline size_t getStateBytes() const {return state_.size() * sizeof(double);}
+// End of Step --------------------------------------------------
+};
+
+/***
+ * Stochastic Gradient Descent, with momentum.
+ *  g = dC/dw + weight_decay * w
+ *  v = momentum * v + g
+ *  w -= learning_rate * v,  or with Nesterov  w -= learning_rate * (g + momentum * v)
+ * Momentum 0 keeps no state, and is plain SGD.
+*/
+class SGD : public Optimizer {
+ private:
+  double momentum_;
+  bool nesterov_;
+ protected:
+  inline int getNumStates() const override {return momentum_ > 0 ? 1 : 0;}
+  void UpdateGroup(const Group& group, double gradient_scale) override;
+ public:
+  SGD(double learning_rate, double momentum = 0, double weight_decay = 0, bool nesterov = false);
+  inline double getMomentum() const {return momentum_;}
+};
+
+/***
+ * Adam, adaptive moment estimation.
+ *  g = dC/dw + weight_decay * w
+ *  m = beta1 * m + (1 - beta1) * g,  v = beta2 * v + (1 - beta2) * g^2
+ *  w -= learning_rate * m / (1 - beta1^t) / (sqrt(v / (1 - beta2^t)) + epsilon), at step t
+ * Weight decay as above is L2 regularization, scaled down with g by v. See AdamW.
+*/
+class Adam : public Optimizer {
+ private:
+  double beta1_;
+  double beta2_;
+  double epsilon_;
+  bool decoupled_;  // Weight decay applied to w directly, as AdamW
+ protected:
+  inline int getNumStates() const override {return 2;}
+  void UpdateGroup(const Group& group, double gradient_scale) override;
+  Adam(double learning_rate, double beta1, double beta2, double epsilon, double weight_decay, bool decoupled);
+ public:
+/** Throws 'Invalid Beta' unless betas are in [0, 1) */
+  Adam(double learning_rate = 1e-3, double beta1 = 0.9, double beta2 = 0.999, double epsilon = 1e-8,
+       double weight_decay = 0);
+};
+
+/***
+ * AdamW, Adam with decoupled weight decay.
+ *  w -= learning_rate * weight_decay * w, then Adam's update without weight decay in g,
+ *  so decay is not scaled down by v.
+*/
+class AdamW : public Adam {
+ public:
+  AdamW(double learning_rate = 1e-3, double beta1 = 0.9, double beta2 = 0.999, double epsilon = 1e-8,
+        double weight_decay = 1e-2);
+};
+
+} // cpp_nn
+
+#endif  // CPP_NN_OPTIMIZERS
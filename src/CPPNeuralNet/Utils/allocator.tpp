@@ -0,0 +1,47 @@
+#include "CPPNeuralNet/Utils/allocator.h"
+#include "CPPNeuralNet/Utils/utils.h"
+
+#include <algorithm>
+
+namespace cpp_nn {
+namespace util {
+
+// Scratch Buffer ======================================================
+template<typename T>
+typename ScratchBuffer<T>::Stack& ScratchBuffer<T>::LocalStack() {
+  thread_local Stack stack;
+  return stack;
+}
+template<typename T>
+ScratchBuffer<T>::ScratchBuffer(size_t size) {
+  Stack& stack = LocalStack();
+  if (stack.depth == stack.buffers.size()) stack.buffers.emplace_back();
+  // Growing the stack moves buffers, not their storage, so data of outer leases stays valid
+  std::vector<T, TensorAllocator<T>>& buffer = stack.buffers[stack.depth++];
+  if (buffer.size() < size) buffer.resize(size);
+  data_ = buffer.data();
+}
+template<typename T>
+ScratchBuffer<T>::~ScratchBuffer() {
+  --LocalStack().depth;
+}
+// End of Scratch Buffer ===============================================
+
+/** First-Touch Fill */
+template<typename T>
+void FirstTouchFill(T* data, int size, const T& value) {
+  // Node-local, so stealing never moves a range to a thread of another node
+  ParallelFor(0, size, [&](int begin, int end) {
+    std::fill(data + begin, data + end, value);
+  }, kParallelGrainSize, Schedule::kNodeLocal);
+}
+/** First-Touch Copy */
+template<typename T>
+void FirstTouchCopy(T* data, const T* source, int size) {
+  ParallelFor(0, size, [&](int begin, int end) {
+    std::copy(source + begin, source + end, data + begin);
+  }, kParallelGrainSize, Schedule::kNodeLocal);
+}
+
+} // util
+} // cpp_nn
@@ -0,0 +1,85 @@
+#include "CPPNeuralNet/Utils/async.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace cpp_nn {
+namespace util {
+
+// AsyncState ======================================================================
+bool AsyncState::isReady() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return ready_;
+}
+std::exception_ptr AsyncState::getError() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return error_;
+}
+void AsyncState::Wait() const {
+  while (true) {
+    if (isReady()) return;
+    // Op may be queued behind this very thread, ie) single-threaded pool
+    if (GlobalThreadPool().RunPendingTask()) continue;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (ready_cv_.wait_for(lock, std::chrono::microseconds(200), [this]() {return ready_;})) return;
+  }
+}
+void AsyncState::Then(std::function<void()> continuation) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!ready_) {
+      continuations_.push_back(std::move(continuation));
+      return;
+    }
+  }
+  continuation();
+}
+void AsyncState::Complete(std::exception_ptr error /*= nullptr*/) {
+  std::vector<std::function<void()>> continuations;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ready_ = true;
+    error_ = error;
+    continuations.swap(continuations_);
+  }
+  ready_cv_.notify_all();
+  // Continuations hold their inputs' states, releasing them here breaks the cycle
+  for (std::function<void()>& continuation : continuations) {
+    continuation();
+  }
+}
+// End of AsyncState ===============================================================
+
+// ExecutionStream =================================================================
+ExecutionStream::~ExecutionStream() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const std::shared_ptr<AsyncState>& state : in_flight_) {
+    state->Wait();
+  }
+}
+void ExecutionStream::Track(std::shared_ptr<AsyncState> state) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Keeps list from growing with long-finished ops
+  in_flight_.erase(std::remove_if(in_flight_.begin(), in_flight_.end(),
+                                  [](const std::shared_ptr<AsyncState>& s) {return s->isReady() && !s->getError();}),
+                   in_flight_.end());
+  in_flight_.push_back(std::move(state));
+}
+void ExecutionStream::Synchronize() {
+  std::vector<std::shared_ptr<AsyncState>> in_flight;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    in_flight.swap(in_flight_);
+  }
+  std::exception_ptr error;
+  for (const std::shared_ptr<AsyncState>& state : in_flight) {
+    state->Wait();
+    if (!error) error = state->getError();
+  }
+  if (error) std::rethrow_exception(error);
+}
+// End of ExecutionStream ==========================================================
+
+} // util
+} // cpp_nn
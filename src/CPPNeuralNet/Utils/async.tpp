@@ -0,0 +1,92 @@
+#include "CPPNeuralNet/Utils/async.h"
+
+#include <atomic>
+#include <initializer_list>
+#include <stdexcept>
+
+namespace cpp_nn {
+namespace util {
+
+// TensorFuture ====================================================================
+template<typename T>
+void TensorFuture<T>::Wait() const {
+  if (state_ == nullptr) throw std::invalid_argument("TensorFuture Wait- Invalid Future");
+  state_->Wait();
+  if (state_->getError()) std::rethrow_exception(state_->getError());
+}
+template<typename T>
+const Tensor<T>& TensorFuture<T>::Get() const {
+  Wait();
+  return *state_->value;
+}
+// End of TensorFuture =============================================================
+
+// ExecutionStream =================================================================
+template<typename T>
+TensorFuture<T> ExecutionStream::Ready(Tensor<T> value) {
+  TensorFuture<T> res;
+  res.state_ = std::make_shared<typename TensorFuture<T>::State>();
+  res.state_->value.emplace(std::move(value));
+  res.state_->Complete();
+  return res;
+}
+/** Enqueue */
+template<typename Op, typename... Ts>
+TensorFuture<OpResultElement<Op, Ts...>> ExecutionStream::Enqueue(Op op, const TensorFuture<Ts>&... inputs) {
+  using T = OpResultElement<Op, Ts...>;
+  for (bool valid : std::initializer_list<bool>{true, inputs.isValid()...}) {
+    if (!valid) throw std::invalid_argument("ExecutionStream Enqueue- Invalid Input Future");
+  }
+
+  TensorFuture<T> res;
+  res.state_ = std::make_shared<typename TensorFuture<T>::State>();
+  auto state = res.state_;
+
+  auto run = [state, op, inputs...]() {
+    std::exception_ptr error;
+    for (std::exception_ptr input_error : std::initializer_list<std::exception_ptr>{nullptr, inputs.state_->getError()...}) {
+      if (!error) error = input_error;
+    }
+    if (!error) {
+      try {
+        state->value.emplace(op(*inputs.state_->value...));
+      } catch (...) {
+        error = std::current_exception();
+      }
+    }
+    state->Complete(error);
+  };
+  // One count per input, plus one held until every input has been registered
+  auto waiting = std::make_shared<std::atomic<int>>(sizeof...(Ts) + 1);
+  auto arrive = [waiting, run]() {
+    if (waiting->fetch_sub(1) == 1) GlobalThreadPool().Submit(run);
+  };
+  (inputs.state_->Then(arrive), ...);
+  Track(state);
+  arrive();
+
+  return res;
+}
+
+// Operations ----------------------------------------------------------
+template<typename T>
+TensorFuture<T> ExecutionStream::Multiply(const TensorFuture<T>& a, const TensorFuture<T>& b) {
+  return Enqueue([](const Tensor<T>& x, const Tensor<T>& y) {return x * y;}, a, b);
+}
+template<typename T>
+TensorFuture<T> ExecutionStream::BatchedMatmul(const TensorFuture<T>& a, const TensorFuture<T>& b) {
+  return Enqueue([](const Tensor<T>& x, const Tensor<T>& y) {return x.BatchedMatmul(y);}, a, b);
+}
+template<typename T>
+TensorFuture<T> ExecutionStream::Add(const TensorFuture<T>& a, const TensorFuture<T>& b) {
+  return Enqueue([](const Tensor<T>& x, const Tensor<T>& y) {return x + y;}, a, b);
+}
+template<typename T, typename... UnaryOps>
+TensorFuture<T> ExecutionStream::Map(const TensorFuture<T>& a, UnaryOps... operations) {
+  return Enqueue([operations...](const Tensor<T>& x) {return x.Map(operations...);}, a);
+}
+// End of Operations ---------------------------------------------------
+// End of ExecutionStream ==========================================================
+
+} // util
+} // cpp_nn
@@ -0,0 +1,546 @@
+#include "CPPNeuralNet/Utils/autograd.h"
+#include "CPPNeuralNet/Utils/gemm.h"
+#include "CPPNeuralNet/Utils/reduction.h"
+#include "CPPNeuralNet/Utils/utils.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace cpp_nn {
+namespace util {
+
+namespace autograd_detail {
+/** Whether shape is a trailing part of out_shape, so in[i % size] lines up with out[i] */
+inline bool IsTrailing(const std::vector<int>& shape, const std::vector<int>& out_shape) {
+  if (shape.size() > out_shape.size()) return false;
+  return std::equal(shape.begin(), shape.end(), out_shape.end() - shape.size());
+}
+/** Index into tensor of shape for index of broadcast result of out_shape */
+inline int BroadcastIndex(int index, const std::vector<int>& out_shape, const std::vector<int>& shape) {
+  int res = 0;
+  int stride = 1;
+  for (int o = out_shape.size() - 1, s = shape.size() - 1; o >= 0 && s >= 0; --o, --s) {
+    const int position = index % out_shape[o];
+    index /= out_shape[o];
+    if (shape[s] != 1) res += position * stride;
+    stride *= shape[s];
+  }
+  return res;
+}
+/** Broadcast Elementwise, out = op(a, b) */
+template<typename T, typename BinaryOp>
+void BroadcastInto(const Tensor<T>& a, const Tensor<T>& b, Tensor<T>& out, BinaryOp op) {
+  const T* x = a.data();
+  const T* y = b.data();
+  T* z = out.data();
+  const int size = out.getCapacity(), x_size = a.getCapacity(), y_size = b.getCapacity();
+  const std::vector<int> out_shape = out.getShape(), x_shape = a.getShape(), y_shape = b.getShape();
+
+  if (x_size == size && y_size == size) {
+    ParallelChunks(size, [&](int begin, int end) {
+      for (int i = begin; i < end; ++i) z[i] = op(x[i], y[i]);
+    });
+  } else if (x_size == size && IsTrailing(y_shape, out_shape)) { // ie) bias
+    ParallelChunks(size, [&](int begin, int end) {
+      for (int i = begin; i < end; ++i) z[i] = op(x[i], y[i % y_size]);
+    });
+  } else if (y_size == size && IsTrailing(x_shape, out_shape)) {
+    ParallelChunks(size, [&](int begin, int end) {
+      for (int i = begin; i < end; ++i) z[i] = op(x[i % x_size], y[i]);
+    });
+  } else {
+    ParallelChunks(size, [&](int begin, int end) {
+      for (int i = begin; i < end; ++i) {
+        z[i] = op(x[BroadcastIndex(i, out_shape, x_shape)], y[BroadcastIndex(i, out_shape, y_shape)]);
+      }
+    });
+  }
+}
+/** Swapped Axes
+ *  Writes (or adds, if accumulate) source of shape into destination, with axes one and two swapped.
+ */
+template<typename T>
+void SwapAxesInto(const T* source, const std::vector<int>& shape, int axis_one, int axis_two,
+                  T* destination, bool accumulate) {
+  const int order = shape.size();
+  std::vector<int> swapped(shape);
+  std::swap(swapped[axis_one], swapped[axis_two]);
+  std::vector<int> strides(order, 1); // Destination stride of each source axis
+  for (int i = order - 2; i >= 0; --i) strides[i] = strides[i + 1] * swapped[i + 1];
+  std::swap(strides[axis_one], strides[axis_two]);
+
+  int size = 1;
+  for (const int& dim : shape) size *= dim;
+  std::vector<int> position(order, 0);
+  int target = 0;
+  for (int i = 0; i < size; ++i) {
+    if (accumulate) destination[target] += source[i];
+    else destination[target] = source[i];
+    // Odometer over source index, last axis fastest
+    for (int a = order - 1; a >= 0; --a) {
+      target += strides[a];
+      if (++position[a] < shape[a]) break;
+      target -= strides[a] * shape[a];
+      position[a] = 0;
+    }
+  }
+}
+} // namespace autograd_detail
+
+// Variable ========================================================================
+template<typename T>
+const Tensor<T>& Variable<T>::getValue() const {
+  if (tape_ == nullptr) throw std::invalid_argument("Variable getValue- Invalid Variable");
+  return tape_->getValue(*this);
+}
+template<typename T>
+const Tensor<T>& Variable<T>::getGradient() const {
+  if (tape_ == nullptr) throw std::invalid_argument("Variable getGradient- Invalid Variable");
+  return tape_->getGradient(*this);
+}
+template<typename T>
+Variable<T> Variable<T>::operator*(const Variable<T>& other) const {
+  if (tape_ == nullptr) throw std::invalid_argument("Variable Operator- Invalid Variable");
+  return tape_->Matmul(*this, other);
+}
+template<typename T>
+Variable<T> Variable<T>::operator+(const Variable<T>& other) const {
+  if (tape_ == nullptr) throw std::invalid_argument("Variable Operator- Invalid Variable");
+  return tape_->Add(*this, other);
+}
+template<typename T>
+Variable<T> Variable<T>::operator-(const Variable<T>& other) const {
+  if (tape_ == nullptr) throw std::invalid_argument("Variable Operator- Invalid Variable");
+  return tape_->Subtract(*this, other);
+}
+// End of Variable =================================================================
+
+// Tape ============================================================================
+template<typename T>
+Tape<T>::Tape() : num_nodes_(0), root_(-1), backward_done_(false) {}
+
+// Housekeeping --------------------------------------------------------
+template<typename T>
+int Tape<T>::Record(TapeOp op, int input_one, int input_two, const std::vector<int>& shape) {
+  if (backward_done_) throw std::invalid_argument("Tape Record- Backward Already Run");
+  if (num_nodes_ == static_cast<int>(nodes_.size())) {
+    // shape may be an input's, inside nodes_, which growing reallocates
+    const std::vector<int> kept_shape = shape;
+    nodes_.emplace_back();
+    return Record(op, input_one, input_two, kept_shape);
+  }
+
+  Node& node = nodes_[num_nodes_];
+  node.op = op;
+  node.inputs[0] = input_one;
+  node.inputs[1] = input_two;
+  node.shape = shape; // Reuses capacity of recycled record
+  node.external = nullptr;
+  node.value = op == TapeOp::kLeaf ? -1 : Acquire(shape);
+  node.gradient = -1;
+  node.saved_uses = 0;
+  node.requires_gradient = (input_one >= 0 && nodes_[input_one].requires_gradient) ||
+                           (input_two >= 0 && nodes_[input_two].requires_gradient);
+  return num_nodes_++;
+}
+template<typename T>
+int Tape<T>::IndexOf(const Variable<T>& variable) const {
+  if (variable.getTape() != this || variable.getIndex() < 0 || variable.getIndex() >= num_nodes_) {
+    throw std::invalid_argument("Tape Variable- Variable Not On Tape");
+  }
+  return variable.getIndex();
+}
+template<typename T>
+Tensor<T>& Tape<T>::ValueOf(int node) {
+  // Leaf values are only ever read
+  if (nodes_[node].external != nullptr) return const_cast<Tensor<T>&>(*nodes_[node].external);
+  if (nodes_[node].value < 0) throw std::invalid_argument("Tape Value- Value Released");
+  return buffers_[nodes_[node].value];
+}
+template<typename T>
+int Tape<T>::Acquire(const std::vector<int>& shape) {
+  if (free_buffers_.empty()) {
+    buffers_.emplace_back(shape);
+    return buffers_.size() - 1;
+  }
+  const int buffer = free_buffers_.back();
+  free_buffers_.pop_back();
+  buffers_[buffer].Resize(shape);
+  return buffer;
+}
+template<typename T>
+void Tape<T>::Release(int& buffer) {
+  if (buffer < 0) return;
+  free_buffers_.push_back(buffer);
+  buffer = -1;
+}
+template<typename T>
+T* Tape<T>::GradientOf(int node) {
+  Node& record = nodes_[node];
+  if (record.gradient < 0) {
+    record.gradient = Acquire(record.shape);
+    Tensor<T>& gradient = buffers_[record.gradient];
+    std::fill(gradient.data(), gradient.data() + gradient.getCapacity(), T(0));
+  }
+  return buffers_[record.gradient].data();
+}
+template<typename T>
+void Tape<T>::Unuse(int node) {
+  if (--nodes_[node].saved_uses == 0 && node != root_) Release(nodes_[node].value);
+}
+template<typename T>
+void Tape<T>::Unbroadcast(const T* gradient, const std::vector<int>& out_shape, int node) {
+  using Acc = AccumulatorType<T>;
+  const std::vector<int>& shape = nodes_[node].shape;
+  T* target = GradientOf(node);
+  int size = 1, target_size = 1;
+  for (const int& dim : out_shape) size *= dim;
+  for (const int& dim : shape) target_size *= dim;
+
+  if (size == target_size) {
+    ParallelChunks(size, [&](int begin, int end) {
+      for (int i = begin; i < end; ++i) target[i] += gradient[i];
+    });
+  } else if (autograd_detail::IsTrailing(shape, out_shape)) {
+    // Sum over leading axes, as for a bias
+    scratch_.resize(target_size);
+    ParallelReduceAxis(gradient, 1, size / target_size, target_size, Acc(0),
+                       [](Acc x, Acc y) {return x + y;}, scratch_.data());
+    for (int i = 0; i < target_size; ++i) target[i] += static_cast<T>(scratch_[i]);
+  } else {
+    for (int i = 0; i < size; ++i) {
+      target[autograd_detail::BroadcastIndex(i, out_shape, shape)] += gradient[i];
+    }
+  }
+}
+// End of Housekeeping -------------------------------------------------
+
+// Recording -----------------------------------------------------------
+template<typename T>
+Variable<T> Tape<T>::Leaf(const Tensor<T>& value, bool requires_gradient /*= true*/) {
+  const int index = Record(TapeOp::kLeaf, -1, -1, value.getShape());
+  nodes_[index].external = &value;
+  nodes_[index].requires_gradient = requires_gradient;
+  return Variable<T>(this, index);
+}
+template<typename T>
+Variable<T> Tape<T>::Matmul(const Variable<T>& a, const Variable<T>& b) {
+  const int x = IndexOf(a), y = IndexOf(b);
+  const std::vector<int> x_shape = nodes_[x].shape, y_shape = nodes_[y].shape;
+  if (x_shape.size() < 2 || y_shape.size() != 2) throw std::invalid_argument("Tape Matmul- Unsupported Shapes");
+  if (x_shape.back() != y_shape[0]) throw std::invalid_argument("Tape Matmul- Dimension Mismatch");
+
+  std::vector<int> shape(x_shape);
+  shape.back() = y_shape[1];
+  const int index = Record(TapeOp::kMatmul, x, y, shape);
+  ++nodes_[x].saved_uses;
+  ++nodes_[y].saved_uses;
+
+  const Tensor<T>& A = ValueOf(x);
+  const Tensor<T>& B = ValueOf(y);
+  const int K = y_shape[0], N = y_shape[1];
+  Gemm(A.getCapacity() / K, N, K, A.data(), K, 1, B.data(), N, 1, ValueOf(index).data(), N);
+  return Variable<T>(this, index);
+}
+template<typename T>
+Variable<T> Tape<T>::Add(const Variable<T>& a, const Variable<T>& b) {
+  const int x = IndexOf(a), y = IndexOf(b);
+  const int index = Record(TapeOp::kAdd, x, y, Tensor<T>::BroadcastShapes(nodes_[x].shape, nodes_[y].shape));
+  autograd_detail::BroadcastInto(ValueOf(x), ValueOf(y), ValueOf(index), [](T p, T q) {return p + q;});
+  return Variable<T>(this, index);
+}
+template<typename T>
+Variable<T> Tape<T>::Subtract(const Variable<T>& a, const Variable<T>& b) {
+  const int x = IndexOf(a), y = IndexOf(b);
+  const int index = Record(TapeOp::kSubtract, x, y, Tensor<T>::BroadcastShapes(nodes_[x].shape, nodes_[y].shape));
+  autograd_detail::BroadcastInto(ValueOf(x), ValueOf(y), ValueOf(index), [](T p, T q) {return p - q;});
+  return Variable<T>(this, index);
+}
+template<typename T>
+Variable<T> Tape<T>::Multiply(const Variable<T>& a, const Variable<T>& b) {
+  const int x = IndexOf(a), y = IndexOf(b);
+  const int index = Record(TapeOp::kMultiply, x, y, Tensor<T>::BroadcastShapes(nodes_[x].shape, nodes_[y].shape));
+  ++nodes_[x].saved_uses;
+  ++nodes_[y].saved_uses;
+  autograd_detail::BroadcastInto(ValueOf(x), ValueOf(y), ValueOf(index), [](T p, T q) {return p * q;});
+  return Variable<T>(this, index);
+}
+template<typename T>
+Variable<T> Tape<T>::Scale(const Variable<T>& a, T scalar) {
+  const int x = IndexOf(a);
+  const int index = Record(TapeOp::kScale, x, -1, nodes_[x].shape);
+  nodes_[index].scalar = scalar;
+
+  const T* source = ValueOf(x).data();
+  T* res = ValueOf(index).data();
+  ParallelChunks(ValueOf(index).getCapacity(), [&](int begin, int end) {
+    for (int i = begin; i < end; ++i) res[i] = scalar * source[i];
+  });
+  return Variable<T>(this, index);
+}
+template<typename T>
+Variable<T> Tape<T>::Apply(const Variable<T>& a, Activation activation) {
+  const int x = IndexOf(a);
+  const int index = Record(TapeOp::kActivation, x, -1, nodes_[x].shape);
+  nodes_[index].activation = activation;
+  // Derivative reads both input and output
+  ++nodes_[x].saved_uses;
+  ++nodes_[index].saved_uses;
+
+  const T* source = ValueOf(x).data();
+  T* res = ValueOf(index).data();
+  ParallelChunks(ValueOf(index).getCapacity(), [&](int begin, int end) {
+    for (int i = begin; i < end; ++i) res[i] = ApplyActivation(activation, source[i]);
+  });
+  return Variable<T>(this, index);
+}
+template<typename T>
+Variable<T> Tape<T>::Sum(const Variable<T>& a) {
+  const int x = IndexOf(a);
+  const int index = Record(TapeOp::kSum, x, -1, {1});
+  ValueOf(index).data()[0] = ValueOf(x).Sum();
+  return Variable<T>(this, index);
+}
+template<typename T>
+Variable<T> Tape<T>::Sum(const Variable<T>& a, int axis) {
+  using Acc = AccumulatorType<T>;
+  const int x = IndexOf(a);
+  std::vector<int> shape = nodes_[x].shape;
+  if (axis < 0 || axis >= static_cast<int>(shape.size())) throw std::invalid_argument("Tape Sum- Axis Out of Bounds");
+
+  int outer = 1, inner = 1;
+  for (int i = 0; i < axis; ++i) outer *= shape[i];
+  for (int i = axis + 1; i < static_cast<int>(shape.size()); ++i) inner *= shape[i];
+  const int length = shape[axis];
+  shape.erase(shape.begin() + axis);
+  if (shape.empty()) shape.push_back(1);
+
+  const int index = Record(TapeOp::kSumAxis, x, -1, shape);
+  nodes_[index].axis = axis;
+  scratch_.resize(static_cast<size_t>(outer) * inner);
+  ParallelReduceAxis(ValueOf(x).data(), outer, length, inner, Acc(0), [](Acc p, Acc q) {return p + q;}, scratch_.data());
+  T* res = ValueOf(index).data();
+  for (size_t i = 0; i < scratch_.size(); ++i) res[i] = static_cast<T>(scratch_[i]);
+  return Variable<T>(this, index);
+}
+template<typename T>
+Variable<T> Tape<T>::Mean(const Variable<T>& a) {
+  const int x = IndexOf(a);
+  const int index = Record(TapeOp::kMean, x, -1, {1});
+  ValueOf(index).data()[0] = ValueOf(x).Mean();
+  return Variable<T>(this, index);
+}
+template<typename T>
+Variable<T> Tape<T>::Reshape(const Variable<T>& a, const std::vector<int>& dims) {
+  const int x = IndexOf(a);
+  int capacity = dims.empty() ? 0 : 1;
+  for (const int& dim : dims) capacity *= dim;
+  if (capacity != ValueOf(x).getCapacity()) throw std::invalid_argument("Tape Reshape- Capacity Mismatch");
+
+  const int index = Record(TapeOp::kReshape, x, -1, dims);
+  const Tensor<T>& source = ValueOf(x);
+  std::copy(source.data(), source.data() + capacity, ValueOf(index).data());
+  return Variable<T>(this, index);
+}
+template<typename T>
+Variable<T> Tape<T>::Transpose(const Variable<T>& a, int axis_one, int axis_two) {
+  const int x = IndexOf(a);
+  std::vector<int> shape = nodes_[x].shape;
+  const int order = shape.size();
+  if (axis_one < 0 || axis_one >= order || axis_two < 0 || axis_two >= order) {
+    throw std::invalid_argument("Tape Transpose- Axis Out of Bounds");
+  }
+  std::swap(shape[axis_one], shape[axis_two]);
+
+  const int index = Record(TapeOp::kTranspose, x, -1, shape);
+  nodes_[index].axis = axis_one;
+  nodes_[index].axis_two = axis_two;
+  autograd_detail::SwapAxesInto(ValueOf(x).data(), nodes_[x].shape, axis_one, axis_two, ValueOf(index).data(), false);
+  return Variable<T>(this, index);
+}
+// End of Recording ----------------------------------------------------
+
+// Backward ------------------------------------------------------------
+template<typename T>
+void Tape<T>::BackwardNode(int index) {
+  Node& node = nodes_[index];
+  const int x = node.inputs[0], y = node.inputs[1];
+  const bool x_gradient = x >= 0 && nodes_[x].requires_gradient;
+  const bool y_gradient = y >= 0 && nodes_[y].requires_gradient;
+  const T* gradient = buffers_[node.gradient].data();
+  const int size = buffers_[node.gradient].getCapacity();
+
+  switch (node.op) {
+    case TapeOp::kMatmul: {
+      const Tensor<T>& A = ValueOf(x);
+      const Tensor<T>& B = ValueOf(y);
+      const int K = nodes_[y].shape[0], N = nodes_[y].shape[1], M = A.getCapacity() / K;
+      GemmEpilogue<T> accumulate;
+      accumulate.beta = T(1);
+      // dA += dC * B^T, dB += A^T * dC, transposes read as strided views
+      if (x_gradient) Gemm(M, K, N, gradient, N, 1, B.data(), 1, N, GradientOf(x), K, accumulate);
+      if (y_gradient) Gemm(K, N, M, A.data(), 1, K, gradient, N, 1, GradientOf(y), N, accumulate);
+      break;
+    }
+    case TapeOp::kAdd:
+    case TapeOp::kSubtract: {
+      if (x_gradient) Unbroadcast(gradient, node.shape, x);
+      if (!y_gradient) break;
+      if (node.op == TapeOp::kAdd) {
+        Unbroadcast(gradient, node.shape, y);
+        break;
+      }
+      // Negated into a scratch buffer, then summed as Add's
+      int negated = Acquire(node.shape);
+      T* values = buffers_[negated].data();
+      for (int i = 0; i < size; ++i) values[i] = -gradient[i];
+      Unbroadcast(values, node.shape, y);
+      Release(negated);
+      break;
+    }
+    case TapeOp::kMultiply: {
+      // d(x * y) = dz * y into x, and dz * x into y, each at the product's shape first
+      int product = Acquire(node.shape);
+      Tensor<T>& values = buffers_[product];
+      Tensor<T> gradient_view = Tensor<T>::View(node.shape, const_cast<T*>(gradient));
+      if (x_gradient) {
+        autograd_detail::BroadcastInto(gradient_view, ValueOf(y), values, [](T p, T q) {return p * q;});
+        Unbroadcast(values.data(), node.shape, x);
+      }
+      if (y_gradient) {
+        autograd_detail::BroadcastInto(gradient_view, ValueOf(x), values, [](T p, T q) {return p * q;});
+        Unbroadcast(values.data(), node.shape, y);
+      }
+      Release(product);
+      break;
+    }
+    case TapeOp::kScale: {
+      if (!x_gradient) break;
+      T* target = GradientOf(x);
+      const T scalar = node.scalar;
+      ParallelChunks(size, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) target[i] += scalar * gradient[i];
+      });
+      break;
+    }
+    case TapeOp::kActivation: {
+      if (!x_gradient) break;
+      T* target = GradientOf(x);
+      const T* input = ValueOf(x).data();
+      const T* output = ValueOf(index).data();
+      const Activation activation = node.activation;
+      ParallelChunks(size, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+          target[i] += gradient[i] * ActivationDerivative(activation, input[i], output[i]);
+        }
+      });
+      break;
+    }
+    case TapeOp::kSum:
+    case TapeOp::kMean: {
+      if (!x_gradient) break;
+      T* target = GradientOf(x);
+      int x_size = 1;
+      for (const int& dim : nodes_[x].shape) x_size *= dim;
+      const T value = node.op == TapeOp::kSum ? gradient[0] : T(gradient[0] / T(x_size));
+      ParallelChunks(x_size, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) target[i] += value;
+      });
+      break;
+    }
+    case TapeOp::kSumAxis: {
+      if (!x_gradient) break;
+      T* target = GradientOf(x);
+      const std::vector<int>& shape = nodes_[x].shape;
+      int outer = 1, inner = 1;
+      for (int i = 0; i < node.axis; ++i) outer *= shape[i];
+      for (int i = node.axis + 1; i < static_cast<int>(shape.size()); ++i) inner *= shape[i];
+      const int length = shape[node.axis];
+      // Every element along axis receives its reduced element's gradient
+      ParallelChunks(outer * length, [&](int begin, int end) {
+        for (int r = begin; r < end; ++r) {
+          const T* source = gradient + static_cast<size_t>(r / length) * inner;
+          T* row = target + static_cast<size_t>(r) * inner;
+          for (int i = 0; i < inner; ++i) row[i] += source[i];
+        }
+      }, std::max(1, kParallelGrainSize / std::max(inner, 1)));
+      break;
+    }
+    case TapeOp::kReshape: {
+      if (!x_gradient) break;
+      T* target = GradientOf(x);
+      ParallelChunks(size, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) target[i] += gradient[i];
+      });
+      break;
+    }
+    case TapeOp::kTranspose: {
+      if (x_gradient) {
+        autograd_detail::SwapAxesInto(gradient, node.shape, node.axis, node.axis_two, GradientOf(x), true);
+      }
+      break;
+    }
+    default:
+      break;
+  }
+}
+template<typename T>
+void Tape<T>::Backward(const Variable<T>& root) {
+  const int root_index = IndexOf(root);
+  if (backward_done_) throw std::invalid_argument("Tape Backward- Already Run");
+  if (ValueOf(root_index).getCapacity() != 1) throw std::invalid_argument("Tape Backward- Non-Scalar Root");
+  backward_done_ = true;
+  root_ = root_index;
+
+  // Values no backward step reads are dead already
+  for (int i = 0; i < num_nodes_; ++i) {
+    if (nodes_[i].saved_uses == 0 && i != root_) Release(nodes_[i].value);
+  }
+  if (nodes_[root_].requires_gradient) GradientOf(root_)[0] = T(1);
+
+  for (int i = root_; i >= 0; --i) {
+    Node& node = nodes_[i];
+    if (node.gradient >= 0 && node.op != TapeOp::kLeaf) BackwardNode(i);
+
+    // Backward of node is done reading its inputs, and itself
+    switch (node.op) {
+      case TapeOp::kMatmul:
+      case TapeOp::kMultiply:
+        Unuse(node.inputs[0]);
+        Unuse(node.inputs[1]);
+        break;
+      case TapeOp::kActivation:
+        Unuse(node.inputs[0]);
+        Unuse(i);
+        break;
+      default:
+        break;
+    }
+    if (node.op != TapeOp::kLeaf) Release(node.gradient);
+  }
+}
+template<typename T>
+const Tensor<T>& Tape<T>::getValue(const Variable<T>& variable) {
+  return ValueOf(IndexOf(variable));
+}
+template<typename T>
+const Tensor<T>& Tape<T>::getGradient(const Variable<T>& variable) {
+  const int index = IndexOf(variable);
+  if (nodes_[index].gradient < 0) throw std::invalid_argument("Tape getGradient- No Gradient");
+  return buffers_[nodes_[index].gradient];
+}
+template<typename T>
+void Tape<T>::Clear() {
+  for (int i = 0; i < num_nodes_; ++i) {
+    Release(nodes_[i].value);
+    Release(nodes_[i].gradient);
+  }
+  num_nodes_ = 0;
+  root_ = -1;
+  backward_done_ = false;
+}
+// End of Backward -----------------------------------------------------
+// End of Tape =====================================================================
+
+} // util
+} // cpp_nn
@@ -0,0 +1,20 @@
+#include "CPPNeuralNet/Utils/block_sparse.h"
+
+#include <atomic>
+
+namespace cpp_nn {
+namespace util {
+
+namespace {
+std::atomic<double> block_sparse_threshold(0.7);
+} // namespace
+
+void SetBlockSparseThreshold(double threshold) {
+  block_sparse_threshold.store(threshold);
+}
+double getBlockSparseThreshold() {
+  return block_sparse_threshold.load();
+}
+
+} // util
+} // cpp_nn
@@ -0,0 +1,445 @@
+#include "CPPNeuralNet/Utils/block_sparse.h"
+#include "CPPNeuralNet/Utils/utils.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace cpp_nn {
+namespace util {
+
+constexpr int kSparseRowTile = 4;      // Rows of C sharing each loaded block
+constexpr int kTwoFourRowTile = 16;    // Rows of C sharing each expanded 2:4 tile
+constexpr int kTwoFourColTile = 16;    // Cols of C kept in accumulators by 2:4 kernel
+constexpr int kStructuredMinSize = 16; // Smaller K or N of weight are left dense
+
+// Block Sparse --------------------------------------------------------
+/** Zero Block Fraction */
+template<typename T>
+double BlockSparseMatrix<T>::ZeroBlockFraction(int K, int N, const T* B, int b_row_stride, int b_col_stride,
+                                               int block_rows, int block_cols, double at_least /*= 0.0*/) {
+  const int block_row_count = (K + block_rows - 1) / block_rows;
+  const int block_col_count = (N + block_cols - 1) / block_cols;
+  const long long total = static_cast<long long>(block_row_count) * block_col_count;
+  if (total == 0) return 0.0;
+  const long long max_nonzero = static_cast<long long>((1.0 - at_least) * total);
+
+  long long nonzero = 0;
+  for (int kb = 0; kb < block_row_count; ++kb) {
+    for (int jb = 0; jb < block_col_count; ++jb) {
+      bool is_zero = true;
+      for (int k = kb * block_rows; is_zero && k < std::min(K, (kb + 1) * block_rows); ++k) {
+        for (int n = jb * block_cols; n < std::min(N, (jb + 1) * block_cols); ++n) {
+          if (B[k * b_row_stride + n * b_col_stride] != T(0)) {
+            is_zero = false;
+            break;
+          }
+        }
+      }
+      if (!is_zero && ++nonzero > max_nonzero) return 0.0;
+    }
+  }
+  return 1.0 - static_cast<double>(nonzero) / total;
+}
+/** Packs B */
+template<typename T>
+void BlockSparseMatrix<T>::Pack(int K, int N, const T* B, int b_row_stride, int b_col_stride,
+                                int block_rows, int block_cols) {
+  if (!((block_rows == 4 && block_cols == 4) || (block_rows == 1 && block_cols == 16) ||
+        (block_rows == 16 && block_cols == 1)))
+    throw std::invalid_argument("BlockSparseMatrix Pack- Unsupported Block Shape");
+  K_ = K;
+  N_ = N;
+  block_rows_ = block_rows;
+  block_cols_ = block_cols;
+
+  const int block_row_count = (K + block_rows - 1) / block_rows;
+  const int block_col_count = (N + block_cols - 1) / block_cols;
+  const int block_size = block_rows * block_cols;
+  col_offsets_.assign(1, 0);
+  block_row_indices_.clear();
+  blocks_.clear();
+
+  // Marks non-zero blocks in B's row-major order, then gathers them block column by block column
+  std::vector<char> nonzero(static_cast<size_t>(block_row_count) * block_col_count, 0);
+  for (int k = 0; k < K; ++k) {
+    const T* b = B + k * b_row_stride;
+    char* mask = nonzero.data() + static_cast<size_t>(k / block_rows) * block_col_count;
+    for (int jb = 0; jb < block_col_count; ++jb) {
+      const T* b_block = b + jb * block_cols * b_col_stride;
+      bool any = false;
+      for (int j = 0; j < std::min(block_cols, N - jb * block_cols); ++j) any |= b_block[j * b_col_stride] != T(0);
+      mask[jb] |= any;
+    }
+  }
+  for (int jb = 0; jb < block_col_count; ++jb) {
+    for (int kb = 0; kb < block_row_count; ++kb) {
+      if (nonzero[static_cast<size_t>(kb) * block_col_count + jb]) block_row_indices_.push_back(kb);
+    }
+    col_offsets_.push_back(block_row_indices_.size());
+  }
+
+  // Edge blocks are zero-padded to full shape
+  blocks_.assign(static_cast<size_t>(block_row_indices_.size()) * block_size, T(0));
+  for (int jb = 0; jb < block_col_count; ++jb) {
+    const int n_begin = jb * block_cols;
+    const int nc = std::min(block_cols, N - n_begin);
+    for (int p = col_offsets_[jb]; p < col_offsets_[jb + 1]; ++p) {
+      const int k_begin = block_row_indices_[p] * block_rows;
+      const int kr = std::min(block_rows, K - k_begin);
+      for (int i = 0; i < kr; ++i) {
+        const T* b = B + (k_begin + i) * b_row_stride + n_begin * b_col_stride;
+        T* block = blocks_.data() + static_cast<size_t>(p) * block_size + i * block_cols;
+        for (int j = 0; j < nc; ++j) block[j] = b[j * b_col_stride];
+      }
+    }
+  }
+}
+/** Refills kept blocks from B */
+template<typename T>
+void BlockSparseMatrix<T>::Refill(const T* B, int b_row_stride, int b_col_stride) {
+  const int block_col_count = (N_ + block_cols_ - 1) / block_cols_;
+  const int block_size = block_rows_ * block_cols_;
+  for (int jb = 0; jb < block_col_count; ++jb) {
+    const int n_begin = jb * block_cols_;
+    const int nc = std::min(block_cols_, N_ - n_begin);
+    for (int p = col_offsets_[jb]; p < col_offsets_[jb + 1]; ++p) {
+      const int k_begin = block_row_indices_[p] * block_rows_;
+      const int kr = std::min(block_rows_, K_ - k_begin);
+      for (int i = 0; i < kr; ++i) {
+        const T* b = B + (k_begin + i) * b_row_stride + n_begin * b_col_stride;
+        T* block = blocks_.data() + static_cast<size_t>(p) * block_size + i * block_cols_;
+        for (int j = 0; j < nc; ++j) block[j] = b[j * b_col_stride];
+      }
+    }
+  }
+}
+/** Zeroes D outside kept blocks */
+template<typename T>
+void BlockSparseMatrix<T>::Mask(T* D, int d_row_stride, int d_col_stride) const {
+  const int block_row_count = (K_ + block_rows_ - 1) / block_rows_;
+  const int block_col_count = (N_ + block_cols_ - 1) / block_cols_;
+  for (int jb = 0; jb < block_col_count; ++jb) {
+    const int n_begin = jb * block_cols_;
+    const int nc = std::min(block_cols_, N_ - n_begin);
+    // Kept block rows of a block column are in increasing order, so zero blocks are the gaps between them
+    int p = col_offsets_[jb];
+    for (int kb = 0; kb < block_row_count; ++kb) {
+      if (p < col_offsets_[jb + 1] && block_row_indices_[p] == kb) {
+        ++p;
+        continue;
+      }
+      for (int k = kb * block_rows_; k < std::min(K_, (kb + 1) * block_rows_); ++k) {
+        T* d = D + k * d_row_stride + n_begin * d_col_stride;
+        for (int j = 0; j < nc; ++j) d[j * d_col_stride] = T(0);
+      }
+    }
+  }
+}
+// End of Block Sparse -------------------------------------------------
+
+// 2:4 Sparse ----------------------------------------------------------
+template<typename T>
+bool TwoFourSparseMatrix<T>::Matches(int K, int N, const T* B, int b_row_stride, int b_col_stride) {
+  for (int k = 0; k < K; k += 4) {
+    for (int n = 0; n < N; ++n) {
+      int nonzero = 0;
+      for (int i = k; i < std::min(K, k + 4); ++i) {
+        nonzero += B[i * b_row_stride + n * b_col_stride] != T(0);
+      }
+      if (nonzero > 2) return false;
+    }
+  }
+  return true;
+}
+template<typename T>
+void TwoFourSparseMatrix<T>::Pack(int K, int N, const T* B, int b_row_stride, int b_col_stride) {
+  K_ = K;
+  N_ = N;
+  stride_ = (N + 15) / 16 * 16;
+  values_.assign(static_cast<size_t>(2) * getGroups() * stride_, T(0));
+  indices_.assign(values_.size(), 0);
+
+  for (int g = 0; g < getGroups(); ++g) {
+    for (int n = 0; n < N; ++n) {
+      int kept = 0;
+      for (int i = 0; i < 4 && 4 * g + i < K; ++i) {
+        const T value = B[(4 * g + i) * b_row_stride + n * b_col_stride];
+        if (value == T(0)) continue;
+        if (kept == 2)
+          throw std::invalid_argument("TwoFourSparseMatrix Pack- More Than 2 Non-Zeros in Group");
+        values_[static_cast<size_t>(2 * g + kept) * stride_ + n] = value;
+        indices_[static_cast<size_t>(2 * g + kept) * stride_ + n] = i;
+        ++kept;
+      }
+      // Free slots take positions of zeros, or past K, keeping value 0 so they contribute nothing
+      for (int i = 0; kept < 2; ++i) {
+        if (4 * g + i < K && B[(4 * g + i) * b_row_stride + n * b_col_stride] != T(0)) continue;
+        indices_[static_cast<size_t>(2 * g + kept) * stride_ + n] = i;
+        ++kept;
+      }
+    }
+  }
+}
+/** Refills kept positions from B */
+template<typename T>
+void TwoFourSparseMatrix<T>::Refill(const T* B, int b_row_stride, int b_col_stride) {
+  for (int slot = 0; slot < 2 * getGroups(); ++slot) {
+    const int first = 4 * (slot / 2);
+    for (int n = 0; n < N_; ++n) {
+      const int k = first + indices_[static_cast<size_t>(slot) * stride_ + n];
+      values_[static_cast<size_t>(slot) * stride_ + n] = k < K_ ? B[k * b_row_stride + n * b_col_stride] : T(0);
+    }
+  }
+}
+/** Zeroes D outside kept positions */
+template<typename T>
+void TwoFourSparseMatrix<T>::Mask(T* D, int d_row_stride, int d_col_stride) const {
+  for (int g = 0; g < getGroups(); ++g) {
+    const uint8_t* i0 = indices_.data() + static_cast<size_t>(2 * g) * stride_;
+    const uint8_t* i1 = i0 + stride_;
+    for (int n = 0; n < N_; ++n) {
+      for (int i = 0; i < 4 && 4 * g + i < K_; ++i) {
+        if (i != i0[n] && i != i1[n]) D[(4 * g + i) * d_row_stride + n * d_col_stride] = T(0);
+      }
+    }
+  }
+}
+// End of 2:4 Sparse ---------------------------------------------------
+
+// Structured Sparse ---------------------------------------------------
+/** Checks and packs B */
+template<typename T>
+StructuredFormat StructuredSparseMatrix<T>::Pack(int K, int N, const T* B, int ldb) {
+  format_ = StructuredFormat::kDense;
+  const double threshold = getBlockSparseThreshold();
+  if (threshold <= 0.0 || N < kStructuredMinSize || K < kStructuredMinSize) return format_;
+
+  double best_fraction = 0.0;
+  int best_rows = 0, best_cols = 0;
+  // Scans stop once a shape falls short, so a dense B costs a fraction of one pass per shape
+  for (const auto& shape : {std::make_pair(1, 16), std::make_pair(4, 4), std::make_pair(16, 1)}) {
+    const double fraction = BlockSparseMatrix<T>::ZeroBlockFraction(K, N, B, ldb, 1, shape.first, shape.second,
+                                                                    std::max(threshold, 0.5));
+    if (fraction > best_fraction) {
+      best_fraction = fraction;
+      best_rows = shape.first;
+      best_cols = shape.second;
+    }
+  }
+
+  // Blocks win when they skip more than the half 2:4 always skips
+  if (best_fraction >= threshold && best_fraction > 0.5) {
+    blocks_.Pack(K, N, B, ldb, 1, best_rows, best_cols);
+    // Zero blocks of B are zero blocks of B^T, of transposed shape
+    transposed_blocks_.Pack(N, K, B, 1, ldb, best_cols, best_rows);
+    format_ = StructuredFormat::kBlockSparse;
+  } else if (threshold <= 0.5 && TwoFourSparseMatrix<T>::Matches(K, N, B, ldb, 1)) {
+    two_four_.Pack(K, N, B, ldb, 1);
+    format_ = StructuredFormat::kTwoFour;
+  }
+  return format_;
+}
+template<typename T>
+void StructuredSparseMatrix<T>::Refill(const T* B, int ldb) {
+  if (format_ == StructuredFormat::kBlockSparse) {
+    blocks_.Refill(B, ldb, 1);
+    transposed_blocks_.Refill(B, 1, ldb);
+  } else if (format_ == StructuredFormat::kTwoFour) {
+    two_four_.Refill(B, ldb, 1);
+  }
+}
+template<typename T>
+void StructuredSparseMatrix<T>::Mask(T* D, int ldd) const {
+  if (format_ == StructuredFormat::kBlockSparse) {
+    blocks_.Mask(D, ldd, 1);
+  } else if (format_ == StructuredFormat::kTwoFour) {
+    two_four_.Mask(D, ldd, 1);
+  }
+}
+// End of Structured Sparse --------------------------------------------
+
+// Kernels -------------------------------------------------------------
+/** Tile Writeback
+ *  Epilogue of [mr x nc] accumulator tile at C[row][col], row stride of tile is kTileCols. */
+template<int kTileRows, int kTileCols, typename T, typename Acc>
+inline void StructuredWriteback(const Acc (&acc)[kTileRows][kTileCols], int mr, int nc,
+                                T* C, int ldc, int row, int col, const GemmEpilogue<T>& epilogue) {
+  for (int i = 0; i < mr; ++i) {
+    T* c_row = C + static_cast<size_t>(row + i) * ldc + col;
+    for (int j = 0; j < nc; ++j) {
+      Acc value = static_cast<Acc>(epilogue.alpha) * acc[i][j];
+      if (epilogue.beta != T(0)) value += static_cast<Acc>(epilogue.beta) * static_cast<Acc>(c_row[j]);
+      c_row[j] = NarrowAccumulator<T>(GemmFinish(epilogue, value, row + i, col + j));
+    }
+  }
+}
+/** Block Sparse Kernel of fixed block shape */
+template<int kBlockRows, int kBlockCols, typename T, typename Acc>
+void BlockSparseKernel(int M, const T* A, int a_row_stride, int a_col_stride,
+                       const BlockSparseMatrix<T>& B, T* C, int ldc, const GemmEpilogue<T>& epilogue) {
+  const int K = B.getRows();
+  const int N = B.getCols();
+  const int block_col_count = (N + kBlockCols - 1) / kBlockCols;
+  const int* col_offsets = B.getColOffsets();
+  const int* block_rows = B.getBlockRowIndices();
+  const T* blocks = B.getBlocks();
+
+  const int row_tiles = (M + kSparseRowTile - 1) / kSparseRowTile;
+  const long long tile_work = static_cast<long long>(kSparseRowTile) * B.getNonZeroBlocks() * kBlockRows * kBlockCols;
+  const int grain = std::max(1, static_cast<int>((1LL << 16) / std::max(tile_work, 1LL)));
+
+  ParallelChunks(row_tiles, [&](int tile_begin, int tile_end) {
+    for (int tile = tile_begin; tile < tile_end; ++tile) {
+      const int row = tile * kSparseRowTile;
+      const int mr = std::min(kSparseRowTile, M - row);
+
+      for (int jb = 0; jb < block_col_count; ++jb) {
+        Acc acc[kSparseRowTile][kBlockCols] = {};
+
+        if constexpr (kBlockCols == 1) {
+          // Column blocks are dot products along K, so lanes run over the block's rows
+          //  and are summed once the block column is done
+          Acc dot[kSparseRowTile][kBlockRows] = {};
+          for (int p = col_offsets[jb]; p < col_offsets[jb + 1]; ++p) {
+            const T* block = blocks + static_cast<size_t>(p) * kBlockRows;
+            const int k_begin = block_rows[p] * kBlockRows;
+            if (k_begin + kBlockRows > K) {
+              for (int kk = 0; k_begin + kk < K; ++kk) {
+                for (int i = 0; i < kSparseRowTile; ++i) {
+                  dot[i][kk] += static_cast<Acc>(A[(row + std::min(i, mr - 1)) * a_row_stride + (k_begin + kk) * a_col_stride]) *
+                                static_cast<Acc>(block[kk]);
+                }
+              }
+              continue;
+            }
+            for (int i = 0; i < kSparseRowTile; ++i) {
+              const T* a = A + (row + std::min(i, mr - 1)) * a_row_stride + k_begin * a_col_stride;
+              for (int kk = 0; kk < kBlockRows; ++kk) {
+                dot[i][kk] += static_cast<Acc>(a[kk * a_col_stride]) * static_cast<Acc>(block[kk]);
+              }
+            }
+          }
+          for (int i = 0; i < kSparseRowTile; ++i) {
+            for (int kk = 0; kk < kBlockRows; ++kk) acc[i][0] += dot[i][kk];
+          }
+        } else {
+          for (int p = col_offsets[jb]; p < col_offsets[jb + 1]; ++p) {
+            const T* block = blocks + static_cast<size_t>(p) * kBlockRows * kBlockCols;
+            const int k_begin = block_rows[p] * kBlockRows;
+            const int kr = std::min(kBlockRows, K - k_begin);
+            for (int kk = 0; kk < kr; ++kk) {
+              const T* a = A + (k_begin + kk) * a_col_stride;
+              const T* b = block + kk * kBlockCols;
+              for (int i = 0; i < kSparseRowTile; ++i) {
+                // Rows beyond mr repeat the last valid row, and are not written back
+                const Acc a_i = static_cast<Acc>(a[(row + std::min(i, mr - 1)) * a_row_stride]);
+                for (int j = 0; j < kBlockCols; ++j) {
+                  acc[i][j] += a_i * static_cast<Acc>(b[j]);
+                }
+              }
+            }
+          }
+        }
+
+        StructuredWriteback<kSparseRowTile, kBlockCols>(acc, mr, std::min(kBlockCols, N - jb * kBlockCols),
+                                        C, ldc, row, jb * kBlockCols, epilogue);
+      }
+    }
+  }, grain);
+}
+/** Block Sparse GEMM */
+template<typename T, typename Acc>
+void BlockSparseGemm(int M, const T* A, int a_row_stride, int a_col_stride,
+                     const BlockSparseMatrix<T>& B, T* C, int ldc,
+                     const GemmEpilogue<T>& epilogue /*= GemmEpilogue<T>()*/) {
+  if (M <= 0 || B.getCols() <= 0) return;
+  if (B.getBlockRows() == 4) {
+    BlockSparseKernel<4, 4, T, Acc>(M, A, a_row_stride, a_col_stride, B, C, ldc, epilogue);
+  } else if (B.getBlockRows() == 1) {
+    BlockSparseKernel<1, 16, T, Acc>(M, A, a_row_stride, a_col_stride, B, C, ldc, epilogue);
+  } else {
+    BlockSparseKernel<16, 1, T, Acc>(M, A, a_row_stride, a_col_stride, B, C, ldc, epilogue);
+  }
+}
+/** 2:4 Sparse GEMM */
+template<typename T, typename Acc>
+void TwoFourSparseGemm(int M, const T* A, int a_row_stride, int a_col_stride,
+                       const TwoFourSparseMatrix<T>& B, T* C, int ldc,
+                       const GemmEpilogue<T>& epilogue /*= GemmEpilogue<T>()*/) {
+  const int K = B.getRows();
+  const int N = B.getCols();
+  if (M <= 0 || N <= 0) return;
+  const T* values = B.getValues();
+  const uint8_t* indices = B.getIndices();
+  const int stride = B.getStride();
+
+  const int row_tiles = (M + kTwoFourRowTile - 1) / kTwoFourRowTile;
+  const long long tile_work = static_cast<long long>(kTwoFourRowTile) * K * N / 2;
+  const int grain = std::max(1, static_cast<int>((1LL << 16) / std::max(tile_work, 1LL)));
+
+  ParallelChunks(row_tiles, [&](int tile_begin, int tile_end) {
+    for (int tile = tile_begin; tile < tile_end; ++tile) {
+      const int row = tile * kTwoFourRowTile;
+      const int mr = std::min(kTwoFourRowTile, M - row);
+
+      for (int col = 0; col < N; col += kTwoFourColTile) {
+        const int nc = std::min(kTwoFourColTile, N - col);
+        Acc acc[kTwoFourRowTile][kTwoFourColTile] = {};
+
+        for (int g = 0; g < B.getGroups(); ++g) {
+          const T* v0 = values + static_cast<size_t>(2 * g) * stride + col;
+          const T* v1 = v0 + stride;
+          const uint8_t* i0 = indices + static_cast<size_t>(2 * g) * stride + col;
+          const uint8_t* i1 = i0 + stride;
+          // Expands the group into a dense [4 x 16] tile by selects, shared by every row of the tile,
+          //  which then runs as plain vector multiply-adds
+          Acc b[4][kTwoFourColTile];
+          for (int q = 0; q < 4; ++q) {
+            for (int j = 0; j < kTwoFourColTile; ++j) {
+              b[q][j] = (i0[j] == q ? static_cast<Acc>(v0[j]) : Acc(0)) + (i1[j] == q ? static_cast<Acc>(v1[j]) : Acc(0));
+            }
+          }
+          const int kr = std::min(4, K - 4 * g);
+          for (int i = 0; i < kTwoFourRowTile; ++i) {
+            const T* a = A + (row + std::min(i, mr - 1)) * a_row_stride + 4 * g * a_col_stride;
+            for (int q = 0; q < kr; ++q) {
+              const Acc a_q = static_cast<Acc>(a[q * a_col_stride]);
+              for (int j = 0; j < kTwoFourColTile; ++j) acc[i][j] += a_q * b[q][j];
+            }
+          }
+        }
+
+        StructuredWriteback<kTwoFourRowTile, kTwoFourColTile>(acc, mr, nc, C, ldc, row, col, epilogue);
+      }
+    }
+  }, grain);
+}
+/** Structured Sparse GEMM */
+template<typename T, typename Acc>
+bool StructuredSparseGemm(int M, const T* A, int a_row_stride, int a_col_stride,
+                          const StructuredSparseMatrix<T>& B, T* C, int ldc,
+                          const GemmEpilogue<T>& epilogue /*= GemmEpilogue<T>()*/) {
+  // Fewer rows than a tile would repeat rows, so dense Gemm does better
+  if (B.getFormat() == StructuredFormat::kBlockSparse && M >= kSparseRowTile) {
+    BlockSparseGemm<T, Acc>(M, A, a_row_stride, a_col_stride, B.getBlocks(), C, ldc, epilogue);
+    return true;
+  }
+  if (B.getFormat() == StructuredFormat::kTwoFour && M >= kTwoFourRowTile) {
+    TwoFourSparseGemm<T, Acc>(M, A, a_row_stride, a_col_stride, B.getTwoFour(), C, ldc, epilogue);
+    return true;
+  }
+  return false;
+}
+/** Structured Sparse GEMM, Transposed */
+template<typename T, typename Acc>
+bool StructuredSparseGemmTransposed(int M, const T* A, int a_row_stride, int a_col_stride,
+                                    const StructuredSparseMatrix<T>& B, T* C, int ldc,
+                                    const GemmEpilogue<T>& epilogue /*= GemmEpilogue<T>()*/) {
+  if (B.getFormat() != StructuredFormat::kBlockSparse || M < kSparseRowTile) return false;
+  BlockSparseGemm<T, Acc>(M, A, a_row_stride, a_col_stride, B.getTransposedBlocks(), C, ldc, epilogue);
+  return true;
+}
+// End of Kernels ------------------------------------------------------
+
+} // util
+} // cpp_nn
@@ -39,10 +39,11 @@ const T& ElementReference<T>::getElement() const {
 template<typename T>
 BroadcastReference<T>::BroadcastReference(const Tensor<T>& tensor, const std::vector<int>& broadcast_shape)
     : ElementReference<T>(tensor), kBroadcastShape(broadcast_shape), 
-      indices_(std::vector(broadcast_shape.size(), 0)) {
-  if (this->elements_->order() > indices_.size()) {
+      indices_(std::vector<int>(broadcast_shape.size(), 0)) {
+  if (this->elements_->getOrder() > indices_.size()) {
     throw std::invalid_argument("BroadcastReference Constrcutor- Broadcast Shape smaller than Tensor Shape");
   }
+  ComputeStrides();
 }
 /** Tensor-Referencing with Broadcasting
  *  Assumes broadcast shape is valid
@@ -51,14 +52,14 @@ BroadcastReference<T>::BroadcastReference(const Tensor<T>& tensor, const std::ve
 template<typename T>
 BroadcastReference<T>::BroadcastReference(const Tensor<T>& tensor, const std::vector<int>& broadcast_shape, 
                                           const std::vector<int>& indices)
-    : ElementReference<T>(tensor, indices), kBroadcastShape(broadcast_shape),
+    : ElementReference<T>(tensor), kBroadcastShape(broadcast_shape),
       indices_(indices) {
   // Assumes the shape is boradcastable
   // As such, tensor's dimension check is bypassed
-  if (this->elements_->order() > indices_.size()) {
+  if (this->elements_->getOrder() > kBroadcastShape.size()) {
     throw std::invalid_argument("BroadcastReference Constrcutor- Broadcast Shape smaller than Tensor Shape");
   }
-  if (indices_.size() != kBroadcastShape.size) {
+  if (indices_.size() != kBroadcastShape.size()) {
     throw std::invalid_argument("BroadcastReference Constrcutor- Index does not match Broadcast Order");
   }
   for (int i = 0; i < indices_.size(); ++i) {
@@ -66,6 +67,11 @@ BroadcastReference<T>::BroadcastReference(const Tensor<T>& tensor, const std::ve
       throw std::invalid_argument("BroadcastReference Constrcutor- Index out of Broadcast Bound");
     }
   }
+  ComputeStrides();
+
+  for (int i = 0; i < indices_.size(); ++i) {
+    this->index_address_ += indices_[i] * strides_[i];
+  }
 }
 /** Tensor-Referencing with Broadcasting and Inex as InitList */
 template<typename T>
@@ -74,6 +80,23 @@ BroadcastReference<T>::BroadcastReference(const Tensor<T>& tensor, const std::ve
     : BroadcastReference<T>(tensor, broadcast_shape, std::vector<int>(indices)) {}
 // End of Constructor -------------------------------------------
 
+// Housekeeping -------------------------------------------------
+template<typename T>
+void BroadcastReference<T>::ComputeStrides() {
+  const int order = kBroadcastShape.size();
+  const int tensor_order = this->elements_->getOrder();
+
+  // Tensor is right-aligned to broadcast shape
+  strides_.assign(order, 0);
+  int block_size = 1;
+  for (int i = 1; i <= tensor_order; ++i) {
+    const int dim = this->elements_->getDimension(tensor_order - i);
+    // if dim is 1, index is either 0, or is broadcasted
+    if (dim != 1) strides_[order - i] = block_size;
+    block_size *= dim;
+  }
+}
+// End of Housekeeping ------------------------------------------
 
 // Iteration ----------------------------------------------------
 /** Increments index over.
@@ -81,52 +104,22 @@ BroadcastReference<T>::BroadcastReference(const Tensor<T>& tensor, const std::ve
  */
 template<typename T>
 int BroadcastReference<T>::incrementIndex() {
-  const int order = indices_.size();
-  const int tensor_order = this->elements_.order();
-
-  bool carry = false; // to be used to decide of iteration is carrying over
-  this->index_address_ = 0; // reset and built from start
-  int jump_size = 1;
-
-  int i = 0;
-  while (i < order) {
-    carry = false; // reset
-    ++indices_[order - i]; // increment index
-
-    // if within tensor_order, should update address as well
-    if (i < tensor_order && 
-        this->elements_->getDimension(tensor_order - i) != 1) { 
-      // if dim is 1, index is either 0, or is broadcasted
-      this->index_address_ += indices_[order - i] * this->elements_->getDimension(tensor_order - i);
-      jump_size *= this->elements_->getDimension(tensor_order)
-    }
-
-    // check for carry over
-    if (indices_[order - i] >= kBroadcastShape[order - i]) {
-      indices_[order - i] = 0;
-      carry = true;
-       ++i;
-      continue; // carry over
-    } else {
-      ++i; // has to increment before breaking
-      break;
-    }
-  }
+  // Increment from last axis, carrying over when axis is full
+  for (int axis = indices_.size() - 1; axis >= 0; --axis) {
+    ++indices_[axis];
+    this->index_address_ += strides_[axis];
 
-  // success is determined by if final index is carried over or not
-  if (!carry) {
-    // because vector index may have broekn before traversing full idx, must finish
-    while (i < tensor_order) {
-      // if dim is 1, index is either 0, or is broadcasted
-      this->index_address_ += indices_[order - i] * this->elements_->getDimension(tensor_order - i);
-      jump_size *= this->elements_->getDimension(tensor_order);
-      ++i;
+    if (indices_[axis] < kBroadcastShape[axis]) {
+      return 1; // no carry, success
     }
 
-    return 1;
+    // carry over
+    this->index_address_ -= strides_[axis] * kBroadcastShape[axis];
+    indices_[axis] = 0;
   }
 
-  this->index_address_ = 0; // if incrementation is not successful, reset index to 0 anyway
+  // Every axis carried over, meaning index is back at 0
+  this->index_address_ = 0;
   return 0;
 }
 // End of Iteration ---------------------------------------------
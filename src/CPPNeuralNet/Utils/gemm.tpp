@@ -0,0 +1,438 @@
+#include "CPPNeuralNet/Utils/gemm.h"
+#include "CPPNeuralNet/Utils/allocator.h"
+#include "CPPNeuralNet/Utils/utils.h"
+#include "CPPNeuralNet/Utils/strassen.h"
+
+#include <algorithm>
+#include <type_traits>
+
+namespace cpp_nn {
+namespace util {
+
+// Packing -------------------------------------------------------------
+/** Pack A
+ *  Copies [mc x kc] block of A into micro-panels of kGemmMR rows.
+ *  Within a panel, elements are column-major so that micro-kernel reads them in order.
+ *  Rows beyond mc are padded with 0.
+ *  S is A's storage type, T that of the panel. 16-bit storage is widened here, once per element.
+ */
+template<typename S, typename T>
+void GemmPackA(int mc, int kc, const S* A, int row_stride, int col_stride, T* packed) {
+  for (int i = 0; i < mc; i += kGemmMR) {
+    const int mr = std::min(kGemmMR, mc - i);
+    for (int k = 0; k < kc; ++k) {
+      for (int ii = 0; ii < kGemmMR; ++ii) {
+        *packed++ = ii < mr ? static_cast<T>(A[(i + ii) * row_stride + k * col_stride]) : T(0);
+      }
+    }
+  }
+}
+/** Pack B
+ *  Copies [kc x nc] block of B into micro-panels of kGemmNR cols, row-major within panel.
+ *  Cols beyond nc are padded with 0.
+ *  S is B's storage type, T that of the panel.
+ */
+template<typename S, typename T>
+void GemmPackB(int kc, int nc, const S* B, int row_stride, int col_stride, T* packed) {
+  for (int j = 0; j < nc; j += kGemmNR) {
+    const int nr = std::min(kGemmNR, nc - j);
+    for (int k = 0; k < kc; ++k) {
+      if (nr == kGemmNR && col_stride == 1) {
+        // Full contiguous row of panel, widened by vector conversion for 16-bit storage
+        ConvertElements(B + k * row_stride + j, packed, kGemmNR);
+        packed += kGemmNR;
+        continue;
+      }
+      for (int jj = 0; jj < kGemmNR; ++jj) {
+        *packed++ = jj < nr ? static_cast<T>(B[k * row_stride + (j + jj) * col_stride]) : T(0);
+      }
+    }
+  }
+}
+// End of Packing ------------------------------------------------------
+
+// Micro Kernel --------------------------------------------------------
+/** Epilogue Finish
+ *  Bias, activation and residual of element [r][c] of C, applied once full K is accumulated.
+ *  Computed in value's type V, ie) accumulator type.
+ */
+template<typename T, typename V>
+inline V GemmFinish(const GemmEpilogue<T>& epilogue, V value, int r, int c) {
+  if (epilogue.bias != nullptr) {
+    value += static_cast<V>(epilogue.bias_axis == BiasAxis::kRow ? epilogue.bias[c] : epilogue.bias[r]);
+  }
+  value = ApplyActivation(epilogue.activation, value);
+  if (epilogue.residual != nullptr) {
+    value += static_cast<V>(epilogue.residual[r * epilogue.residual_ld + c]);
+  }
+  return value;
+}
+/** Micro Kernel
+ *  Multiplies packed [kGemmMR x kc] and [kc x kGemmNR] panels, keeping the tile in local accumulators.
+ *  Tile is then written into C at [row][col], of which only [mr x nr] is valid.
+ *  Accumulators are of panel type T, and C of type O, into which each element is narrowed once at writeback.
+ *    O differs from T only when one panel covers all of K, see GemmBlocked.
+ *
+ *  first_k: this is first panel along K, so C's previous content is scaled by beta rather than accumulated
+ *  last_k:  this is last panel along K, so the epilogue is finished
+ */
+template<typename T, typename O>
+void GemmMicroKernel(int kc, const T* packed_a, const T* packed_b,
+                     O* C, int ldc, int row, int col, int mr, int nr,
+                     const GemmEpilogue<O>& epilogue, bool first_k, bool last_k) {
+  T acc[kGemmMR][kGemmNR] = {};
+
+  for (int k = 0; k < kc; ++k) {
+    const T* a = packed_a + k * kGemmMR;
+    const T* b = packed_b + k * kGemmNR;
+    for (int i = 0; i < kGemmMR; ++i) {
+      const T a_i = a[i];
+      for (int j = 0; j < kGemmNR; ++j) {
+        acc[i][j] += a_i * b[j];
+      }
+    }
+  }
+
+  // Writeback, with epilogue while tile is still local
+  const T alpha = static_cast<T>(epilogue.alpha);
+  const T beta = static_cast<T>(epilogue.beta);
+  for (int i = 0; i < mr; ++i) {
+    O* c_row = C + (row + i) * ldc + col;
+    for (int j = 0; j < nr; ++j) {
+      T value = alpha * acc[i][j];
+      if (!first_k) {
+        value += static_cast<T>(c_row[j]);
+      } else if (beta != T(0)) {
+        value += beta * static_cast<T>(c_row[j]);
+      }
+      c_row[j] = NarrowAccumulator<O>(last_k ? GemmFinish(epilogue, value, row + i, col + j) : value);
+    }
+  }
+}
+/** Macro Kernel
+ *  Multiplies all of A's rows, at depth [pc, pc + kc), with packed [kc x nc] panel of B.
+ *  Row blocks of A are packed and split among threads when the product is large enough.
+ *  A is stored as S, panels are in accumulator type T, and C and epilogue in O, see GemmMicroKernel.
+ */
+template<typename S, typename T, typename O>
+void GemmMacroKernel(int M, int nc, int kc, const S* A, int a_row_stride, int a_col_stride,
+                     const T* packed_b, O* C, int ldc, int jc,
+                     const GemmEpilogue<O>& epilogue, bool first_k, bool last_k) {
+  const int num_row_blocks = (M + kGemmMC - 1) / kGemmMC;
+  const long long work = static_cast<long long>(M) * nc * kc;
+  const int grain = work < (1LL << 20) ? num_row_blocks : 1;
+
+  ParallelChunks(num_row_blocks, [&](int block_begin, int block_end) {
+    ScratchBuffer<T> packed_a(((kGemmMC + kGemmMR - 1) / kGemmMR) * kGemmMR * kc);
+
+    for (int block = block_begin; block < block_end; ++block) {
+      const int ic = block * kGemmMC;
+      const int mc = std::min(kGemmMC, M - ic);
+      GemmPackA(mc, kc, A + ic * a_row_stride, a_row_stride, a_col_stride, packed_a.data());
+
+      for (int jr = 0; jr < nc; jr += kGemmNR) {
+        for (int ir = 0; ir < mc; ir += kGemmMR) {
+          GemmMicroKernel(kc, packed_a.data() + ir * kc, packed_b + jr * kc,
+                          C, ldc, ic + ir, jc + jr,
+                          std::min(kGemmMR, mc - ir), std::min(kGemmNR, nc - jr),
+                          epilogue, first_k, last_k);
+        }
+      }
+    }
+  }, grain);
+}
+// End of Micro Kernel -------------------------------------------------
+
+// Gemm ----------------------------------------------------------------
+/** Blocked Multiplcation
+ *  Loops over [kc x nc] panels of B, as given by panel_b(pc, jc, kc, nc), 
+ *    and runs macro kernel of every panel against all of A.
+ *  When T is stored narrower than it is accumulated in:
+ *  - K within one panel: the whole sum is in the micro-kernel's accumulators,
+ *      so the epilogue is finished and narrowed into C there, in the same single writeback.
+ *  - Longer K: partial sums over K panels would be rounded to T at every panel.
+ *      They are instead kept in an Acc scratch of C, see ScratchBuffer,
+ *      and beta, bias, activation and residual are applied in the one pass that narrows it.
+ */
+template<typename Acc, typename T, typename PanelB>
+void GemmBlocked(int M, int N, int K, const T* A, int a_row_stride, int a_col_stride,
+                 PanelB panel_b, T* C, int ldc, const GemmEpilogue<T>& epilogue) {
+  if (std::is_same<T, Acc>::value || K <= kGemmKC) {
+    for (int jc = 0; jc < N; jc += kGemmNC) {
+      const int nc = std::min(kGemmNC, N - jc);
+      for (int pc = 0; pc < K; pc += kGemmKC) {
+        const int kc = std::min(kGemmKC, K - pc);
+        GemmMacroKernel(M, nc, kc, A + pc * a_col_stride, a_row_stride, a_col_stride,
+                        panel_b(pc, jc, kc, nc), C, ldc, jc, epilogue, pc == 0, pc + kc >= K);
+      }
+    }
+  } else {
+    ScratchBuffer<Acc> widened(static_cast<size_t>(M) * N);
+    GemmEpilogue<Acc> partial;
+    partial.alpha = static_cast<Acc>(epilogue.alpha);
+
+    for (int jc = 0; jc < N; jc += kGemmNC) {
+      const int nc = std::min(kGemmNC, N - jc);
+      for (int pc = 0; pc < K; pc += kGemmKC) {
+        const int kc = std::min(kGemmKC, K - pc);
+        GemmMacroKernel(M, nc, kc, A + pc * a_col_stride, a_row_stride, a_col_stride,
+                        panel_b(pc, jc, kc, nc), widened.data(), N, jc, partial, pc == 0, pc + kc >= K);
+      }
+    }
+
+    const Acc beta = static_cast<Acc>(epilogue.beta);
+    ParallelChunks(M, [&](int begin, int end) {
+      for (int r = begin; r < end; ++r) {
+        for (int c = 0; c < N; ++c) {
+          Acc value = widened.data()[static_cast<size_t>(r) * N + c];
+          if (beta != Acc(0)) value += beta * static_cast<Acc>(C[r * ldc + c]);
+          C[r * ldc + c] = NarrowAccumulator<T>(GemmFinish(epilogue, value, r, c));
+        }
+      }
+    }, std::max(1, kParallelGrainSize / std::max(N, 1)));
+  }
+}
+/** General Matrix Multiplcation */
+template<typename T, typename Acc>
+void Gemm(int M, int N, int K,
+          const T* A, int a_row_stride, int a_col_stride,
+          const T* B, int b_row_stride, int b_col_stride,
+          T* C, int ldc,
+          const GemmEpilogue<T>& epilogue /*= GemmEpilogue<T>()*/) {
+  if (M <= 0 || N <= 0) return;
+
+  // Vector-shaped dispatch
+  if (K > 0) {
+    if (M == 1 && N == 1) {
+      Acc value = static_cast<Acc>(epilogue.alpha) * GemmDot<T, Acc>(K, A, a_col_stride, B, b_row_stride);
+      if (epilogue.beta != T(0)) value += static_cast<Acc>(epilogue.beta) * static_cast<Acc>(C[0]);
+      C[0] = NarrowAccumulator<T>(GemmFinish(epilogue, value, 0, 0));
+      return;
+    }
+    if (N == 1) {
+      GemmMatrixVector<T, Acc>(M, K, A, a_row_stride, a_col_stride, B, b_row_stride, C, ldc, epilogue);
+      return;
+    }
+    if (M == 1) {
+      GemmVectorMatrix<T, Acc>(N, K, A, a_col_stride, B, b_row_stride, b_col_stride, C, epilogue);
+      return;
+    }
+    if (K == 1) {
+      GemmOuter<T, Acc>(M, N, A, a_row_stride, B, b_col_stride, C, ldc, epilogue);
+      return;
+    }
+  }
+
+  if (K <= 0) {
+    // Empty product, only epilogue remains
+    for (int r = 0; r < M; ++r) {
+      for (int c = 0; c < N; ++c) {
+        Acc value = epilogue.beta != T(0) ? static_cast<Acc>(epilogue.beta) * static_cast<Acc>(C[r * ldc + c]) : Acc(0);
+        C[r * ldc + c] = NarrowAccumulator<T>(GemmFinish(epilogue, value, r, c));
+      }
+    }
+    return;
+  }
+
+  // Opt-in Strassen for very large row-major products.
+  //  C's previous content is overwritten by recursion, so beta must be 0.
+  //  Its quadrant sums are stored in T, so only when T is accumulated in T.
+  if constexpr (std::is_same<T, Acc>::value) {
+    const int strassen_cutoff = getStrassenCutoff();
+    if (strassen_cutoff > 0 && std::min({M, N, K}) > 2 * strassen_cutoff &&
+        a_col_stride == 1 && b_col_stride == 1 && epilogue.beta == T(0)) {
+      thread_local StrassenWorkspace<T> workspace;
+      StrassenGemm(M, N, K, A, a_row_stride, B, b_row_stride, C, ldc, strassen_cutoff, workspace);
+
+      // Epilogue takes one more pass, negligible next to the product at these sizes
+      if (epilogue.alpha != T(1) || epilogue.bias != nullptr || 
+          epilogue.activation != Activation::kNone || epilogue.residual != nullptr) {
+        ParallelChunks(M, [&](int begin, int end) {
+          for (int r = begin; r < end; ++r) {
+            for (int c = 0; c < N; ++c) {
+              C[r * ldc + c] = GemmFinish(epilogue, epilogue.alpha * C[r * ldc + c], r, c);
+            }
+          }
+        }, 1);
+      }
+      return;
+    }
+  }
+
+  // B panel is packed once, shared by every row block
+  ScratchBuffer<Acc> packed_b(((std::min(N, kGemmNC) + kGemmNR - 1) / kGemmNR) * kGemmNR * kGemmKC);
+  GemmBlocked<Acc>(M, N, K, A, a_row_stride, a_col_stride, [&](int pc, int jc, int kc, int nc) {
+    GemmPackB(kc, nc, B + pc * b_row_stride + jc * b_col_stride, b_row_stride, b_col_stride, packed_b.data());
+    return static_cast<const Acc*>(packed_b.data());
+  }, C, ldc, epilogue);
+}
+// End of Gemm ---------------------------------------------------------
+
+// Packed B ------------------------------------------------------------
+/** Packs B */
+template<typename T, typename Acc>
+void GemmPackedB<T, Acc>::Pack(int K, int N, const T* B, int b_row_stride, int b_col_stride) {
+  K_ = K;
+  N_ = N;
+  // Every column block but last is of kGemmNC, which is a multiple of kGemmNR
+  const int padded_cols = ((N + kGemmNR - 1) / kGemmNR) * kGemmNR;
+  panels_.resize(static_cast<size_t>(padded_cols) * K);
+
+  for (int jc = 0; jc < N; jc += kGemmNC) {
+    const int nc = std::min(kGemmNC, N - jc);
+    for (int pc = 0; pc < K; pc += kGemmKC) {
+      const int kc = std::min(kGemmKC, K - pc);
+      GemmPackB(kc, nc, B + pc * b_row_stride + jc * b_col_stride, b_row_stride, b_col_stride, 
+                panels_.data() + (getPanel(pc, jc) - panels_.data()));
+    }
+  }
+}
+/** Panel of [kc x nc] block starting at [pc][jc] */
+template<typename T, typename Acc>
+const Acc* GemmPackedB<T, Acc>::getPanel(int pc, int jc) const {
+  // Column block at jc spans jc * K elements before it, 
+  //  within which panels are stacked by depth, each padded_nc wide
+  const int nc = std::min(kGemmNC, N_ - jc);
+  const int padded_nc = ((nc + kGemmNR - 1) / kGemmNR) * kGemmNR;
+  return panels_.data() + static_cast<size_t>(jc) * K_ + static_cast<size_t>(pc) * padded_nc;
+}
+/** Matrix Multiplcation with Prepacked B */
+template<typename T, typename Acc>
+void GemmPacked(int M, const T* A, int a_row_stride, int a_col_stride,
+                const GemmPackedB<T, Acc>& B, T* C, int ldc,
+                const GemmEpilogue<T>& epilogue /*= GemmEpilogue<T>()*/) {
+  const int N = B.getCols();
+  const int K = B.getRows();
+  if (M <= 0 || N <= 0) return;
+  if (K <= 0) {
+    Gemm<T, Acc>(M, N, K, A, a_row_stride, a_col_stride, static_cast<const T*>(nullptr), 0, 0, C, ldc, epilogue);
+    return;
+  }
+
+  GemmBlocked<Acc>(M, N, K, A, a_row_stride, a_col_stride, [&](int pc, int jc, int, int) {
+    return B.getPanel(pc, jc);
+  }, C, ldc, epilogue);
+}
+// End of Packed B -----------------------------------------------------
+
+// Vector Kernels ------------------------------------------------------
+/** Dot Product */
+template<typename T, typename Acc>
+Acc GemmDot(int K, const T* x, int x_stride, const T* y, int y_stride) {
+  // Independent accumulators break the dependency chain so that the loop vectorizes
+  Acc acc[kGemmNR] = {};
+  int k = 0;
+  if (x_stride == 1 && y_stride == 1) {
+    for (; k + kGemmNR <= K; k += kGemmNR) {
+      for (int j = 0; j < kGemmNR; ++j) {
+        acc[j] += static_cast<Acc>(x[k + j]) * static_cast<Acc>(y[k + j]);
+      }
+    }
+  }
+  for (; k < K; ++k) {
+    acc[0] += static_cast<Acc>(x[k * x_stride]) * static_cast<Acc>(y[k * y_stride]);
+  }
+
+  Acc sum = Acc(0);
+  for (int j = 0; j < kGemmNR; ++j) {
+    sum += acc[j];
+  }
+  return sum;
+}
+/** Matrix-Vector Product */
+template<typename T, typename Acc>
+void GemmMatrixVector(int M, int K, const T* A, int a_row_stride, int a_col_stride,
+                      const T* x, int x_stride, T* C, int ldc, const GemmEpilogue<T>& epilogue) {
+  // Each row is streamed once, split among threads
+  const int grain = std::max(1, (1 << 16) / std::max(K, 1));
+
+  if (a_col_stride == 1 || a_row_stride != 1) {
+    // Rows of A are (mostly) contiguous: one dot product per row
+    ParallelChunks(M, [&](int begin, int end) {
+      for (int r = begin; r < end; ++r) {
+        Acc value = static_cast<Acc>(epilogue.alpha) * GemmDot<T, Acc>(K, A + r * a_row_stride, a_col_stride, x, x_stride);
+        if (epilogue.beta != T(0)) value += static_cast<Acc>(epilogue.beta) * static_cast<Acc>(C[r * ldc]);
+        C[r * ldc] = NarrowAccumulator<T>(GemmFinish(epilogue, value, r, 0));
+      }
+    }, grain);
+    return;
+  }
+
+  // Columns of A are contiguous (ie A is transposed): accumulate column by column
+  ParallelChunks(M, [&](int begin, int end) {
+    ScratchBuffer<Acc> lease(end - begin);
+    Acc* acc = lease.data();
+    std::fill(acc, acc + (end - begin), Acc(0));
+    for (int k = 0; k < K; ++k) {
+      const Acc x_k = static_cast<Acc>(x[k * x_stride]);
+      const T* a_col = A + k * a_col_stride + begin;
+      for (int r = 0; r < end - begin; ++r) {
+        acc[r] += static_cast<Acc>(a_col[r]) * x_k;
+      }
+    }
+    for (int r = begin; r < end; ++r) {
+      Acc value = static_cast<Acc>(epilogue.alpha) * acc[r - begin];
+      if (epilogue.beta != T(0)) value += static_cast<Acc>(epilogue.beta) * static_cast<Acc>(C[r * ldc]);
+      C[r * ldc] = NarrowAccumulator<T>(GemmFinish(epilogue, value, r, 0));
+    }
+  }, grain);
+}
+/** Vector-Matrix Product */
+template<typename T, typename Acc>
+void GemmVectorMatrix(int N, int K, const T* x, int x_stride,
+                      const T* B, int b_row_stride, int b_col_stride, T* C, const GemmEpilogue<T>& epilogue) {
+  const int grain = std::max(1, (1 << 16) / std::max(K, 1));
+
+  if (b_col_stride != 1 && b_row_stride == 1) {
+    // Columns of B are contiguous: one dot product per column
+    ParallelChunks(N, [&](int begin, int end) {
+      for (int c = begin; c < end; ++c) {
+        Acc value = static_cast<Acc>(epilogue.alpha) * GemmDot<T, Acc>(K, x, x_stride, B + c * b_col_stride, 1);
+        if (epilogue.beta != T(0)) value += static_cast<Acc>(epilogue.beta) * static_cast<Acc>(C[c]);
+        C[c] = NarrowAccumulator<T>(GemmFinish(epilogue, value, 0, c));
+      }
+    }, grain);
+    return;
+  }
+
+  // Rows of B are contiguous: scale and add row by row, so B is streamed once in order
+  ParallelChunks(N, [&](int begin, int end) {
+    ScratchBuffer<Acc> lease(end - begin);
+    Acc* acc = lease.data();
+    std::fill(acc, acc + (end - begin), Acc(0));
+    for (int k = 0; k < K; ++k) {
+      const Acc x_k = static_cast<Acc>(x[k * x_stride]);
+      const T* b_row = B + k * b_row_stride + begin * b_col_stride;
+      for (int c = 0; c < end - begin; ++c) {
+        acc[c] += x_k * static_cast<Acc>(b_row[c * b_col_stride]);
+      }
+    }
+    for (int c = begin; c < end; ++c) {
+      Acc value = static_cast<Acc>(epilogue.alpha) * acc[c - begin];
+      if (epilogue.beta != T(0)) value += static_cast<Acc>(epilogue.beta) * static_cast<Acc>(C[c]);
+      C[c] = NarrowAccumulator<T>(GemmFinish(epilogue, value, 0, c));
+    }
+  }, grain);
+}
+/** Outer Product, Rank-1 Update */
+template<typename T, typename Acc>
+void GemmOuter(int M, int N, const T* x, int x_stride, const T* y, int y_stride,
+               T* C, int ldc, const GemmEpilogue<T>& epilogue) {
+  const int grain = std::max(1, (1 << 16) / std::max(N, 1));
+
+  ParallelChunks(M, [&](int begin, int end) {
+    for (int r = begin; r < end; ++r) {
+      const Acc x_r = static_cast<Acc>(epilogue.alpha) * static_cast<Acc>(x[r * x_stride]);
+      T* c_row = C + r * ldc;
+      for (int c = 0; c < N; ++c) {
+        Acc value = x_r * static_cast<Acc>(y[c * y_stride]);
+        if (epilogue.beta != T(0)) value += static_cast<Acc>(epilogue.beta) * static_cast<Acc>(c_row[c]);
+        c_row[c] = NarrowAccumulator<T>(GemmFinish(epilogue, value, r, c));
+      }
+    }
+  }, grain);
+}
+// End of Vector Kernels -----------------------------------------------
+
+} // util
+} // cpp_nn
@@ -0,0 +1,109 @@
+#include "CPPNeuralNet/Utils/memory_planner.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+namespace cpp_nn {
+namespace util {
+
+MemoryPlan PlanMemory(const std::vector<BufferLifetime>& buffers, size_t alignment /*= 1*/) {
+  if (alignment == 0) alignment = 1;
+  const int num_buffers = buffers.size();
+  std::vector<size_t> sizes(num_buffers);
+  for (int i = 0; i < num_buffers; ++i) {
+    sizes[i] = (buffers[i].size + alignment - 1) / alignment * alignment;
+  }
+
+  // Buffers sharing storage form a group, placed as one and named by its first buffer
+  std::vector<int> group(num_buffers);
+  std::vector<std::vector<int>> members(num_buffers);
+  for (int i = 0; i < num_buffers; ++i) {
+    const BufferLifetime& buffer = buffers[i];
+    if (buffer.last < buffer.first) throw std::invalid_argument("PlanMemory- Invalid Lifetime");
+    group[i] = i;
+
+    const int owner = buffer.in_place_of;
+    if (owner >= 0) {
+      if (owner >= i || sizes[group[owner]] < sizes[i]) throw std::invalid_argument("PlanMemory- Invalid In-Place");
+      group[i] = group[owner];
+      for (const int& member : members[group[i]]) {
+        if (buffers[member].last > buffer.first) throw std::invalid_argument("PlanMemory- Invalid In-Place");
+      }
+    }
+    members[group[i]].push_back(i);
+  }
+  auto overlap = [&](int a, int b) {
+    for (const int& x : members[a]) {
+      for (const int& y : members[b]) {
+        if (buffers[x].first <= buffers[y].last && buffers[y].first <= buffers[x].last) return true;
+      }
+    }
+    return false;
+  };
+
+  // Largest first, then earliest, each at lowest offset free over its lifetime
+  std::vector<int> roots;
+  for (int i = 0; i < num_buffers; ++i) {
+    if (group[i] == i) roots.push_back(i);
+  }
+  std::sort(roots.begin(), roots.end(), [&](int a, int b) {
+    return sizes[a] != sizes[b] ? sizes[a] > sizes[b] : buffers[a].first < buffers[b].first;
+  });
+
+  MemoryPlan plan;
+  plan.offsets.assign(num_buffers, 0);
+  std::vector<int> placed;
+  std::vector<int> overlapping;
+  for (const int& root : roots) {
+    overlapping.clear();
+    for (const int& other : placed) {
+      if (overlap(root, other)) overlapping.push_back(other);
+    }
+    std::sort(overlapping.begin(), overlapping.end(), [&](int a, int b) {
+      return plan.offsets[a] < plan.offsets[b];
+    });
+
+    size_t offset = 0;
+    for (const int& other : overlapping) {
+      if (offset + sizes[root] <= plan.offsets[other]) break;
+      offset = std::max(offset, plan.offsets[other] + sizes[other]);
+    }
+    plan.offsets[root] = offset;
+    plan.arena_size = std::max(plan.arena_size, offset + sizes[root]);
+    placed.push_back(root);
+  }
+  for (int i = 0; i < num_buffers; ++i) {
+    plan.offsets[i] = plan.offsets[group[i]];
+  }
+
+  // Peak, by live groups at each step. Group members only meet at an in-place step, counted once
+  if (num_buffers > 0) {
+    int begin = buffers[0].first, end = buffers[0].last;
+    for (const BufferLifetime& buffer : buffers) {
+      begin = std::min(begin, buffer.first);
+      end = std::max(end, buffer.last);
+    }
+    std::vector<size_t> live(end - begin + 2, 0);
+    for (const int& root : roots) {
+      int previous_last = begin - 1;
+      for (const int& member : members[root]) { // In order of first step, as members never overlap
+        const int first = std::max(buffers[member].first, previous_last + 1);
+        if (first > buffers[member].last) continue;
+        live[first - begin] += sizes[root];
+        live[buffers[member].last - begin + 1] -= sizes[root];
+        previous_last = buffers[member].last;
+      }
+    }
+    size_t current = 0;
+    for (size_t step = 0; step + 1 < live.size(); ++step) {
+      current += live[step];
+      plan.peak_size = std::max(plan.peak_size, current);
+    }
+  }
+  plan.total_size = std::accumulate(sizes.begin(), sizes.end(), size_t(0));
+  return plan;
+}
+
+} // util
+} // cpp_nn
@@ -0,0 +1,64 @@
+#include "CPPNeuralNet/Utils/numeric_types.h"
+
+#if defined(__AVX2__) || defined(__F16C__) || defined(__AVX512BF16__)
+#include <immintrin.h>
+#endif
+
+namespace cpp_nn {
+namespace util {
+
+// Bulk Conversion -----------------------------------------------------
+void ConvertElements(const bf16* source, float* destination, size_t n) {
+  size_t i = 0;
+#if defined(__AVX2__)
+  // Widen to 32 bits and shift into upper half
+  for (; i + 8 <= n; i += 8) {
+    const __m128i half = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+    const __m256i bits = _mm256_slli_epi32(_mm256_cvtepu16_epi32(half), 16);
+    _mm256_storeu_ps(destination + i, _mm256_castsi256_ps(bits));
+  }
+#endif
+  for (; i < n; ++i) {
+    destination[i] = source[i];
+  }
+}
+void ConvertElements(const float* source, bf16* destination, size_t n) {
+  size_t i = 0;
+#if defined(__AVX512BF16__) && defined(__AVX512VL__)
+  for (; i + 16 <= n; i += 16) {
+    const __m256bh half = _mm512_cvtneps_pbh(_mm512_loadu_ps(source + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i), reinterpret_cast<const __m256i&>(half));
+  }
+#endif
+  for (; i < n; ++i) {
+    destination[i] = source[i];
+  }
+}
+void ConvertElements(const fp16* source, float* destination, size_t n) {
+  size_t i = 0;
+#if defined(__F16C__)
+  for (; i + 8 <= n; i += 8) {
+    const __m128i half = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+    _mm256_storeu_ps(destination + i, _mm256_cvtph_ps(half));
+  }
+#endif
+  for (; i < n; ++i) {
+    destination[i] = source[i];
+  }
+}
+void ConvertElements(const float* source, fp16* destination, size_t n) {
+  size_t i = 0;
+#if defined(__F16C__)
+  for (; i + 8 <= n; i += 8) {
+    const __m128i half = _mm256_cvtps_ph(_mm256_loadu_ps(source + i), _MM_FROUND_TO_NEAREST_INT);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), half);
+  }
+#endif
+  for (; i < n; ++i) {
+    destination[i] = source[i];
+  }
+}
+// End of Bulk Conversion ----------------------------------------------
+
+} // util
+} // cpp_nn
@@ -0,0 +1,152 @@
+#include "CPPNeuralNet/Utils/quantization.h"
+#include "CPPNeuralNet/Utils/utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#if defined(__AVX2__) || (defined(__AVX512VNNI__) && defined(__AVX512BW__))
+#include <immintrin.h>
+#endif
+
+namespace cpp_nn {
+namespace util {
+
+// QuantizedGemmWeight =============================================================
+QuantizedGemmWeight::QuantizedGemmWeight(const QuantizedTensor<int8_t>& weight) {
+  if (weight.getShape().size() != 2)
+    throw std::invalid_argument("QuantizedGemmWeight Constructor- Weight is not Matrix");
+  if (weight.getAxis() != -1 && weight.getAxis() != 1)
+    throw std::invalid_argument("QuantizedGemmWeight Constructor- Weight must be Per-Tensor or Per-Column");
+
+  K_ = weight.getShape()[0];
+  N_ = weight.getShape()[1];
+  columns_.resize(static_cast<size_t>(K_) * N_);
+  column_sums_.assign(N_, 0);
+  scales_.resize(N_);
+
+  const int8_t* values = weight.data();
+  for (int c = 0; c < N_; ++c) {
+    if (weight.getZeroPoint(c) != 0)
+      throw std::invalid_argument("QuantizedGemmWeight Constructor- Weight must be Symmetric");
+    scales_[c] = weight.getScale(c);
+
+    int8_t* column = columns_.data() + static_cast<size_t>(c) * K_;
+    for (int k = 0; k < K_; ++k) {
+      column[k] = values[k * N_ + c];
+      column_sums_[c] += column[k];
+    }
+  }
+}
+// End of QuantizedGemmWeight ======================================================
+
+// Int8 GEMM -----------------------------------------------------------
+/** Int8 Dot Product */
+int32_t QuantizedDot(int K, const uint8_t* a, const int8_t* w) {
+  int32_t sum = 0;
+  int k = 0;
+#if defined(__AVX512VNNI__) && defined(__AVX512BW__)
+  // vpdpbusd: u8 x s8 products, 4 at a time, summed straight into int32 lanes
+  __m512i acc = _mm512_setzero_si512();
+  for (; k + 64 <= K; k += 64) {
+    acc = _mm512_dpbusd_epi32(acc, _mm512_loadu_si512(a + k), _mm512_loadu_si512(w + k));
+  }
+  sum += _mm512_reduce_add_epi32(acc);
+#elif defined(__AVX2__)
+  // Widen to int16 and use vpmaddwd, as vpmaddubsw would saturate 255 * 127 * 2 in int16
+  __m256i acc = _mm256_setzero_si256();
+  for (; k + 16 <= K; k += 16) {
+    const __m256i a16 = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + k)));
+    const __m256i w16 = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(w + k)));
+    acc = _mm256_add_epi32(acc, _mm256_madd_epi16(a16, w16));
+  }
+  __m128i half = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+  half = _mm_hadd_epi32(half, half);
+  half = _mm_hadd_epi32(half, half);
+  sum += _mm_cvtsi128_si32(half);
+#endif
+  for (; k < K; ++k) {
+    sum += static_cast<int32_t>(a[k]) * static_cast<int32_t>(w[k]);
+  }
+  return sum;
+}
+
+namespace {
+/** Runs every output's int32 accumulator, zero point corrected, through store(r, c, acc).
+ *  Rows are split among threads. */
+template<typename Store>
+void QuantizedGemmDriver(int M, const uint8_t* A, int lda, int a_zero_point,
+                         const QuantizedGemmWeight& W, Store store) {
+  const int K = W.getRows();
+  const int N = W.getCols();
+  const int grain = std::max(1, (1 << 18) / std::max(N * K, 1));
+
+  ParallelChunks(M, [&](int begin, int end) {
+    for (int r = begin; r < end; ++r) {
+      const uint8_t* a_row = A + static_cast<size_t>(r) * lda;
+      for (int c = 0; c < N; ++c) {
+        const int32_t acc = QuantizedDot(K, a_row, W.getColumn(c)) - a_zero_point * W.getColumnSum(c);
+        store(r, c, acc);
+      }
+    }
+  }, grain);
+}
+/** Real value of accumulator through epilogue, before output quantization */
+inline float Requantize(const RequantizeEpilogue& epilogue, float a_scale, const QuantizedGemmWeight& W,
+                        int c, int32_t acc) {
+  float real = a_scale * W.getScale(c) * static_cast<float>(acc);
+  if (epilogue.bias != nullptr) real += epilogue.bias[c];
+  return ApplyActivation(epilogue.activation, real);
+}
+} // namespace
+
+/** Int8 GEMM, int32 result */
+void QuantizedGemm(int M, const uint8_t* A, int lda, int a_zero_point,
+                   const QuantizedGemmWeight& W, int32_t* C, int ldc) {
+  QuantizedGemmDriver(M, A, lda, a_zero_point, W, [&](int r, int c, int32_t acc) {
+    C[static_cast<size_t>(r) * ldc + c] = acc;
+  });
+}
+/** Int8 GEMM, float result */
+void QuantizedGemm(int M, const uint8_t* A, int lda, int a_zero_point, float a_scale,
+                   const QuantizedGemmWeight& W, float* C, int ldc, const RequantizeEpilogue& epilogue) {
+  QuantizedGemmDriver(M, A, lda, a_zero_point, W, [&](int r, int c, int32_t acc) {
+    C[static_cast<size_t>(r) * ldc + c] = Requantize(epilogue, a_scale, W, c, acc);
+  });
+}
+/** Int8 GEMM, uint8 result */
+void QuantizedGemm(int M, const uint8_t* A, int lda, int a_zero_point, float a_scale,
+                   const QuantizedGemmWeight& W, uint8_t* C, int ldc, const RequantizeEpilogue& epilogue) {
+  const float inverse_scale = 1.0f / epilogue.output_scale;
+  QuantizedGemmDriver(M, A, lda, a_zero_point, W, [&](int r, int c, int32_t acc) {
+    const float real = Requantize(epilogue, a_scale, W, c, acc);
+    const long q = std::lround(real * inverse_scale) + epilogue.output_zero_point;
+    C[static_cast<size_t>(r) * ldc + c] = static_cast<uint8_t>(std::clamp<long>(q, 0, 255));
+  });
+}
+/** Quantized Matmul */
+Tensor<float> QuantizedMatmul(const QuantizedTensor<uint8_t>& input, const QuantizedGemmWeight& weight,
+                              const RequantizeEpilogue& epilogue /*= RequantizeEpilogue()*/) {
+  std::vector<int> dims = input.getShape();
+  if (dims.size() < 2)
+    throw std::invalid_argument("QuantizedMatmul- Tensor is not Matrix");
+  if (dims.back() != weight.getRows())
+    throw std::invalid_argument("QuantizedMatmul- Multiplcation Dimension Mismatch");
+  if (input.getAxis() != -1)
+    throw std::invalid_argument("QuantizedMatmul- Input must be Per-Tensor");
+
+  // Leading axes and rows are stacked into one [rows x K] matrix
+  const int K = dims.back();
+  const int rows = K > 0 ? input.getCapacity() / K : 0;
+  dims.back() = weight.getCols();
+  Tensor<float> res(dims);
+
+  QuantizedGemm(rows, input.data(), K, input.getZeroPoint(), input.getScale(),
+                weight, res.data(), weight.getCols(), epilogue);
+
+  return res;
+}
+// End of Int8 GEMM ----------------------------------------------------
+
+} // util
+} // cpp_nn
@@ -0,0 +1,124 @@
+#include "CPPNeuralNet/Utils/quantization.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace cpp_nn {
+namespace util {
+
+// QuantizedTensor =================================================================
+// Constructor ---------------------------------------------------------
+template<typename Q>
+QuantizedTensor<Q>::QuantizedTensor(const std::vector<int>& dims, const std::vector<float>& scales,
+                                    const std::vector<int>& zero_points, int axis /*= -1*/)
+    : dimensions_(dims), scales_(scales), zero_points_(zero_points), axis_(axis), channel_block_(1) {
+  int capacity = 1;
+  for (const int& dim : dims) {
+    if (dim < 0)
+      throw std::invalid_argument("QuantizedTensor Constructor- Non-Positive Dimension Error");
+    capacity *= dim;
+  }
+  if (axis_ >= static_cast<int>(dims.size()))
+    throw std::invalid_argument("QuantizedTensor Constructor- Channel Axis Out of Bounds");
+
+  const int channels = axis_ < 0 ? 1 : dims[axis_];
+  for (int i = axis_ + 1; axis_ >= 0 && i < static_cast<int>(dims.size()); ++i) {
+    channel_block_ *= dims[i];
+  }
+  if (static_cast<int>(scales_.size()) != channels || static_cast<int>(zero_points_.size()) != channels)
+    throw std::invalid_argument("QuantizedTensor Constructor- Parameter Count Mismatch");
+  for (const int& zero_point : zero_points_) {
+    if (zero_point < std::numeric_limits<Q>::min() || zero_point > std::numeric_limits<Q>::max())
+      throw std::invalid_argument("QuantizedTensor Constructor- Zero Point Out of Range");
+  }
+
+  elements_.resize(capacity);
+  for (int i = 0; i < capacity; ++i) {
+    elements_[i] = static_cast<Q>(zero_points_[ChannelOf(i)]);
+  }
+}
+// End of Constructor --------------------------------------------------
+
+// Conversion ----------------------------------------------------------
+/** Quantize, choosing parameters from range */
+template<typename Q>
+template<typename T>
+QuantizedTensor<Q> QuantizedTensor<Q>::Quantize(const Tensor<T>& tensor, int axis /*= -1*/) {
+  const std::vector<int> dims = tensor.getShape();
+  const int channels = axis < 0 ? 1 : dims.at(axis);
+
+  // Range of each channel, always including 0 so that it is exactly representable
+  std::vector<float> low(channels, 0.0f), high(channels, 0.0f);
+  QuantizedTensor<Q> layout(dims, std::vector<float>(channels, 1.0f), std::vector<int>(channels, 0), axis);
+  const T* values = tensor.data();
+  for (int i = 0; i < tensor.getCapacity(); ++i) {
+    const int channel = layout.ChannelOf(i);
+    low[channel] = std::min(low[channel], static_cast<float>(values[i]));
+    high[channel] = std::max(high[channel], static_cast<float>(values[i]));
+  }
+
+  constexpr int q_min = std::numeric_limits<Q>::min();
+  constexpr int q_max = std::numeric_limits<Q>::max();
+  std::vector<float> scales(channels);
+  std::vector<int> zero_points(channels);
+  for (int c = 0; c < channels; ++c) {
+    if (std::numeric_limits<Q>::is_signed) {
+      // Symmetric, zero point stays 0
+      const float bound = std::max(std::abs(low[c]), std::abs(high[c]));
+      scales[c] = bound > 0.0f ? bound / q_max : 1.0f;
+      zero_points[c] = 0;
+    } else {
+      scales[c] = high[c] > low[c] ? (high[c] - low[c]) / (q_max - q_min) : 1.0f;
+      zero_points[c] = std::clamp(static_cast<int>(std::lround(q_min - low[c] / scales[c])), q_min, q_max);
+    }
+  }
+
+  return Quantize(tensor, scales, zero_points, axis);
+}
+/** Quantize with given parameters */
+template<typename Q>
+template<typename T>
+QuantizedTensor<Q> QuantizedTensor<Q>::Quantize(const Tensor<T>& tensor, const std::vector<float>& scales,
+                                                const std::vector<int>& zero_points, int axis /*= -1*/) {
+  QuantizedTensor<Q> res(tensor.getShape(), scales, zero_points, axis);
+
+  constexpr int q_min = std::numeric_limits<Q>::min();
+  constexpr int q_max = std::numeric_limits<Q>::max();
+  const T* values = tensor.data();
+  for (int i = 0; i < tensor.getCapacity(); ++i) {
+    const int channel = res.ChannelOf(i);
+    const long q = std::lround(static_cast<float>(values[i]) / res.scales_[channel]) + res.zero_points_[channel];
+    res.elements_[i] = static_cast<Q>(std::clamp<long>(q, q_min, q_max));
+  }
+
+  return res;
+}
+/** Dequantize */
+template<typename Q>
+template<typename T>
+Tensor<T> QuantizedTensor<Q>::Dequantize() const {
+  Tensor<T> res(dimensions_);
+
+  T* values = res.data();
+  for (int i = 0; i < getCapacity(); ++i) {
+    const int channel = ChannelOf(i);
+    values[i] = static_cast<T>(scales_[channel] * (static_cast<int>(elements_[i]) - zero_points_[channel]));
+  }
+
+  return res;
+}
+// End of Conversion ---------------------------------------------------
+
+// Housekeeping --------------------------------------------------------
+template<typename Q>
+int QuantizedTensor<Q>::ChannelOf(int address) const {
+  if (axis_ < 0) return 0;
+  return (address / channel_block_) % dimensions_[axis_];
+}
+// End of Housekeeping -------------------------------------------------
+// End of QuantizedTensor ==========================================================
+
+} // util
+} // cpp_nn
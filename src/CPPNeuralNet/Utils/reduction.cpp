@@ -0,0 +1,26 @@
+#include "CPPNeuralNet/Utils/reduction.h"
+
+#include <atomic>
+#include <cstdlib>
+
+namespace cpp_nn {
+namespace util {
+
+namespace {
+bool DefaultDeterministic() {
+  const char* env = std::getenv("CPP_NN_DETERMINISTIC");
+  return env != nullptr && std::atoi(env) > 0;
+}
+
+std::atomic<bool> deterministic_reductions(DefaultDeterministic());
+} // namespace
+
+void SetDeterministicReductions(bool deterministic) {
+  deterministic_reductions.store(deterministic);
+}
+bool getDeterministicReductions() {
+  return deterministic_reductions.load();
+}
+
+} // util
+} // cpp_nn
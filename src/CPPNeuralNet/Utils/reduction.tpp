@@ -0,0 +1,97 @@
+#include "CPPNeuralNet/Utils/reduction.h"
+#include "CPPNeuralNet/Utils/allocator.h"
+#include "CPPNeuralNet/Utils/utils.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace cpp_nn {
+namespace util {
+
+/** Contiguous Fold
+ *  Folds n contiguous elements into kLanes interleaved partials, then pairs them up.
+ *  Lanes are independent, so the loop vectorizes, and their order is fixed by n alone.
+ */
+template<typename Acc, typename T, typename CombineOp>
+inline Acc ReduceContiguous(const T* x, int n, Acc identity, CombineOp combine) {
+  constexpr int kLanes = 8;
+  Acc lanes[kLanes];
+  std::fill(lanes, lanes + kLanes, identity);
+
+  int k = 0;
+  for (; k + kLanes <= n; k += kLanes) {
+    for (int j = 0; j < kLanes; ++j) {
+      lanes[j] = combine(lanes[j], static_cast<Acc>(x[k + j]));
+    }
+  }
+  for (int j = 0; k < n; ++k, ++j) {
+    lanes[j] = combine(lanes[j], static_cast<Acc>(x[k]));
+  }
+  for (int width = kLanes / 2; width > 0; width /= 2) {
+    for (int j = 0; j < width; ++j) {
+      lanes[j] = combine(lanes[j], lanes[j + width]);
+    }
+  }
+  return lanes[0];
+}
+
+/** Parallel Axis Reduction */
+template<typename Acc, typename T, typename CombineOp>
+void ParallelReduceAxis(const T* data, int outer, int length, int inner,
+                        Acc identity, CombineOp combine, Acc* result) {
+  if (outer <= 0 || inner <= 0) return;
+  if (length <= 0) {
+    std::fill(result, result + outer * inner, identity);
+    return;
+  }
+
+  int leaf = kReductionLeaf;
+  if (!getDeterministicReductions()) {
+    const int threads = getNumThreads();
+    leaf = std::max(kReductionLeaf, (length + threads - 1) / threads);
+  }
+  const int leaves = (length + leaf - 1) / leaf;
+  const int units = outer * leaves;
+
+  // Leaf u = (o, f) folds rows [f * leaf, ...) of outer block o into partials[u * inner, (u + 1) * inner)
+  ScratchBuffer<Acc> partials(static_cast<size_t>(units) * inner);
+  const long long unit_work = static_cast<long long>(std::min(leaf, length)) * inner;
+  ParallelFor(0, units, [&](int begin, int end) {
+    for (int u = begin; u < end; ++u) {
+      const int o = u / leaves;
+      const int row_begin = (u % leaves) * leaf;
+      const int rows = std::min(length, row_begin + leaf) - row_begin;
+      const T* block = data + (static_cast<size_t>(o) * length + row_begin) * inner;
+      Acc* partial = partials.data() + static_cast<size_t>(u) * inner;
+
+      if (inner == 1) {
+        partial[0] = ReduceContiguous(block, rows, identity, combine);
+        continue;
+      }
+      std::fill(partial, partial + inner, identity);
+      for (int l = 0; l < rows; ++l) {
+        const T* row = block + static_cast<size_t>(l) * inner;
+        for (int i = 0; i < inner; ++i) {
+          partial[i] = combine(partial[i], static_cast<Acc>(row[i]));
+        }
+      }
+    }
+  }, std::max(1LL, kParallelGrainSize / std::max(unit_work, 1LL)));
+
+  // Pairwise tree over leaves of each output, shaped by leaf count only
+  ParallelFor(0, outer * inner, [&](int begin, int end) {
+    for (int c = begin; c < end; ++c) {
+      Acc* base = partials.data() + static_cast<size_t>(c / inner) * leaves * inner + c % inner;
+      for (int stride = 1; stride < leaves; stride *= 2) {
+        for (int f = 0; f + stride < leaves; f += 2 * stride) {
+          base[static_cast<size_t>(f) * inner] = combine(base[static_cast<size_t>(f) * inner],
+                                                         base[static_cast<size_t>(f + stride) * inner]);
+        }
+      }
+      result[c] = base[0];
+    }
+  }, std::max(1, kParallelGrainSize / std::max(leaves, 1)));
+}
+
+} // util
+} // cpp_nn
@@ -0,0 +1,343 @@
+#include "CPPNeuralNet/Utils/sparse_tensor.h"
+#include "CPPNeuralNet/Utils/utils.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <cmath>
+
+namespace cpp_nn {
+namespace util {
+
+// CooTensor =======================================================================
+// Constructors --------------------------------------------------------
+template<typename T>
+CooTensor<T>::CooTensor(const std::vector<int>& dims) : dimensions_(dims) {
+  for (const int& dim : dims) {
+    if (dim < 0)
+      throw std::invalid_argument("CooTensor Constructor- Non-Positive Dimension Error");
+  }
+}
+/** From Dense */
+template<typename T>
+CooTensor<T> CooTensor<T>::FromDense(const Tensor<T>& tensor, T threshold /*= T(0)*/) {
+  CooTensor<T> res(tensor.getShape());
+  const int order = res.getOrder();
+  const T* values = tensor.data();
+
+  // Storage is row-major in shape's order, so entries come out sorted
+  std::vector<int> indices(order, 0);
+  for (int address = 0; address < tensor.getCapacity(); ++address) {
+    if (std::abs(values[address]) > threshold) {
+      res.indices_.insert(res.indices_.end(), indices.begin(), indices.end());
+      res.values_.push_back(values[address]);
+    }
+    for (int axis = order - 1; axis >= 0; --axis) {
+      if (++indices[axis] < res.dimensions_[axis]) break;
+      indices[axis] = 0;
+    }
+  }
+  return res;
+}
+// End of Constructors -------------------------------------------------
+
+// Modifiers -----------------------------------------------------------
+template<typename T>
+void CooTensor<T>::Insert(const std::vector<int>& indices, T value) {
+  if (indices.size() != dimensions_.size())
+    throw std::invalid_argument("CooTensor Insert- Indices Order Mismatch");
+  for (int axis = 0; axis < getOrder(); ++axis) {
+    if (indices[axis] < 0 || indices[axis] >= dimensions_[axis])
+      throw std::invalid_argument("CooTensor Insert- Index Out of Bounds");
+  }
+  indices_.insert(indices_.end(), indices.begin(), indices.end());
+  values_.push_back(value);
+}
+template<typename T>
+void CooTensor<T>::Coalesce() {
+  const int order = getOrder();
+  std::vector<int> entries(getNonZeros());
+  std::iota(entries.begin(), entries.end(), 0);
+  std::stable_sort(entries.begin(), entries.end(), [&](int a, int b) {
+    return std::lexicographical_compare(getIndices(a), getIndices(a) + order, getIndices(b), getIndices(b) + order);
+  });
+
+  std::vector<int> indices;
+  std::vector<T> values;
+  indices.reserve(indices_.size());
+  values.reserve(values_.size());
+  for (int entry : entries) {
+    if (!values.empty() && std::equal(getIndices(entry), getIndices(entry) + order, indices.end() - order)) {
+      values.back() += values_[entry];
+      continue;
+    }
+    indices.insert(indices.end(), getIndices(entry), getIndices(entry) + order);
+    values.push_back(values_[entry]);
+  }
+  indices_ = std::move(indices);
+  values_ = std::move(values);
+}
+// End of Modifiers ----------------------------------------------------
+
+// Conversion ----------------------------------------------------------
+template<typename T>
+Tensor<T> CooTensor<T>::ToDense() const {
+  Tensor<T> res(dimensions_);
+  T* values = res.data();
+  for (int entry = 0; entry < getNonZeros(); ++entry) {
+    int address = 0;
+    for (int axis = 0; axis < getOrder(); ++axis) {
+      address = address * dimensions_[axis] + getIndices(entry)[axis];
+    }
+    values[address] += values_[entry];
+  }
+  return res;
+}
+template<typename T>
+CsrTensor<T> CooTensor<T>::ToCsr() const {
+  const int order = getOrder();
+  if (order < 2)
+    throw std::invalid_argument("CooTensor ToCsr- Tensor is not Matrix");
+
+  CooTensor<T> sorted = *this;
+  sorted.Coalesce();
+
+  // Leading indices and row fold into stacked row
+  int rows = 1;
+  for (int axis = 0; axis < order - 1; ++axis) rows *= dimensions_[axis];
+
+  std::vector<int> row_offsets(rows + 1, 0);
+  std::vector<int> col_indices(sorted.getNonZeros());
+  for (int entry = 0; entry < sorted.getNonZeros(); ++entry) {
+    const int* indices = sorted.getIndices(entry);
+    int row = 0;
+    for (int axis = 0; axis < order - 1; ++axis) row = row * dimensions_[axis] + indices[axis];
+    ++row_offsets[row + 1];
+    col_indices[entry] = indices[order - 1];
+  }
+  std::partial_sum(row_offsets.begin(), row_offsets.end(), row_offsets.begin());
+
+  return CsrTensor<T>(dimensions_, std::move(row_offsets), std::move(col_indices), std::move(sorted.values_));
+}
+// End of Conversion ---------------------------------------------------
+// End of CooTensor ================================================================
+
+// CsrTensor =======================================================================
+// Constructors --------------------------------------------------------
+template<typename T>
+CsrTensor<T>::CsrTensor(const std::vector<int>& dims, std::vector<int> row_offsets,
+                        std::vector<int> col_indices, std::vector<T> values)
+    : dimensions_(dims), rows_(1), cols_(0),
+      row_offsets_(std::move(row_offsets)), col_indices_(std::move(col_indices)), values_(std::move(values)) {
+  if (dims.size() < 2)
+    throw std::invalid_argument("CsrTensor Constructor- Tensor is not Matrix");
+  for (int axis = 0; axis < static_cast<int>(dims.size()) - 1; ++axis) {
+    if (dims[axis] < 0)
+      throw std::invalid_argument("CsrTensor Constructor- Non-Positive Dimension Error");
+    rows_ *= dims[axis];
+  }
+  cols_ = dims.back();
+
+  if (row_offsets_.size() != static_cast<size_t>(rows_) + 1 || row_offsets_.front() != 0 ||
+      row_offsets_.back() != static_cast<int>(values_.size()) || col_indices_.size() != values_.size())
+    throw std::invalid_argument("CsrTensor Constructor- Component Size Mismatch");
+  for (int row = 0; row < rows_; ++row) {
+    for (int i = row_offsets_[row]; i < row_offsets_[row + 1]; ++i) {
+      if (col_indices_[i] < 0 || col_indices_[i] >= cols_ ||
+          (i > row_offsets_[row] && col_indices_[i] <= col_indices_[i - 1]))
+        throw std::invalid_argument("CsrTensor Constructor- Column Index Out of Order");
+    }
+  }
+}
+/** From Dense */
+template<typename T>
+CsrTensor<T> CsrTensor<T>::FromDense(const Tensor<T>& tensor, T threshold /*= T(0)*/) {
+  const std::vector<int> dims = tensor.getShape();
+  if (dims.size() < 2)
+    throw std::invalid_argument("CsrTensor FromDense- Tensor is not Matrix");
+  const int cols = dims.back();
+  const int rows = cols > 0 ? tensor.getCapacity() / cols : 0;
+  const T* values = tensor.data();
+
+  std::vector<int> row_offsets(1, 0);
+  std::vector<int> col_indices;
+  std::vector<T> nonzeros;
+  row_offsets.reserve(rows + 1);
+  for (int row = 0; row < rows; ++row) {
+    const T* dense_row = values + static_cast<size_t>(row) * cols;
+    for (int col = 0; col < cols; ++col) {
+      if (std::abs(dense_row[col]) > threshold) {
+        col_indices.push_back(col);
+        nonzeros.push_back(dense_row[col]);
+      }
+    }
+    row_offsets.push_back(nonzeros.size());
+  }
+  return CsrTensor<T>(dims, std::move(row_offsets), std::move(col_indices), std::move(nonzeros));
+}
+// End of Constructors -------------------------------------------------
+
+// Accessors -----------------------------------------------------------
+template<typename T>
+double CsrTensor<T>::getDensity() const {
+  const double capacity = static_cast<double>(rows_) * cols_;
+  return capacity > 0 ? getNonZeros() / capacity : 0.0;
+}
+// End of Accessors ----------------------------------------------------
+
+// Conversion ----------------------------------------------------------
+template<typename T>
+Tensor<T> CsrTensor<T>::ToDense() const {
+  Tensor<T> res(dimensions_);
+  T* values = res.data();
+  for (int row = 0; row < rows_; ++row) {
+    for (int i = row_offsets_[row]; i < row_offsets_[row + 1]; ++i) {
+      values[static_cast<size_t>(row) * cols_ + col_indices_[i]] = values_[i];
+    }
+  }
+  return res;
+}
+template<typename T>
+CooTensor<T> CsrTensor<T>::ToCoo() const {
+  CooTensor<T> res(dimensions_);
+  const int order = dimensions_.size();
+  std::vector<int> indices(order);
+  for (int row = 0; row < rows_; ++row) {
+    // Unfold stacked row into leading indices
+    for (int axis = order - 2, remaining = row; axis >= 0; --axis) {
+      indices[axis] = remaining % dimensions_[axis];
+      remaining /= dimensions_[axis];
+    }
+    for (int i = row_offsets_[row]; i < row_offsets_[row + 1]; ++i) {
+      indices[order - 1] = col_indices_[i];
+      res.Insert(indices, values_[i]);
+    }
+  }
+  return res;
+}
+// End of Conversion ---------------------------------------------------
+
+// Operations ----------------------------------------------------------
+template<typename T>
+Tensor<T> CsrTensor<T>::operator*(const Tensor<T>& dense) const {
+  std::vector<int> res_dim = dimensions_;
+  if (dense.getOrder() != 2)
+    throw std::invalid_argument("CsrTensor Multiplication- Dense Operand is not Matrix");
+  res_dim.back() = dense.getDimension(1);
+
+  Tensor<T> res(res_dim);
+  MultiplyInto(dense, res);
+  return res;
+}
+template<typename T>
+void CsrTensor<T>::MultiplyInto(const Tensor<T>& dense, Tensor<T>& result,
+                                const MatmulEpilogue<T>& epilogue /*= MatmulEpilogue<T>()*/) const {
+  if (dense.getOrder() != 2)
+    throw std::invalid_argument("CsrTensor Multiplication- Dense Operand is not Matrix");
+  if (dense.getDimension(0) != cols_)
+    throw std::invalid_argument("CsrTensor Multiplication- Multiplcation Dimension Mismatch");
+  std::vector<int> res_dim = dimensions_;
+  res_dim.back() = dense.getDimension(1);
+  if (result.getShape() != res_dim)
+    throw std::invalid_argument("CsrTensor Multiplication- Result Dimension Mismatch");
+
+  const int N = res_dim.back();
+  const int chunk_rows = dimensions_[dimensions_.size() - 2];
+
+  GemmEpilogue<T> gemm_epilogue;
+  gemm_epilogue.alpha = epilogue.alpha;
+  gemm_epilogue.beta = epilogue.beta;
+  gemm_epilogue.bias_axis = epilogue.bias_axis;
+  gemm_epilogue.activation = epilogue.activation;
+  std::vector<T> stacked_bias;
+  if (epilogue.bias != nullptr) {
+    const int bias_size = epilogue.bias_axis == BiasAxis::kRow ? N : chunk_rows;
+    if (epilogue.bias->getCapacity() != bias_size)
+      throw std::invalid_argument("CsrTensor Multiplication- Bias Dimension Mismatch");
+    gemm_epilogue.bias = epilogue.bias->data();
+    if (epilogue.bias_axis == BiasAxis::kCol && rows_ != chunk_rows) {
+      // Kernel indexes column-bias by stacked row, so it is repeated for every chunk
+      stacked_bias.resize(rows_);
+      for (int row = 0; row < rows_; ++row) stacked_bias[row] = epilogue.bias->data()[row % chunk_rows];
+      gemm_epilogue.bias = stacked_bias.data();
+    }
+  }
+  if (epilogue.residual != nullptr) {
+    if (epilogue.residual->getShape() != res_dim)
+      throw std::invalid_argument("CsrTensor Multiplication- Residual Dimension Mismatch");
+    gemm_epilogue.residual = epilogue.residual->data();
+    gemm_epilogue.residual_ld = N;
+  }
+
+  if (N == 1) {
+    SpMV(*this, dense.data(), 1, result.data(), 1, gemm_epilogue);
+  } else {
+    SpMM(*this, N, dense.data(), N, result.data(), N, gemm_epilogue);
+  }
+}
+// End of Operations ---------------------------------------------------
+// End of CsrTensor ================================================================
+
+// Sparse Kernels ------------------------------------------------------
+/** Sparse Matrix x Dense Matrix */
+template<typename T, typename Acc>
+void SpMM(const CsrTensor<T>& A, int N, const T* B, int ldb, T* C, int ldc,
+          const GemmEpilogue<T>& epilogue /*= GemmEpilogue<T>()*/) {
+  const int* row_offsets = A.getRowOffsets();
+  const int* col_indices = A.getColIndices();
+  const T* values = A.getValues();
+
+  // Work of a row is its nnz times N, aim for about 2^16 multiply-adds per chunk
+  const long long average_work = static_cast<long long>(A.getNonZeros() / std::max(A.getRows(), 1) + 1) * N;
+  const int grain = std::max(1, static_cast<int>((1LL << 16) / std::max(average_work, 1LL)));
+
+  ParallelChunks(A.getRows(), [&](int begin, int end) {
+    std::vector<Acc> acc(N);
+    for (int r = begin; r < end; ++r) {
+      std::fill(acc.begin(), acc.end(), Acc(0));
+      for (int i = row_offsets[r]; i < row_offsets[r + 1]; ++i) {
+        const Acc value = static_cast<Acc>(values[i]);
+        const T* b_row = B + static_cast<size_t>(col_indices[i]) * ldb;
+        for (int c = 0; c < N; ++c) {
+          acc[c] += value * static_cast<Acc>(b_row[c]);
+        }
+      }
+
+      T* c_row = C + static_cast<size_t>(r) * ldc;
+      for (int c = 0; c < N; ++c) {
+        Acc value = static_cast<Acc>(epilogue.alpha) * acc[c];
+        if (epilogue.beta != T(0)) value += static_cast<Acc>(epilogue.beta) * static_cast<Acc>(c_row[c]);
+        c_row[c] = NarrowAccumulator<T>(GemmFinish(epilogue, value, r, c));
+      }
+    }
+  }, grain);
+}
+/** Sparse Matrix x Dense Vector */
+template<typename T, typename Acc>
+void SpMV(const CsrTensor<T>& A, const T* x, int x_stride, T* y, int y_stride,
+          const GemmEpilogue<T>& epilogue /*= GemmEpilogue<T>()*/) {
+  const int* row_offsets = A.getRowOffsets();
+  const int* col_indices = A.getColIndices();
+  const T* values = A.getValues();
+
+  const int average_nnz = A.getNonZeros() / std::max(A.getRows(), 1) + 1;
+  const int grain = std::max(1, (1 << 16) / average_nnz);
+
+  ParallelChunks(A.getRows(), [&](int begin, int end) {
+    for (int r = begin; r < end; ++r) {
+      Acc sum = Acc(0);
+      for (int i = row_offsets[r]; i < row_offsets[r + 1]; ++i) {
+        sum += static_cast<Acc>(values[i]) * static_cast<Acc>(x[static_cast<size_t>(col_indices[i]) * x_stride]);
+      }
+
+      T& out = y[static_cast<size_t>(r) * y_stride];
+      Acc value = static_cast<Acc>(epilogue.alpha) * sum;
+      if (epilogue.beta != T(0)) value += static_cast<Acc>(epilogue.beta) * static_cast<Acc>(out);
+      out = NarrowAccumulator<T>(GemmFinish(epilogue, value, r, 0));
+    }
+  }, grain);
+}
+// End of Sparse Kernels -----------------------------------------------
+
+} // util
+} // cpp_nn
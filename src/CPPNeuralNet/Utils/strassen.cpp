@@ -0,0 +1,20 @@
+#include "CPPNeuralNet/Utils/strassen.h"
+
+#include <atomic>
+
+namespace cpp_nn {
+namespace util {
+
+namespace {
+std::atomic<int> strassen_cutoff(0); // Disabled by default
+} // namespace
+
+void SetStrassenCutoff(int cutoff) {
+  strassen_cutoff.store(cutoff < 0 ? 0 : cutoff);
+}
+int getStrassenCutoff() {
+  return strassen_cutoff.load();
+}
+
+} // util
+} // cpp_nn
@@ -0,0 +1,149 @@
+#include "CPPNeuralNet/Utils/strassen.h"
+#include "CPPNeuralNet/Utils/gemm.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace cpp_nn {
+namespace util {
+
+// StrassenWorkspace ===============================================================
+template<typename T>
+void StrassenWorkspace<T>::Reserve(size_t capacity) {
+  if (used_ != 0)
+    throw std::logic_error("StrassenWorkspace Reserve- Workspace in Use");
+  if (buffer_.size() < capacity) buffer_.resize(capacity);
+}
+template<typename T>
+T* StrassenWorkspace<T>::Allocate(size_t size) {
+  if (used_ + size > buffer_.size())
+    throw std::length_error("StrassenWorkspace Allocate- Workspace Exhausted");
+  T* block = buffer_.data() + used_;
+  used_ += size;
+  return block;
+}
+template<typename T>
+size_t StrassenWorkspace<T>::RequiredSize(int M, int N, int K, int cutoff) {
+  // Every level takes 4 A-quadrants, 4 B-quadrants and 7 C-quadrants,
+  //  then recurses into quadrants of half size while holding them.
+  size_t total = 0;
+  while (std::min({M, N, K}) > cutoff && std::min({M, N, K}) >= 2) {
+    M /= 2;
+    N /= 2;
+    K /= 2;
+    total += 4 * static_cast<size_t>(M) * K + 4 * static_cast<size_t>(K) * N + 7 * static_cast<size_t>(M) * N;
+  }
+  return total;
+}
+// End of StrassenWorkspace ========================================================
+
+// Quadrant Arithmetic -------------------------------------------------
+/** Z = X + sign * Y, for [rows x cols] blocks */
+template<typename T>
+void StrassenAdd(int rows, int cols, const T* X, int ldx, const T* Y, int ldy, T* Z, int ldz, T sign) {
+  for (int r = 0; r < rows; ++r) {
+    const T* x = X + r * ldx;
+    const T* y = Y + r * ldy;
+    T* z = Z + r * ldz;
+    for (int c = 0; c < cols; ++c) {
+      z[c] = x[c] + sign * y[c];
+    }
+  }
+}
+// End of Quadrant Arithmetic ------------------------------------------
+
+// Recursion -----------------------------------------------------------
+template<typename T>
+void StrassenRecurse(int M, int N, int K,
+                     const T* A, int lda, const T* B, int ldb, T* C, int ldc,
+                     int cutoff, StrassenWorkspace<T>& workspace) {
+  if (std::min({M, N, K}) <= cutoff || std::min({M, N, K}) < 2) {
+    Gemm(M, N, K, A, lda, 1, B, ldb, 1, C, ldc);
+    return;
+  }
+
+  // Dynamic peeling: recurse on even part, fix up odd leftovers afterwards
+  const int m = M / 2, n = N / 2, k = K / 2;
+  const int M_even = 2 * m, N_even = 2 * n, K_even = 2 * k;
+
+  const size_t mark = workspace.getMark();
+  T* S[4];
+  T* U[4];
+  T* P[7];
+  for (T*& s : S) s = workspace.Allocate(static_cast<size_t>(m) * k);
+  for (T*& t : U) t = workspace.Allocate(static_cast<size_t>(k) * n);
+  for (T*& p : P) p = workspace.Allocate(static_cast<size_t>(m) * n);
+
+  const T* A11 = A;
+  const T* A12 = A + k;
+  const T* A21 = A + m * lda;
+  const T* A22 = A + m * lda + k;
+  const T* B11 = B;
+  const T* B12 = B + n;
+  const T* B21 = B + k * ldb;
+  const T* B22 = B + k * ldb + n;
+  T* C11 = C;
+  T* C12 = C + n;
+  T* C21 = C + m * ldc;
+  T* C22 = C + m * ldc + n;
+
+  // Winograd's schedule, 15 additions
+  StrassenAdd(m, k, A21, lda, A22, lda, S[0], k, T(1));   // S1 = A21 + A22
+  StrassenAdd(m, k, S[0], k, A11, lda, S[1], k, T(-1));   // S2 = S1 - A11
+  StrassenAdd(m, k, A11, lda, A21, lda, S[2], k, T(-1));  // S3 = A11 - A21
+  StrassenAdd(m, k, A12, lda, S[1], k, S[3], k, T(-1));   // S4 = A12 - S2
+  StrassenAdd(k, n, B12, ldb, B11, ldb, U[0], n, T(-1));  // T1 = B12 - B11
+  StrassenAdd(k, n, B22, ldb, U[0], n, U[1], n, T(-1));   // T2 = B22 - T1
+  StrassenAdd(k, n, B22, ldb, B12, ldb, U[2], n, T(-1));  // T3 = B22 - B12
+  StrassenAdd(k, n, U[1], n, B21, ldb, U[3], n, T(-1));   // T4 = T2 - B21
+
+  StrassenRecurse(m, n, k, A11, lda, B11, ldb, P[0], n, cutoff, workspace);   // P1 = A11 * B11
+  StrassenRecurse(m, n, k, A12, lda, B21, ldb, P[1], n, cutoff, workspace);   // P2 = A12 * B21
+  StrassenRecurse(m, n, k, S[3], k, B22, ldb, P[2], n, cutoff, workspace);    // P3 = S4 * B22
+  StrassenRecurse(m, n, k, A22, lda, U[3], n, P[3], n, cutoff, workspace);    // P4 = A22 * T4
+  StrassenRecurse(m, n, k, S[0], k, U[0], n, P[4], n, cutoff, workspace);     // P5 = S1 * T1
+  StrassenRecurse(m, n, k, S[1], k, U[1], n, P[5], n, cutoff, workspace);     // P6 = S2 * T2
+  StrassenRecurse(m, n, k, S[2], k, U[2], n, P[6], n, cutoff, workspace);     // P7 = S3 * T3
+
+  StrassenAdd(m, n, P[0], n, P[1], n, C11, ldc, T(1));    // C11 = P1 + P2
+  StrassenAdd(m, n, P[0], n, P[5], n, P[0], n, T(1));     // U2 = P1 + P6
+  StrassenAdd(m, n, P[0], n, P[6], n, P[1], n, T(1));     // U3 = U2 + P7
+  StrassenAdd(m, n, P[0], n, P[4], n, P[0], n, T(1));     // U4 = U2 + P5
+  StrassenAdd(m, n, P[0], n, P[2], n, C12, ldc, T(1));    // C12 = U4 + P3
+  StrassenAdd(m, n, P[1], n, P[3], n, C21, ldc, T(-1));   // C21 = U3 - P4
+  StrassenAdd(m, n, P[1], n, P[4], n, C22, ldc, T(1));    // C22 = U3 + P5
+
+  workspace.Release(mark);
+
+  // Peeled fix-ups
+  GemmEpilogue<T> accumulate;
+  accumulate.beta = T(1);
+  if (K_even != K) {
+    // Last column of A times last row of B, onto the even block
+    Gemm(M_even, N_even, 1, A + K_even, lda, 1, B + K_even * ldb, ldb, 1, C, ldc, accumulate);
+  }
+  if (N_even != N) {
+    // Last column of C
+    Gemm(M_even, 1, K, A, lda, 1, B + N_even, ldb, 1, C + N_even, ldc);
+  }
+  if (M_even != M) {
+    // Last row of C
+    Gemm(1, N, K, A + M_even * lda, lda, 1, B, ldb, 1, C + M_even * ldc, ldc);
+  }
+}
+// End of Recursion ----------------------------------------------------
+
+/** Strassen-Winograd Matrix Multiplcation */
+template<typename T>
+void StrassenGemm(int M, int N, int K,
+                  const T* A, int lda, const T* B, int ldb, T* C, int ldc,
+                  int cutoff, StrassenWorkspace<T>& workspace) {
+  if (cutoff < 1)
+    throw std::invalid_argument("StrassenGemm- Non-Positive Cutoff");
+  workspace.Reserve(StrassenWorkspace<T>::RequiredSize(M, N, K, cutoff));
+
+  StrassenRecurse(M, N, K, A, lda, B, ldb, C, ldc, cutoff, workspace);
+}
+
+} // util
+} // cpp_nn
@@ -1,4 +1,7 @@
 #include "CPPNeuralNet/Utils/tensor.h"
+#include "CPPNeuralNet/Utils/tensor_reference.h"
+#include "CPPNeuralNet/Utils/element_reference.h"
+#include "CPPNeuralNet/Utils/utils.h"
 
 namespace cpp_nn {
 namespace util {
@@ -8,7 +11,7 @@ namespace util {
 // TensorElement Constructor ------------------------------------------
 /** TensorElement Dimension Const. */
 template<typename T>
-Tensor<T>::TensorElement::TensorElement(const std::initializer_list<int>& dims, T initial_value /*= T()*/)
+Tensor<T>::TensorElement::TensorElement(const std::vector<int>& dims, T initial_value /*= T()*/)
     : dimensions_(dims), kCapacity(0) {
   if (dimensions_.size() != 0) {
     kCapacity = 1;
@@ -21,18 +24,41 @@ Tensor<T>::TensorElement::TensorElement(const std::initializer_list<int>& dims,
     }
   }
 
-  elements_.resize(kCapacity, initial_value);
+  // Left untouched by resize, then filled by the threads that will work on each part
+  elements_.resize(kCapacity);
+  FirstTouchFill(elements_.data(), kCapacity, initial_value);
   // Initially all index maps to self
   transpose_map_.reserve(order());
   for (int i = 0; i < order(); ++i) {
     transpose_map_.push_back(i);
   }
 }
+/** TensorElement View Const. */
+template<typename T>
+Tensor<T>::TensorElement::TensorElement(const std::vector<int>& dims, T* storage)
+    : dimensions_(dims), kCapacity(0) {
+  if (dimensions_.size() != 0) {
+    kCapacity = 1;
+    for (const int& dim : dims) {
+      if (dim < 0) throw std::invalid_argument("TensorElement Constructor- Non-Positive Dimension Error");
+      kCapacity *= dim;
+    }
+  }
+  if (storage == nullptr && kCapacity > 0) throw std::invalid_argument("TensorElement Constructor- Null Storage");
+
+  elements_ = TensorStorage<T>(storage, kCapacity);
+  transpose_map_.reserve(order());
+  for (int i = 0; i < order(); ++i) {
+    transpose_map_.push_back(i);
+  }
+}
 /** TensorElement Copy Constructor */
 template<typename T>
 Tensor<T>::TensorElement::TensorElement(const TensorElement& other)
-    : dimensions_(other.dimensions_), elements_(other.elements_), 
-      kCapacity(other.kCapacity), transpose_map_(other.transpose_map_) {}
+    : dimensions_(other.dimensions_), kCapacity(other.kCapacity), transpose_map_(other.transpose_map_) {
+  elements_.resize(kCapacity);
+  FirstTouchCopy(elements_.data(), other.elements_.data(), kCapacity);
+}
 // End of TensorElement Constructor ----------------------------------
 
 
@@ -95,6 +121,23 @@ template<typename T>
 void Tensor<T>::TensorElement::Transpose(int axis_one, int axis_two) {
   std::swap(transpose_map_[axis_one], transpose_map_[axis_two]);
 }
+/** Resize */
+template<typename T>
+void Tensor<T>::TensorElement::Resize(const std::vector<int>& dims) {
+  int capacity = dims.size() != 0 ? 1 : 0;
+  for (const int& dim : dims) {
+    if (dim < 0) throw std::invalid_argument("TensorElement Resize- Non-Positive Dimension Error");
+    capacity *= dim;
+  }
+
+  elements_.resize(capacity); // Keeps storage when shrinking
+  dimensions_ = dims;
+  kCapacity = capacity;
+  transpose_map_.resize(order());
+  for (int i = 0; i < order(); ++i) {
+    transpose_map_[i] = i;
+  }
+}
 // End of TensorElement Modifier -------------------------------------
 // End of TensorElement =====================================================
 
@@ -107,6 +150,15 @@ Tensor<T>::Tensor(std::initializer_list<int> dims, T initial_value)
 template<typename T>
 Tensor<T>::Tensor(std::vector<int> dims, T initial_value) 
     : elements_(new TensorElement(dims, initial_value)), ownership_(true) {}
+/** View Constructor */
+template<typename T>
+Tensor<T> Tensor<T>::View(const std::vector<int>& dims, T* storage) {
+  return Tensor<T>(new TensorElement(dims, storage));
+}
+/** Adopting Constructor */
+template<typename T>
+Tensor<T>::Tensor(TensorElement* elements)
+    : elements_(elements), ownership_(true) {}
 /** Copy Constructor */
 template<typename T>
 Tensor<T>::Tensor(const Tensor<T>& other)
@@ -119,6 +171,35 @@ Tensor<T>::Tensor(Tensor<T>&& other)
   other.elements_ = nullptr;
   other.ownership_ = false;
 }
+/** Destructor */
+template<typename T>
+Tensor<T>::~Tensor() {
+  if (ownership_) delete elements_;
+}
+/** Copy Assignment */
+template<typename T>
+Tensor<T>& Tensor<T>::operator=(const Tensor<T>& other) {
+  if (this != &other) {
+    TensorElement* copied = new TensorElement(*other.elements_);
+    if (ownership_) delete elements_;
+    elements_ = copied;
+    ownership_ = true;
+  }
+  return *this;
+}
+/** Move Assignment */
+template<typename T>
+Tensor<T>& Tensor<T>::operator=(Tensor<T>&& other) {
+  if (this != &other) {
+    if (ownership_) delete elements_;
+    elements_ = other.elements_;
+    ownership_ = other.ownership_;
+    // unlink other
+    other.elements_ = nullptr;
+    other.ownership_ = false;
+  }
+  return *this;
+}
 // End of Constructors -------------------------------------------------
 
 // Accessors -----------------------------------------------------------
@@ -131,76 +212,323 @@ template<typename T>
 const T& Tensor<T>::getElement(const std::vector<int>& indices) const {
   return elements_->getElement(indices);
 }
+/** Shape Getter */
+template<typename T>
+std::vector<int> Tensor<T>::getShape() const {
+  std::vector<int> shape;
+  shape.reserve(getOrder());
+  for (int i = 0; i < getOrder(); ++i) {
+    shape.push_back(getDimension(i));
+  }
+  return shape;
+}
 // End of Accessors ----------------------------------------------------
 
+// Tensor Modifiers ----------------------------------------------------
+/** Reshape */
+template<typename T>
+void Tensor<T>::Reshape(const std::vector<int>& dims) {
+  int capacity = dims.size() != 0 ? 1 : 0;
+  for (const int& dim : dims) capacity *= dim;
+  if (capacity != getCapacity()) throw std::invalid_argument("Tensor Reshape- Capacity Mismatch");
+
+  elements_->Resize(dims);
+}
+// End of Tensor Modifiers ---------------------------------------------
+
 // Tensor Operations ---------------------------------------------------
 template<typename T>
 Tensor<T> Tensor<T>::operator*(const Tensor<T>& other) const {
-  if (getOrder() < 2 || other.getOrder() < 2) 
-    throw std::invalid_argument("Tensor Multiplication- Tensor is not Matrix");
+  Tensor<T> res(MultipliedWith(other));
 
-  if (elements_->getDimension(getOrder() - 1)  != other.elements_->getDimension(other.getOrder() - 2))
-    throw std::invalid_argument("Tensor Multiplication- Multiplcation Dimension Mismatch");
-  
-  // [res_rows, inter_dim] * [inter_dim, res_cols]
-  int res_rows = getDimension(getOrder() - 2);
-  int res_cols = getDimension(other.getOrder() - 1);
-  int inter_dim = getDimension(getOrder() - 1); 
-  
-  // given A[dim1..., r, k] and B[dim2..., k, c], the resulting product is of dim C[dim1..., dim2..., r, c]
-  std::vector<int> res_dim;
-  res_dim.reserve(this->getOrder() + other.getOrder() - 2);
-  for (int i = 0; i < this->getOrder() - 2; ++i) {
-    res_dim.push_back(this->getDimension(i));
-  }
-  for (int i = 0; i < other.getOrder() - 2; ++i) {
-    res_dim.push_back(other.getDimension(i));
+  res.MultiplyInto(*this, other);
+
+  return res;
+}
+/** Tensor Multiplcation, with Accumulator */
+template<typename T>
+template<typename Acc>
+Tensor<T> Tensor<T>::Multiply(const Tensor<T>& other, 
+                              const MatmulEpilogue<T>& epilogue /*= MatmulEpilogue<T>()*/) const {
+  Tensor<T> res(MultipliedWith(other));
+
+  res.template MultiplyInto<Acc>(*this, other, epilogue);
+
+  return res;
+}
+/** Tensor Multiplcation Into */
+template<typename T>
+template<typename Acc>
+void Tensor<T>::MultiplyInto(const Tensor<T>& A, const Tensor<T>& B, 
+                             const MatmulEpilogue<T>& epilogue /*= MatmulEpilogue<T>()*/) {
+  if (getShape() != A.MultipliedWith(B))
+    throw std::invalid_argument("Tensor Multiplication- Result Dimension Mismatch");
+
+  const int res_rows = getDimension(getOrder() - 2);
+  const int res_cols = getDimension(getOrder() - 1);
+
+  GemmEpilogue<T> gemm_epilogue = ToGemmEpilogue(epilogue);
+
+  const int inter_dim = A.getDimension(A.getOrder() - 1);
+  const int res_chunk = res_rows * res_cols;
+  const int A_chunks = A.getCapacity() / std::max(res_rows * inter_dim, 1);
+  const int B_chunks = B.getCapacity() / std::max(inter_dim * res_cols, 1);
+  if (getCapacity() == 0) return;
+
+  // Vector-shaped chunks are streamed by their own kernels, packing would not pay off.
+  if (res_rows == 1 || res_cols == 1 || inter_dim == 1) {
+    // Each Matrix chunk is handled via MatrixReference
+    MatrixReference<T> A_ref(A);
+    MatrixReference<T> B_ref(B);
+    MatrixReference<T> C_ref(*this);
+
+    // Multiply each chunk: C = A * B
+    int res_offset = 0;
+    do { // while A has next
+      do { // while B has next
+        // Residual chunk lines up with current result chunk
+        if (epilogue.residual != nullptr) {
+          gemm_epilogue.residual = epilogue.residual->elements_->data() + res_offset;
+        }
+        // Multiply 
+        C_ref.template MultiplyInto<Acc>(A_ref, B_ref, gemm_epilogue);
+
+        C_ref.incrementIndex(); 
+        res_offset += res_chunk;
+      } while(B_ref.incrementIndex()/* != 0*/);
+    } while(A_ref.incrementIndex()/* != 0*/);
+    return;
   }
-  res_dim.push_back(res_rows);
-  res_dim.push_back(res_cols);
-  Tensor<T> res(res_dim);
 
-  // Each Matrix chunk is handled via MatrixReference
-  MatrixReference A(*this);
-  MatrixReference B(other);
-  MatrixReference C(res);
+  const T* A_data = A.elements_->data();
+  const T* B_data = B.elements_->data();
+  T* C_data = elements_->data();
+  const T* residual_data = epilogue.residual != nullptr ? epilogue.residual->elements_->data() : nullptr;
+
+  // Single B, ie) [batch, n, m] * [m, d]:
+  //  A chunks are stacked rows of one [batch * n, m] matrix, and so are the results.
+  //  Column-bias would need row index within chunk, so only row-bias is folded.
+  if (B_chunks == 1 && (epilogue.bias == nullptr || epilogue.bias_axis == BiasAxis::kRow)) {
+    gemm_epilogue.residual = residual_data;
+    Gemm<T, Acc>(A_chunks * res_rows, res_cols, inter_dim,
+         A_data, inter_dim, 1,
+         B_data, res_cols, 1,
+         C_data, res_cols, gemm_epilogue);
+    return;
+  }
 
-  // Multiply each chunk: C = A * B
-  do { // while A has next
-    do { // while B has next
-      // Multiply 
-      C.MultiplyInto(A, B);
+  // Otherwise each B chunk is packed once, then multiplied against every A chunk.
+  //  Result of A chunk a with B chunk b is at chunk (a * B_chunks + b).
+  // When chunks are small, A chunks are split among threads instead of each product's rows.
+  const long long chunk_work = static_cast<long long>(res_rows) * res_cols * inter_dim;
+  const int grain = chunk_work < (1LL << 20) ? std::max(1, static_cast<int>((1LL << 20) / chunk_work)) : A_chunks;
+  GemmPackedB<T, Acc> packed_B;
+  for (int b = 0; b < B_chunks; ++b) {
+    packed_B.Pack(inter_dim, res_cols, B_data + b * inter_dim * res_cols, res_cols, 1);
+
+    ParallelChunks(A_chunks, [&](int a_begin, int a_end) {
+      GemmEpilogue<T> chunk_epilogue = gemm_epilogue;
+      for (int a = a_begin; a < a_end; ++a) {
+        const int res_offset = (a * B_chunks + b) * res_chunk;
+        if (residual_data != nullptr) chunk_epilogue.residual = residual_data + res_offset;
+
+        GemmPacked(res_rows, A_data + a * res_rows * inter_dim, inter_dim, 1,
+                   packed_B, C_data + res_offset, res_cols, chunk_epilogue);
+      }
+    }, grain);
+  }
+}
+/** Batched Tensor Multiplcation */
+template<typename T>
+template<typename Acc>
+Tensor<T> Tensor<T>::BatchedMatmul(const Tensor<T>& other, 
+                                   const MatmulEpilogue<T>& epilogue /*= MatmulEpilogue<T>()*/) const {
+  Tensor<T> res(BatchMultipliedWith(other));
 
-      C.incrementIndex(); 
-    } while(B.incrementIndex()/* != 0*/);
-  } while(A.incrementIndex()/* != 0*/);
+  res.template BatchedMultiplyInto<Acc>(*this, other, epilogue);
 
   return res;
 }
+/** Batched Tensor Multiplcation Into */
+template<typename T>
+template<typename Acc>
+void Tensor<T>::BatchedMultiplyInto(const Tensor<T>& A, const Tensor<T>& B, 
+                                    const MatmulEpilogue<T>& epilogue /*= MatmulEpilogue<T>()*/) {
+  if (getShape() != A.BatchMultipliedWith(B))
+    throw std::invalid_argument("Tensor Batched Multiplication- Result Dimension Mismatch");
+
+  const int res_rows = getDimension(getOrder() - 2);
+  const int res_cols = getDimension(getOrder() - 1);
+  const int inter_dim = A.getDimension(A.getOrder() - 1);
+  const int res_chunk = res_rows * res_cols;
+  if (getCapacity() == 0) return;
+
+  GemmEpilogue<T> gemm_epilogue = ToGemmEpilogue(epilogue);
+  const T* A_data = A.elements_->data();
+  const T* B_data = B.elements_->data();
+  T* C_data = elements_->data();
+  const T* residual_data = epilogue.residual != nullptr ? epilogue.residual->elements_->data() : nullptr;
+
+  // Chunk-strides of A and B along each broadcasted batch axis, 0 where broadcasted
+  const int batch_order = getOrder() - 2;
+  std::vector<int> A_strides(batch_order, 0);
+  std::vector<int> B_strides(batch_order, 0);
+  for (int i = batch_order - 1, A_block = 1, B_block = 1; i >= 0; --i) {
+    const int A_axis = i - (batch_order - (A.getOrder() - 2));
+    const int B_axis = i - (batch_order - (B.getOrder() - 2));
+    if (A_axis >= 0 && A.getDimension(A_axis) != 1) A_strides[i] = A_block;
+    if (B_axis >= 0 && B.getDimension(B_axis) != 1) B_strides[i] = B_block;
+    if (A_axis >= 0) A_block *= A.getDimension(A_axis);
+    if (B_axis >= 0) B_block *= B.getDimension(B_axis);
+  }
+  const int num_pairs = getCapacity() / res_chunk;
+
+  // B shared by every pair, ie) [batch, n, m] * [m, d]: A and results are stacked rows of one matrix
+  bool B_shared = true;
+  for (int stride : B_strides) B_shared &= stride == 0;
+  bool A_stacked = A.getCapacity() == num_pairs * res_rows * inter_dim;
+  if (B_shared && A_stacked && (epilogue.bias == nullptr || epilogue.bias_axis == BiasAxis::kRow)) {
+    gemm_epilogue.residual = residual_data;
+    Gemm<T, Acc>(num_pairs * res_rows, res_cols, inter_dim,
+         A_data, inter_dim, 1,
+         B_data, res_cols, 1,
+         C_data, res_cols, gemm_epilogue);
+    return;
+  }
+
+  // One GEMM per broadcasted pair, pairs split among threads when each is small.
+  // Partitioned by socket, every thread takes a contiguous run of pairs and keeps it on its node,
+  //  as it first-touched the same run of results, see allocator.h
+  const long long chunk_work = static_cast<long long>(res_rows) * res_cols * inter_dim;
+  int grain = chunk_work < (1LL << 20) ? std::max(1, static_cast<int>((1LL << 20) / chunk_work)) : num_pairs;
+  Schedule schedule = Schedule::kDynamic;
+  if (getSocketPartitioning() && GlobalThreadPool().isPinned() && num_pairs >= getNumThreads()) {
+    grain = 1;
+    schedule = Schedule::kNodeLocal;
+  }
+  ParallelFor(0, num_pairs, [&](int pair_begin, int pair_end) {
+    GemmEpilogue<T> chunk_epilogue = gemm_epilogue;
+    for (int pair = pair_begin; pair < pair_end; ++pair) {
+      // Decompose pair into batch index, and find chunks of A and B it maps to
+      int A_chunk = 0, B_chunk = 0;
+      for (int i = batch_order - 1, remaining = pair; i >= 0; --i) {
+        const int index = remaining % getDimension(i);
+        remaining /= getDimension(i);
+        A_chunk += index * A_strides[i];
+        B_chunk += index * B_strides[i];
+      }
+      if (residual_data != nullptr) chunk_epilogue.residual = residual_data + pair * res_chunk;
+
+      Gemm<T, Acc>(res_rows, res_cols, inter_dim,
+           A_data + A_chunk * res_rows * inter_dim, inter_dim, 1,
+           B_data + B_chunk * inter_dim * res_cols, res_cols, 1,
+           C_data + pair * res_chunk, res_cols, chunk_epilogue);
+    }
+  }, grain, schedule);
+}
 /** Elementwise
  *  Given a Tensor that is broadcastable in shape as currewnt, and binary function f: X,Y -> Z
  *  returns new instance of Tensor where element-wise operations are applied in broadcasted manner
  */
 template<typename T>
-Tensor<T> Tensor<T>::ElementwiseApply(const Tensor<T>& other, const std::function<T(T, T)>& operation) const {
+template<typename BinaryOp>
+Tensor<T> Tensor<T>::ElementwiseApply(const Tensor<T>& other, BinaryOp operation) const {
   const std::vector<int> broadcast_shape = BroadcastedWith(other);
 
   Tensor<T> res(broadcast_shape);
 
+  const T* this_data = elements_->data();
+  const T* other_data = other.elements_->data();
+  T* res_data = res.elements_->data();
+  const int capacity = res.getCapacity();
+
+  // Contiguous Fast Path
+  // When either Tensor spans entire broadcast shape and the other is broadcasted only along
+  //  leading axes, the latter simply repeats every block of its own capacity.
+  // ie) [b, n] + [n] or [b, n] + [1, n]
+  auto is_leading_broadcast = [&](const Tensor<T>& tensor) {
+    int axis = 0;
+    while (axis < tensor.getOrder() && tensor.getDimension(axis) == 1) ++axis;
+    const int offset = broadcast_shape.size() - tensor.getOrder();
+    for (; axis < tensor.getOrder(); ++axis) {
+      if (tensor.getDimension(axis) != broadcast_shape[offset + axis]) return false;
+    }
+    return true;
+  };
+  if (getShape() == broadcast_shape && is_leading_broadcast(other)) {
+    const int block = other.getCapacity();
+    ParallelChunks(capacity, [&](int begin, int end) {
+      for (int i = begin, j = begin % block; i < end; ++i) {
+        res_data[i] = operation(this_data[i], other_data[j]);
+        if (++j == block) j = 0;
+      }
+    });
+    return res;
+  }
+  if (other.getShape() == broadcast_shape && is_leading_broadcast(*this)) {
+    const int block = getCapacity();
+    ParallelChunks(capacity, [&](int begin, int end) {
+      for (int i = begin, j = begin % block; i < end; ++i) {
+        res_data[i] = operation(this_data[j], other_data[i]);
+        if (++j == block) j = 0;
+      }
+    });
+    return res;
+  }
+
+  // Strided Path
+  // Each element is found through BroadcastReference, which skips broadcasted axes
   BroadcastReference<T> A(*this, broadcast_shape);
   BroadcastReference<T> B(other, broadcast_shape);
   BroadcastReference<T> C(res, broadcast_shape);
 
   do { // while A has next
-    do { // while B has next
-      C.getElement() = operation(A.getElement(), B.getElement());
+    C.getElement() = operation(A.getElement(), B.getElement());
 
-      C.incrementIndex(); 
-    } while(B.incrementIndex()/* != 0*/);
+    B.incrementIndex();
+    C.incrementIndex(); 
   } while(A.incrementIndex()/* != 0*/);
 
   return res;
 }
+/** Unary Elementwise */
+template<typename T>
+template<typename UnaryOp, typename... UnaryOps>
+Tensor<T> Tensor<T>::Map(UnaryOp operation, UnaryOps... operations) const {
+  Tensor<T> res(*this);
+  res.Apply(operation, operations...);
+  return res;
+}
+/** Unary Elementwise, Casting */
+template<typename T>
+template<typename U, typename UnaryOp>
+Tensor<U> Tensor<T>::MapTo(UnaryOp operation) const {
+  Tensor<U> res(getShape());
+
+  const T* this_data = elements_->data();
+  U* res_data = res.elements_->data();
+  ParallelChunks(getCapacity(), [&](int begin, int end) {
+    for (int i = begin; i < end; ++i) {
+      res_data[i] = static_cast<U>(operation(this_data[i]));
+    }
+  });
+
+  return res;
+}
+/** In-Place Unary Elementwise */
+template<typename T>
+template<typename UnaryOp, typename... UnaryOps>
+Tensor<T>& Tensor<T>::Apply(UnaryOp operation, UnaryOps... operations) {
+  // Unary operation does not depend on shape or transpose, storage is run through as is.
+  T* this_data = elements_->data();
+  ParallelChunks(getCapacity(), [&](int begin, int end) {
+    for (int i = begin; i < end; ++i) {
+      this_data[i] = ApplyFused(this_data[i], operation, operations...);
+    }
+  });
+
+  return *this;
+}
 
 /** Tensor Summation
  * 
@@ -216,55 +544,228 @@ Tensor<T> Tensor<T>::operator+(const Tensor<T>& other) const {
 }
 // End of Tensor Operations --------------------------------------------
 
+// Reductions ----------------------------------------------------------
+/** Full Reductions */
+template<typename T>
+T Tensor<T>::Sum() const {
+  using Acc = AccumulatorType<T>;
+  Acc res;
+  ParallelReduceAxis(data(), 1, getCapacity(), 1, Acc(0), [](Acc x, Acc y) {return x + y;}, &res);
+  return static_cast<T>(res);
+}
+template<typename T>
+T Tensor<T>::Mean() const {
+  using Acc = AccumulatorType<T>;
+  if (getCapacity() == 0) throw std::invalid_argument("Tensor Mean- Empty Tensor");
+  Acc res;
+  ParallelReduceAxis(data(), 1, getCapacity(), 1, Acc(0), [](Acc x, Acc y) {return x + y;}, &res);
+  return static_cast<T>(res / static_cast<Acc>(getCapacity()));
+}
+template<typename T>
+T Tensor<T>::Max() const {
+  using Acc = AccumulatorType<T>;
+  if (getCapacity() == 0) throw std::invalid_argument("Tensor Max- Empty Tensor");
+  Acc res;
+  ParallelReduceAxis(data(), 1, getCapacity(), 1, std::numeric_limits<Acc>::lowest(),
+                     [](Acc x, Acc y) {return x < y ? y : x;}, &res);
+  return static_cast<T>(res);
+}
+template<typename T>
+T Tensor<T>::Min() const {
+  using Acc = AccumulatorType<T>;
+  if (getCapacity() == 0) throw std::invalid_argument("Tensor Min- Empty Tensor");
+  Acc res;
+  ParallelReduceAxis(data(), 1, getCapacity(), 1, std::numeric_limits<Acc>::max(),
+                     [](Acc x, Acc y) {return y < x ? y : x;}, &res);
+  return static_cast<T>(res);
+}
+/** Axis Reductions */
+template<typename T>
+Tensor<T> Tensor<T>::Sum(int axis) const {
+  using Acc = AccumulatorType<T>;
+  return ReduceAxis(axis, Acc(0), [](Acc x, Acc y) {return x + y;},
+                    [](Acc x) {return static_cast<T>(x);});
+}
+template<typename T>
+Tensor<T> Tensor<T>::Mean(int axis) const {
+  using Acc = AccumulatorType<T>;
+  if (axis >= 0 && axis < getOrder() && getDimension(axis) == 0) {
+    throw std::invalid_argument("Tensor Mean- Empty Axis");
+  }
+  const Acc length = static_cast<Acc>(axis >= 0 && axis < getOrder() ? getDimension(axis) : 1);
+  return ReduceAxis(axis, Acc(0), [](Acc x, Acc y) {return x + y;},
+                    [length](Acc x) {return static_cast<T>(x / length);});
+}
+template<typename T>
+Tensor<T> Tensor<T>::Max(int axis) const {
+  using Acc = AccumulatorType<T>;
+  return ReduceAxis(axis, std::numeric_limits<Acc>::lowest(), [](Acc x, Acc y) {return x < y ? y : x;},
+                    [](Acc x) {return static_cast<T>(x);});
+}
+template<typename T>
+Tensor<T> Tensor<T>::Min(int axis) const {
+  using Acc = AccumulatorType<T>;
+  return ReduceAxis(axis, std::numeric_limits<Acc>::max(), [](Acc x, Acc y) {return y < x ? y : x;},
+                    [](Acc x) {return static_cast<T>(x);});
+}
+// End of Reductions ---------------------------------------------------
+
+// Multiplication Shape ---------------------------------
+template<typename T>
+std::vector<int> Tensor<T>::BatchMultipliedWith(const Tensor<T>& other) const {
+  if (getOrder() < 2 || other.getOrder() < 2) 
+    throw std::invalid_argument("Tensor Batched Multiplication- Tensor is not Matrix");
+
+  if (getDimension(getOrder() - 1) != other.getDimension(other.getOrder() - 2))
+    throw std::invalid_argument("Tensor Batched Multiplication- Multiplcation Dimension Mismatch");
+
+  // Batch axes are broadcasted, then matrix axes appended
+  std::vector<int> this_batch = getShape();
+  std::vector<int> other_batch = other.getShape();
+  this_batch.resize(getOrder() - 2);
+  other_batch.resize(other.getOrder() - 2);
+
+  std::vector<int> res_dim = BroadcastShapes(this_batch, other_batch);
+  res_dim.push_back(getDimension(getOrder() - 2));
+  res_dim.push_back(other.getDimension(other.getOrder() - 1));
+
+  return res_dim;
+}
+/** Epilogue Conversion */
+template<typename T>
+GemmEpilogue<T> Tensor<T>::ToGemmEpilogue(const MatmulEpilogue<T>& epilogue) const {
+  const int res_rows = getDimension(getOrder() - 2);
+  const int res_cols = getDimension(getOrder() - 1);
+
+  // Epilogue operands, checked once for all chunks
+  GemmEpilogue<T> gemm_epilogue;
+  gemm_epilogue.alpha = epilogue.alpha;
+  gemm_epilogue.beta = epilogue.beta;
+  gemm_epilogue.bias_axis = epilogue.bias_axis;
+  gemm_epilogue.activation = epilogue.activation;
+  if (epilogue.bias != nullptr) {
+    const int bias_size = epilogue.bias_axis == BiasAxis::kRow ? res_cols : res_rows;
+    if (epilogue.bias->getCapacity() != bias_size)
+      throw std::invalid_argument("Tensor Multiplication- Bias Dimension Mismatch");
+    gemm_epilogue.bias = epilogue.bias->elements_->data();
+  }
+  if (epilogue.residual != nullptr) {
+    if (epilogue.residual->getShape() != getShape())
+      throw std::invalid_argument("Tensor Multiplication- Residual Dimension Mismatch");
+    gemm_epilogue.residual_ld = res_cols;
+  }
+
+  return gemm_epilogue;
+}
+template<typename T>
+std::vector<int> Tensor<T>::MultipliedWith(const Tensor<T>& other) const {
+  if (getOrder() < 2 || other.getOrder() < 2) 
+    throw std::invalid_argument("Tensor Multiplication- Tensor is not Matrix");
+
+  if (getDimension(getOrder() - 1) != other.getDimension(other.getOrder() - 2))
+    throw std::invalid_argument("Tensor Multiplication- Multiplcation Dimension Mismatch");
+  
+  // [res_rows, inter_dim] * [inter_dim, res_cols]
+  int res_rows = getDimension(getOrder() - 2);
+  int res_cols = other.getDimension(other.getOrder() - 1);
+  
+  // given A[dim1..., r, k] and B[dim2..., k, c], the resulting product is of dim C[dim1..., dim2..., r, c]
+  std::vector<int> res_dim;
+  res_dim.reserve(this->getOrder() + other.getOrder() - 2);
+  for (int i = 0; i < this->getOrder() - 2; ++i) {
+    res_dim.push_back(this->getDimension(i));
+  }
+  for (int i = 0; i < other.getOrder() - 2; ++i) {
+    res_dim.push_back(other.getDimension(i));
+  }
+  res_dim.push_back(res_rows);
+  res_dim.push_back(res_cols);
+
+  return res_dim;
+}
+// End of Multiplication Shape --------------------------
+
 // Broadcast --------------------------------------------
 template<typename T>
 std::vector<int> Tensor<T>::BroadcastedWith(const Tensor<T>& other) const {
-  int this_order = getOrder();
-  int other_order = other.getOrder();
-  int max_order = std::max(this_order, other_order);
+  return BroadcastShapes(getShape(), other.getShape());
+}
+template<typename T>
+std::vector<int> Tensor<T>::BroadcastShapes(const std::vector<int>& shape_one, const std::vector<int>& shape_two) {
+  int one_order = shape_one.size();
+  int two_order = shape_two.size();
+  int max_order = std::max(one_order, two_order);
 
   std::vector<int> res_dim(max_order);
 
   // traverse dimensions backwards
-  int this_idx = getOrder() - 1;
-  int other_idx = other.getOrder() - 1;
+  int one_idx = one_order - 1;
+  int two_idx = two_order - 1;
   int res_idx = max_order - 1;
 
-  int this_dim, other_dim;
-  while (this_idx >= 0 && other_idx >= 0) { // both index are within order bound
-    this_dim = getDimension(this_idx);
-    other_dim = other.getDimension(other_idx);
+  int one_dim, two_dim;
+  while (one_idx >= 0 && two_idx >= 0) { // both index are within order bound
+    one_dim = shape_one[one_idx];
+    two_dim = shape_two[two_idx];
 
-    if (this_dim == other_dim) {
-      res_dim[res_idx] = this_dim;
-    } else if (this_dim == 1 || other_dim == 1) {
-      res_dim[res_idx] = this_dim * other_dim; // either must be 1
+    if (one_dim == two_dim) {
+      res_dim[res_idx] = one_dim;
+    } else if (one_dim == 1 || two_dim == 1) {
+      res_dim[res_idx] = one_dim * two_dim; // either must be 1
     } else {
       throw std::runtime_error("Tensor Broadcast- Incompatible Tensors by Broadcast");
     }
 
     // dec counter
-    --this_idx;
-    --other_idx;
+    --one_idx;
+    --two_idx;
     --res_idx;
   }
 
-  // either or both of this_idx or other is depleted
-  while (this_idx >= 0) {
-    res_dim[res_idx] = getDimension(this_idx);
+  // either or both of one_idx or two_idx is depleted
+  while (one_idx >= 0) {
+    res_dim[res_idx] = shape_one[one_idx];
     --res_idx;
-    --this_idx;
+    --one_idx;
   }
-  while (other_idx >= 0) {
-    res_dim[res_idx] = other.getDimension(other_idx);
+  while (two_idx >= 0) {
+    res_dim[res_idx] = shape_two[two_idx];
     --res_idx;
-    --other_idx;
+    --two_idx;
   }
 
   return res_dim;
 }
 // End of Broadcast --------------------------------------------
+
+// Reduction --------------------------------------------
+/** Axis Reduction */
+template<typename T>
+template<typename Acc, typename CombineOp, typename FinalizeOp>
+Tensor<T> Tensor<T>::ReduceAxis(int axis, Acc identity, CombineOp combine, FinalizeOp finalize) const {
+  if (axis < 0 || axis >= getOrder()) throw std::invalid_argument("Tensor Reduction- Axis Out of Bounds");
+
+  std::vector<int> shape = getShape();
+  int outer = 1, inner = 1;
+  for (int i = 0; i < axis; ++i) outer *= shape[i];
+  for (int i = axis + 1; i < getOrder(); ++i) inner *= shape[i];
+  const int length = shape[axis];
+
+  shape.erase(shape.begin() + axis);
+  if (shape.empty()) shape.push_back(1);
+  Tensor<T> res(shape);
+
+  std::vector<Acc> reduced(static_cast<size_t>(outer) * inner);
+  ParallelReduceAxis(data(), outer, length, inner, identity, combine, reduced.data());
+  T* res_data = res.data();
+  for (size_t i = 0; i < reduced.size(); ++i) {
+    res_data[i] = finalize(reduced[i]);
+  }
+
+  return res;
+}
+// End of Reduction -------------------------------------
 // End of Tensor ===================================================================
 
 } // util
-} // cpp_nn
\ No newline at end of file
+} // cpp_nn
@@ -9,6 +9,7 @@ template <typename T>
 TensorReference<T>::TensorReference(const Tensor<T>& tensor, const int chunkOrder)
     : elements_(tensor.elements_), 
       kChunkOrder(chunkOrder),
+      kChunkCapacity(ComputeChunkCapacity(tensor, chunkOrder)),
       index_address_(0) {
   if (kChunkOrder < 0) 
     throw std::invalid_argument("TensorReference Constructor- Negative ChunkOrder");
@@ -20,28 +21,23 @@ template <typename T>
 TensorReference<T>::TensorReference(const Tensor<T>& tensor, const int chunkOrder, const std::vector<int>& indices) 
     : elements_(tensor.elements_), 
       kChunkOrder(chunkOrder), 
+      kChunkCapacity(ComputeChunkCapacity(tensor, chunkOrder)),
       index_address_(0) {
   if (kChunkOrder < 0) 
     throw std::invalid_argument("TensorReference Constructor- Negative ChunkOrder");
   if (tensor.getOrder() < kChunkOrder) 
     throw std::invalid_argument("TensorReference Constructor- Insufficient Tensor Order for TensorChunk");
-  if (index_.size() != tensor.getOrder() - kChunkOrder) 
+  if (indices.size() != tensor.getOrder() - kChunkOrder) 
     throw std::invalid_argument("TensorReference Index Constructor- Index Order Mismatch"); 
-  
-  // Set ChunkCapacity
-  kChunkCapacity = 1;
-  for (int i = indices.size(); i < tensor.getOrder(); ++i) {
-    kChunkCapacity *= tensor.getDimension(i);
-  }
 
   // Compute index_address_ while checking
   int block_size = kChunkCapacity;
-  for (int i = index_.size() - 1; i >= 0; --i) {
-    if (index_[i] < 0 || index_[i] >= elements_->getDimension(i)) {
+  for (int i = indices.size() - 1; i >= 0; --i) {
+    if (indices[i] < 0 || indices[i] >= elements_->getDimension(i)) {
       throw std::invalid_argument("TensorReference Index Constructor- Index Out of Bounds"); 
     }
 
-    index_address_ += block_size * index_[i];
+    index_address_ += block_size * indices[i];
     block_size *= tensor.getDimension(i);
   }
 }
@@ -56,16 +52,29 @@ TensorReference<T>::TensorReference(const Tensor<T>& tensor, const std::initiali
 // End of Constructor --------------------------------------------------
 
 // Housekeeping --------------------------------------------------------
+/** Chunk Capacity */
+template<typename T>
+int TensorReference<T>::ComputeChunkCapacity(const Tensor<T>& tensor, const int chunkOrder) {
+  // Order checks are left to constructor
+  int capacity = 1;
+  for (int i = tensor.getOrder() - chunkOrder; i < tensor.getOrder(); ++i) {
+    if (i >= 0) capacity *= tensor.getDimension(i);
+  }
+  return capacity;
+}
 /** Chunk Index to Addres */
 template<typename T>
 int TensorReference<T>::ConvertToAddress(const std::vector<int>& indices) const {
+  if (indices.size() != kChunkOrder) 
+    throw std::invalid_argument("TensorReference ElementGetter- Index Order Mismatch"); 
+
   int chunk_address = 0;
   int block_size = 1;
-  for (int i = 0; i < kChunkOrder; ++i) {
-    int idx = elements_->getOrder() - 1 - i;
-    if (index[i] >= 0 && index[i] < elements_->getDimension(i)) {
-      chunk_address += block_size * index[i];
-      block_size *= elements_->getDimension(i);
+  for (int i = kChunkOrder - 1; i >= 0; --i) {
+    int axis = elements_->getOrder() - kChunkOrder + i;
+    if (indices[i] >= 0 && indices[i] < elements_->getDimension(axis)) {
+      chunk_address += block_size * indices[i];
+      block_size *= elements_->getDimension(axis);
     } else {
       throw std::invalid_argument("TensorReference ElementGetter- Index Out of Bounds"); 
     }
@@ -134,33 +143,32 @@ MatrixReference<T>::MatrixReference(const Tensor<T>& tensor, const std::initiali
 template<typename T>
 T& MatrixReference<T>::getElement(int row, int col) {
   // Best to bypass forming index-vectors at all
-  return elements_->getElementByAddress(this->index_address_ + kCols * row + col);
+  return this->elements_->getElementByAddress(this->index_address_ + kCols * row + col);
 }
 template<typename T>
 const T& MatrixReference<T>::getElement(int row, int col) const {
   // Best to bypass forming index-vectors at all
-  return elements_->getElementByAddress(this->index_address_ + kCols * row + col);
+  return this->elements_->getElementByAddress(this->index_address_ + kCols * row + col);
 }
 // End of Accessors ----------------------------------------------------
 
 // Matrix Operations ---------------------------------------------------
 /** Multiply Into */
 template<typename T>
-void MatrixReference<T>::MultiplyInto(const MatrixReference<T>& A, const MatrixReference<T>& B) {
+template<typename Acc>
+void MatrixReference<T>::MultiplyInto(const MatrixReference<T>& A, const MatrixReference<T>& B,
+                                      const GemmEpilogue<T>& epilogue /*= GemmEpilogue<T>()*/) {
   if (this->kRows != A.kRows ||
       this->kCols != B.kCols ||
-      A.kCols != B.kCols) {
+      A.kCols != B.kRows) {
     throw std::invalid_argument("MatrixReference Multiplication- Dimension Mismatch"); 
   }
 
-  for (int r = 0; r < kRows; ++r) {
-    for (int c = 0; c < kCols; ++c) {
-      getElement(r, c) = 0;
-      for (int k = 0; k < A.kCols; ++k) {
-        getElement(r, c) += A.getElement(r, k) * B.getElement(k, c);
-      }
-    }
-  }
+  // Chunks are row-major, so rows are kCols apart and columns are adjacent
+  Gemm<T, Acc>(kRows, kCols, A.kCols,
+       A.data(), A.kCols, 1,
+       B.data(), B.kCols, 1,
+       data(), kCols, epilogue);
 }
 // End of Matrix Operations --------------------------------------------
 // End of MatrixReference ==========================================================
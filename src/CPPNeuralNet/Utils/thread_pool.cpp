@@ -0,0 +1,342 @@
+#include "CPPNeuralNet/Utils/thread_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace cpp_nn {
+namespace util {
+
+namespace {
+constexpr int kTasksPerThread = 4;  // Tasks dealt per thread, slack for stealing to even out
+
+thread_local int parallel_depth = 0;
+thread_local int worker_index = 0;  // Queue of current thread, 0 for threads outside the pool
+
+/** Marks calling thread as inside a task for its lifetime */
+struct ParallelRegion {
+  ParallelRegion() {++parallel_depth;}
+  ~ParallelRegion() {--parallel_depth;}
+};
+
+int DefaultNumThreads() {
+  if (const char* env = std::getenv("CPP_NN_NUM_THREADS")) {
+    const int requested = std::atoi(env);
+    if (requested > 0) return requested;
+  }
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+bool DefaultPinning() {
+  const char* env = std::getenv("CPP_NN_PIN_THREADS");
+  return env != nullptr && std::atoi(env) > 0;
+}
+
+/** CPUs of each NUMA node this process may run on, nodes without any left out.
+ *  Read from sysfs, a single node of all allowed CPUs when that is unavailable. */
+std::vector<std::vector<int>> NodeCpus() {
+  std::vector<std::vector<int>> nodes;
+#if defined(__linux__)
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return {{}};
+
+  for (int node = 0; ; ++node) {
+    std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    if (!file) break;
+    // cpulist is comma separated ranges, ie) 0-3,8-11
+    std::vector<int> cpus;
+    std::string range;
+    while (std::getline(file, range, ',')) {
+      std::istringstream stream(range);
+      int first;
+      if (!(stream >> first)) continue;
+      int last = first;
+      char dash;
+      if (stream >> dash) stream >> last;
+      for (int cpu = first; cpu <= last; ++cpu) {
+        if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)) cpus.push_back(cpu);
+      }
+    }
+    if (!cpus.empty()) nodes.push_back(cpus);
+  }
+  if (nodes.empty()) {
+    nodes.emplace_back();
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &allowed)) nodes.back().push_back(cpu);
+    }
+  }
+#else
+  nodes.emplace_back();
+#endif
+  return nodes;
+}
+
+std::mutex global_pool_mutex;
+std::unique_ptr<ThreadPool> global_pool;
+int requested_threads = 0;  // 0 for default
+bool pin_threads = DefaultPinning();
+std::atomic<bool> socket_partitioning(false);
+
+/** Creates global pool from current settings, global_pool_mutex held */
+void ResetGlobalPool() {
+  global_pool.reset();
+  global_pool = std::make_unique<ThreadPool>(requested_threads > 0 ? requested_threads : DefaultNumThreads(),
+                                             pin_threads);
+}
+} // namespace
+
+/** One Run call, shared by its tasks */
+struct ThreadPool::Job {
+  RangeFunction fn;
+  void* context;
+  Schedule schedule;
+  bool detached;                    // Submitted task, owns itself and its context
+  int pending;
+  std::mutex mutex;
+  std::condition_variable done;
+  std::exception_ptr error;
+};
+
+// ThreadPool ======================================================================
+ThreadPool::ThreadPool(int num_threads, bool pinned /*= false*/)
+    : num_threads_(std::max(1, num_threads)), thread_cpus_(num_threads_, -1), thread_nodes_(num_threads_, 0),
+      queued_(0), stopping_(false) {
+  for (int i = 0; i < num_threads_; ++i) {
+    queues_.push_back(std::make_unique<TaskQueue>());
+  }
+#if defined(__linux__)
+  if (pinned) {
+    // Threads are dealt to nodes in contiguous blocks, as tasks are dealt to threads,
+    //  and take the CPUs of their node in turn
+    const std::vector<std::vector<int>> nodes = NodeCpus();
+    const int num_nodes = nodes.size();
+    for (int q = 0; q < num_threads_; ++q) {
+      const int node = static_cast<long long>(q) * num_nodes / num_threads_;
+      const int node_first = (static_cast<long long>(node) * num_threads_ + num_nodes - 1) / num_nodes;
+      thread_nodes_[q] = node;
+      if (q > 0 && !nodes[node].empty()) thread_cpus_[q] = nodes[node][(q - node_first) % nodes[node].size()];
+    }
+  }
+#else
+  (void)pinned;
+#endif
+  workers_.reserve(num_threads_ - 1);
+  for (int i = 1; i < num_threads_; ++i) {
+    workers_.emplace_back(&ThreadPool::WorkerLoop, this, i);
+  }
+}
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+  // Without workers, submitted tasks are still waiting
+  while (RunOneTask(0)) {}
+}
+
+bool ThreadPool::InParallelRegion() {
+  return parallel_depth > 0;
+}
+
+void ThreadPool::RunTask(const Task& task) {
+  Job& job = *task.job;
+  if (job.detached) {
+    // Not a parallel region, so kernels it calls still spread over the pool
+    std::function<void()>* function = static_cast<std::function<void()>*>(job.context);
+    try {
+      (*function)();
+    } catch (...) {}
+    delete function;
+    delete &job;
+    return;
+  }
+  try {
+    ParallelRegion region;
+    job.fn(job.context, task.begin, task.end);
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(job.mutex);
+    if (!job.error) job.error = std::current_exception();
+  }
+  // Job lives on its caller's stack, and must not be touched once pending reaches 0 and lock is released
+  std::lock_guard<std::mutex> lock(job.mutex);
+  if (--job.pending == 0) job.done.notify_all();
+}
+
+bool ThreadPool::RunOneTask(int index) {
+  Task task;
+  bool found = false;
+  {
+    TaskQueue& own = *queues_[index];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.tasks.empty()) {
+      task = own.tasks.front();
+      own.tasks.pop_front();
+      found = true;
+    }
+  }
+  for (int offset = 1; !found && offset < num_threads_; ++offset) {
+    const int victim_index = (index + offset) % num_threads_;
+    TaskQueue& victim = *queues_[victim_index];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      if (victim.tasks.back().job->schedule == Schedule::kNodeLocal &&
+          thread_nodes_[victim_index] != thread_nodes_[index]) continue;
+      task = victim.tasks.back();
+      victim.tasks.pop_back();
+      found = true;
+    }
+  }
+  if (!found) return false;
+
+  queued_.fetch_sub(1);
+  RunTask(task);
+  return true;
+}
+
+void ThreadPool::WorkerLoop(int index) {
+  worker_index = index;
+#if defined(__linux__)
+  if (thread_cpus_[index] >= 0) {
+    cpu_set_t cpu;
+    CPU_ZERO(&cpu);
+    CPU_SET(thread_cpus_[index], &cpu);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu), &cpu);
+  }
+#endif
+  while (true) {
+    if (RunOneTask(index)) continue;
+
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    if (stopping_ && queued_.load() == 0) return;
+    if (queued_.load() > 0) {
+      // What is left is kept to other nodes
+      lock.unlock();
+      std::this_thread::yield();
+      continue;
+    }
+    wake_.wait(lock, [this]() {return stopping_ || queued_.load() > 0;});
+  }
+}
+
+void ThreadPool::Run(int begin, int end, int grain_size, RangeFunction fn, void* context,
+                     Schedule schedule /*= Schedule::kDynamic*/) {
+  const int size = end - begin;
+  if (size <= 0) return;
+  grain_size = std::max(1, grain_size);
+  const int num_tasks = std::min((size + grain_size - 1) / grain_size, num_threads_ * kTasksPerThread);
+  if (num_tasks <= 1 || num_threads_ == 1 || InParallelRegion()) {
+    ParallelRegion region;
+    fn(context, begin, end);
+    return;
+  }
+
+  Job job;
+  job.fn = fn;
+  job.context = context;
+  job.schedule = schedule;
+  job.detached = false;
+  job.pending = num_tasks;
+
+  // Task t covers [begin + t * size / num_tasks, ...), and thread q receives a contiguous run of tasks,
+  //  so each thread walks its own stretch of memory
+  for (int q = 0; q < num_threads_; ++q) {
+    const int task_begin = static_cast<long long>(q) * num_tasks / num_threads_;
+    const int task_end = static_cast<long long>(q + 1) * num_tasks / num_threads_;
+    std::lock_guard<std::mutex> lock(queues_[q]->mutex);
+    for (int t = task_begin; t < task_end; ++t) {
+      queues_[q]->tasks.push_back({&job,
+                                   begin + static_cast<int>(static_cast<long long>(t) * size / num_tasks),
+                                   begin + static_cast<int>(static_cast<long long>(t + 1) * size / num_tasks)});
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    queued_.fetch_add(num_tasks);
+  }
+  wake_.notify_all();
+
+  // Caller works from its own queue until nothing is left to take, then waits for tasks still running.
+  // Waits are short, so tasks queued meanwhile are not left to threads that are themselves waiting
+  const int self = worker_index;
+  while (true) {
+    while (RunOneTask(self)) {}
+    std::unique_lock<std::mutex> lock(job.mutex);
+    if (job.done.wait_for(lock, std::chrono::microseconds(200), [&job]() {return job.pending == 0;})) break;
+  }
+  if (job.error) std::rethrow_exception(job.error);
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+  Job* job = new Job();
+  job->fn = nullptr;
+  job->context = new std::function<void()>(std::move(task));
+  job->schedule = Schedule::kDynamic;
+  job->detached = true;
+  job->pending = 1;
+  {
+    std::lock_guard<std::mutex> lock(queues_[worker_index]->mutex);
+    queues_[worker_index]->tasks.push_back({job, 0, 1});
+  }
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    queued_.fetch_add(1);
+  }
+  wake_.notify_one();
+}
+
+bool ThreadPool::RunPendingTask() {
+  return RunOneTask(worker_index);
+}
+// End of ThreadPool ===============================================================
+
+ThreadPool& GlobalThreadPool() {
+  std::lock_guard<std::mutex> lock(global_pool_mutex);
+  if (!global_pool) ResetGlobalPool();
+  return *global_pool;
+}
+
+void SetNumThreads(int num_threads) {
+  std::lock_guard<std::mutex> lock(global_pool_mutex);
+  requested_threads = std::max(0, num_threads);
+  ResetGlobalPool();
+}
+int getNumThreads() {
+  return GlobalThreadPool().getNumThreads();
+}
+
+// NUMA ----------------------------------------------------------------
+void SetThreadAffinity(bool pinned) {
+  std::lock_guard<std::mutex> lock(global_pool_mutex);
+  pin_threads = pinned;
+  ResetGlobalPool();
+}
+bool getThreadAffinity() {
+  std::lock_guard<std::mutex> lock(global_pool_mutex);
+  return pin_threads;
+}
+int getNumaNodes() {
+  static const int num_nodes = std::max<int>(1, NodeCpus().size());
+  return num_nodes;
+}
+void SetSocketPartitioning(bool enabled) {
+  socket_partitioning.store(enabled);
+}
+bool getSocketPartitioning() {
+  return socket_partitioning.load();
+}
+// End of NUMA ---------------------------------------------------------
+
+} // util
+} // cpp_nn
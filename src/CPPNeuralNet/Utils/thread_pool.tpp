@@ -0,0 +1,24 @@
+#include "CPPNeuralNet/Utils/thread_pool.h"
+
+namespace cpp_nn {
+namespace util {
+
+/** Parallel For */
+template<typename RangeOp>
+void ParallelFor(int begin, int end, RangeOp range_op, int grain_size /*= 1*/,
+                 Schedule schedule /*= Schedule::kDynamic*/) {
+  if (end <= begin) return;
+  if (grain_size < 1) grain_size = 1;
+  // Too small to split, or already inside a task
+  if (end - begin <= grain_size || ThreadPool::InParallelRegion()) {
+    range_op(begin, end);
+    return;
+  }
+
+  GlobalThreadPool().Run(begin, end, grain_size, [](void* context, int b, int e) {
+    (*static_cast<RangeOp*>(context))(b, e);
+  }, &range_op, schedule);
+}
+
+} // util
+} // cpp_nn
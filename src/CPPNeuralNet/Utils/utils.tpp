@@ -0,0 +1,13 @@
+#include "CPPNeuralNet/Utils/utils.h"
+
+namespace cpp_nn {
+namespace util {
+
+/** Parallel Chunking */
+template<typename ChunkOp>
+void ParallelChunks(int size, ChunkOp chunk_op, int grain_size /*= kParallelGrainSize*/) {
+  ParallelFor(0, size, chunk_op, grain_size);
+}
+
+} // util
+} // cpp_nn
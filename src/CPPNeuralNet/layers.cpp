@@ -0,0 +1,526 @@
+#include "CPPNeuralNet/layer.h"
+#include "CPPNeuralNet/layers.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+namespace cpp_nn {
+
+// Layer ===========================================================================
+Layer::Layer()
+    : max_batch_(0), output_(std::vector<int>{0}), input_gradient_(std::vector<int>{0}), input_(nullptr) {}
+
+// Setup ---------------------------------------------------------------
+void Layer::Prepare(const std::vector<int>& input_shape, int max_batch,
+                    double* output_storage /*= nullptr*/, double* input_gradient_storage /*= nullptr*/) {
+  if (max_batch <= 0) throw std::invalid_argument("Layer Prepare- Non-Positive Batch");
+  for (const int& dim : input_shape) {
+    if (dim <= 0) throw std::invalid_argument("Layer Prepare- Invalid Shape");
+  }
+
+  output_shape_ = ComputeOutputShape(input_shape);
+  input_shape_ = input_shape;
+  max_batch_ = max_batch;
+  input_ = nullptr;
+
+  std::vector<int> input_dims{max_batch};
+  input_dims.insert(input_dims.end(), input_shape_.begin(), input_shape_.end());
+  std::vector<int> output_dims{max_batch};
+  output_dims.insert(output_dims.end(), output_shape_.begin(), output_shape_.end());
+  output_ = output_storage != nullptr ? util::Tensor<double>::View(output_dims, output_storage)
+                                      : util::Tensor<double>(output_dims);
+  input_gradient_ = input_gradient_storage != nullptr ? util::Tensor<double>::View(input_dims, input_gradient_storage)
+                                                      : util::Tensor<double>(input_dims);
+
+  PrepareWorkspace(max_batch);
+}
+// End of Setup --------------------------------------------------------
+
+// Passes --------------------------------------------------------------
+const util::Tensor<double>& Layer::Forward(const util::Tensor<double>& input) {
+  if (!isPrepared()) throw std::invalid_argument("Layer Forward- Layer Not Prepared");
+  if (input.getOrder() != static_cast<int>(input_shape_.size()) + 1) {
+    throw std::invalid_argument("Layer Forward- Input Shape Mismatch");
+  }
+  for (size_t i = 0; i < input_shape_.size(); ++i) {
+    if (input.getDimension(i + 1) != input_shape_[i]) {
+      throw std::invalid_argument("Layer Forward- Input Shape Mismatch");
+    }
+  }
+  const int batch = input.getDimension(0);
+  if (batch > max_batch_) throw std::invalid_argument("Layer Forward- Batch Exceeds Prepared");
+
+  // Leading dimension is the only one that changes, storage is kept
+  if (output_.getDimension(0) != batch) {
+    std::vector<int> output_dims = output_.getShape();
+    output_dims[0] = batch;
+    output_.Resize(output_dims);
+  }
+  input_ = &input;
+  ForwardInto(input, output_);
+  return output_;
+}
+const util::Tensor<double>& Layer::Backward(const util::Tensor<double>& output_gradient) {
+  if (input_ == nullptr) throw std::invalid_argument("Layer Backward- No Forward Pass");
+  if (output_gradient.getOrder() != output_.getOrder()) {
+    throw std::invalid_argument("Layer Backward- Gradient Shape Mismatch");
+  }
+  for (int i = 0; i < output_.getOrder(); ++i) {
+    if (output_gradient.getDimension(i) != output_.getDimension(i)) {
+      throw std::invalid_argument("Layer Backward- Gradient Shape Mismatch");
+    }
+  }
+
+  const int batch = input_->getDimension(0);
+  if (input_gradient_.getDimension(0) != batch) {
+    std::vector<int> input_dims = input_gradient_.getShape();
+    input_dims[0] = batch;
+    input_gradient_.Resize(input_dims);
+  }
+  BackwardInto(*input_, output_, output_gradient, input_gradient_);
+  return input_gradient_;
+}
+// End of Passes -------------------------------------------------------
+
+// Parameters ----------------------------------------------------------
+void Layer::ZeroGradients() {
+  for (util::Tensor<double>* gradient : Gradients()) {
+    std::fill(gradient->data(), gradient->data() + gradient->getCapacity(), 0.0);
+  }
+}
+// End of Parameters ---------------------------------------------------
+// End of Layer ====================================================================
+
+// Activation ======================================================================
+ActivationLayer::ActivationLayer(util::Activation activation) : activation_(activation) {}
+
+std::vector<int> ActivationLayer::ComputeOutputShape(const std::vector<int>& input_shape) const {
+  return input_shape;
+}
+void ActivationLayer::ForwardInto(const util::Tensor<double>& input, util::Tensor<double>& output) {
+  const double* x = input.data();
+  double* y = output.data();
+  util::ParallelChunks(input.getCapacity(), [&](int begin, int end) {
+    for (int i = begin; i < end; ++i) {
+      y[i] = util::ApplyActivation(activation_, x[i]);
+    }
+  });
+}
+void ActivationLayer::BackwardInto(const util::Tensor<double>& input, const util::Tensor<double>& output,
+                                   const util::Tensor<double>& output_gradient,
+                                   util::Tensor<double>& input_gradient) {
+  const double* y = output.data();
+  // In place, x was overwritten by y, which has the same sign for ReLU
+  const double* x = BackwardReadsInput() ? input.data() : y;
+  const double* dy = output_gradient.data();
+  double* dx = input_gradient.data();
+  util::ParallelChunks(input.getCapacity(), [&](int begin, int end) {
+    for (int i = begin; i < end; ++i) {
+      dx[i] = dy[i] * util::ActivationDerivative(activation_, x[i], y[i]);
+    }
+  });
+}
+// End of Activation ===============================================================
+
+// Linear ==========================================================================
+Linear::Linear(int in_features, int out_features, util::Activation activation /*= kNone*/,
+               unsigned int seed /*= 0*/)
+    : in_features_(in_features), out_features_(out_features), activation_(activation),
+      weight_(std::vector<int>{std::max(in_features, 0), std::max(out_features, 0)}),
+      bias_(std::vector<int>{std::max(out_features, 0)}, 0.0),
+      weight_gradient_(std::vector<int>{std::max(in_features, 0), std::max(out_features, 0)}, 0.0),
+      bias_gradient_(std::vector<int>{std::max(out_features, 0)}, 0.0) {
+  if (in_features <= 0 || out_features <= 0) throw std::invalid_argument("Linear Constructor- Non-Positive Features");
+
+  const bool rectifier = activation == util::Activation::kReLU || activation == util::Activation::kGELU;
+  const double limit = rectifier ? std::sqrt(6.0 / in_features) : std::sqrt(6.0 / (in_features + out_features));
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<double> distribution(-limit, limit);
+  for (int i = 0; i < weight_.getCapacity(); ++i) {
+    weight_.data()[i] = distribution(generator);
+  }
+}
+
+bool Linear::FuseActivation(util::Activation activation) {
+  if (activation_ != util::Activation::kNone) return false;
+  activation_ = activation;
+  return true;
+}
+
+std::vector<int> Linear::ComputeOutputShape(const std::vector<int>& input_shape) const {
+  if (input_shape.size() != 1 || input_shape[0] != in_features_) {
+    throw std::invalid_argument("Linear ComputeOutputShape- Invalid Shape");
+  }
+  return {out_features_};
+}
+void Linear::PrepareWorkspace(int max_batch) {
+  sparse_weight_.Pack(in_features_, out_features_, weight_.data(), out_features_);
+  delta_.assign(static_cast<size_t>(max_batch) * out_features_, 0.0);
+  pre_activation_.assign(activation_ == util::Activation::kGELU ? delta_.size() : 0, 0.0);
+  column_sums_.assign(out_features_, 0.0);
+}
+void Linear::ForwardInto(const util::Tensor<double>& input, util::Tensor<double>& output) {
+  const int batch = input.getDimension(0);
+
+  util::GemmEpilogue<double> epilogue;
+  epilogue.bias = bias_.data();
+  epilogue.bias_axis = util::BiasAxis::kRow;
+  // Weights may have changed since last pass, ie) by an optimizer step
+  sparse_weight_.Refill(weight_.data(), out_features_);
+  double* z = activation_ == util::Activation::kGELU ? pre_activation_.data() : output.data();
+  if (activation_ != util::Activation::kGELU) epilogue.activation = activation_;
+  if (!util::StructuredSparseGemm(batch, input.data(), in_features_, 1, sparse_weight_, z, out_features_, epilogue)) {
+    util::Gemm(batch, out_features_, in_features_, input.data(), in_features_, 1,
+               weight_.data(), out_features_, 1, z, out_features_, epilogue);
+  }
+  if (activation_ != util::Activation::kGELU) return;
+
+  double* y = output.data();
+  util::ParallelChunks(output.getCapacity(), [&](int begin, int end) {
+    for (int i = begin; i < end; ++i) {
+      y[i] = util::ApplyActivation(util::Activation::kGELU, z[i]);
+    }
+  });
+}
+void Linear::BackwardInto(const util::Tensor<double>& input, const util::Tensor<double>& output,
+                          const util::Tensor<double>& output_gradient,
+                          util::Tensor<double>& input_gradient) {
+  const int batch = input.getDimension(0);
+  const int size = batch * out_features_;
+
+  // dZ = dC/dy * f', where f' is read off y, or off z for GELU
+  const double* dz = output_gradient.data();
+  if (activation_ != util::Activation::kNone) {
+    const double* y = output.data();
+    const double* z = activation_ == util::Activation::kGELU ? pre_activation_.data() : y;
+    const double* dy = output_gradient.data();
+    double* delta = delta_.data();
+    util::ParallelChunks(size, [&](int begin, int end) {
+      for (int i = begin; i < end; ++i) {
+        delta[i] = dy[i] * util::ActivationDerivative(activation_, z[i], y[i]);
+      }
+    });
+    dz = delta;
+  }
+
+  util::GemmEpilogue<double> accumulate;
+  accumulate.beta = 1;
+  // dW += x^T * dZ, x^T read as column-major view of x
+  util::Gemm(in_features_, out_features_, batch, input.data(), 1, in_features_,
+             dz, out_features_, 1, weight_gradient_.data(), out_features_, accumulate);
+  sparse_weight_.Mask(weight_gradient_.data(), out_features_);
+  // dx = dZ * W^T, W^T read as column-major view of W, or packed with W's blocks
+  if (!util::StructuredSparseGemmTransposed(batch, dz, out_features_, 1, sparse_weight_,
+                                            input_gradient.data(), in_features_)) {
+    util::Gemm(batch, in_features_, out_features_, dz, out_features_, 1,
+               weight_.data(), 1, out_features_, input_gradient.data(), in_features_);
+  }
+
+  // db += sum of dZ over batch
+  util::ParallelReduceAxis(dz, 1, batch, out_features_, 0.0, [](double x, double y) {return x + y;},
+                           column_sums_.data());
+  double* db = bias_gradient_.data();
+  for (int i = 0; i < out_features_; ++i) {
+    db[i] += column_sums_[i];
+  }
+}
+// End of Linear ===================================================================
+
+// Conv2D ==========================================================================
+Conv2D::Conv2D(int in_channels, int out_channels, int kernel_h, int kernel_w,
+               const Conv2DOptions& options /*= Conv2DOptions()*/, unsigned int seed /*= 0*/)
+    : in_channels_(in_channels), out_channels_(out_channels), kernel_h_(kernel_h), kernel_w_(kernel_w),
+      options_(options),
+      weight_(std::vector<int>{std::max(kernel_h, 0), std::max(kernel_w, 0), std::max(in_channels, 0),
+                               std::max(out_channels, 0)}),
+      bias_(std::vector<int>{std::max(out_channels, 0)}, 0.0),
+      weight_gradient_(std::vector<int>{std::max(kernel_h, 0), std::max(kernel_w, 0), std::max(in_channels, 0),
+                                        std::max(out_channels, 0)}, 0.0),
+      bias_gradient_(std::vector<int>{std::max(out_channels, 0)}, 0.0),
+      height_(0), width_(0), out_height_(0), out_width_(0), tile_pixels_(0), num_slots_(1) {
+  if (in_channels <= 0 || out_channels <= 0 || kernel_h <= 0 || kernel_w <= 0) {
+    throw std::invalid_argument("Conv2D Constructor- Non-Positive Size");
+  }
+  if (options.stride_h <= 0 || options.stride_w <= 0 || options.dilation_h <= 0 || options.dilation_w <= 0 ||
+      options.pad_h < 0 || options.pad_w < 0) {
+    throw std::invalid_argument("Conv2D Constructor- Invalid Options");
+  }
+
+  const int window = kernel_h * kernel_w;
+  const double limit = std::sqrt(6.0 / (window * in_channels + window * out_channels));
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<double> distribution(-limit, limit);
+  for (int i = 0; i < weight_.getCapacity(); ++i) {
+    weight_.data()[i] = distribution(generator);
+  }
+}
+
+bool Conv2D::isPointwise() const {
+  return kernel_h_ == 1 && kernel_w_ == 1 && options_.stride_h == 1 && options_.stride_w == 1 &&
+         options_.pad_h == 0 && options_.pad_w == 0;
+}
+
+std::vector<int> Conv2D::ComputeOutputShape(const std::vector<int>& input_shape) const {
+  const bool nchw = options_.layout == ImageLayout::kNCHW;
+  if (input_shape.size() != 3 || input_shape[nchw ? 0 : 2] != in_channels_) {
+    throw std::invalid_argument("Conv2D ComputeOutputShape- Invalid Shape");
+  }
+  const int height = input_shape[nchw ? 1 : 0];
+  const int width = input_shape[nchw ? 2 : 1];
+  const int out_height = height + 2 * options_.pad_h - options_.dilation_h * (kernel_h_ - 1) - 1;
+  const int out_width = width + 2 * options_.pad_w - options_.dilation_w * (kernel_w_ - 1) - 1;
+  if (out_height < 0 || out_width < 0) throw std::invalid_argument("Conv2D ComputeOutputShape- Invalid Shape");
+  if (nchw) return {out_channels_, out_height / options_.stride_h + 1, out_width / options_.stride_w + 1};
+  return {out_height / options_.stride_h + 1, out_width / options_.stride_w + 1, out_channels_};
+}
+void Conv2D::PrepareWorkspace(int max_batch) {
+  const bool nchw = options_.layout == ImageLayout::kNCHW;
+  const std::vector<int>& input_shape = getInputShape();
+  const std::vector<int>& output_shape = getOutputShape();
+  height_ = input_shape[nchw ? 1 : 0];
+  width_ = input_shape[nchw ? 2 : 1];
+  out_height_ = output_shape[nchw ? 1 : 0];
+  out_width_ = output_shape[nchw ? 2 : 1];
+
+  // NHWC tiles may run across samples, NCHW tiles stay in one
+  const int pixels = out_height_ * out_width_;
+  const int max_pixels = nchw ? pixels : max_batch * pixels;
+  const int depth = kernel_h_ * kernel_w_ * in_channels_;
+  if (isPointwise()) {
+    tile_pixels_ = max_pixels;
+  } else {
+    const int fitting = static_cast<int>(kConvTileBytes / sizeof(double)) / depth / util::kGemmNR * util::kGemmNR;
+    tile_pixels_ = std::min(max_pixels, std::max(fitting, util::kGemmMC));
+  }
+  const size_t tile_size = isPointwise() ? 0 : static_cast<size_t>(tile_pixels_) * depth;
+  // Forward unfolds a tile per pool thread at once, backward one at a time
+  num_slots_ = std::max(1, util::getNumThreads());
+  columns_.assign(num_slots_ * tile_size, 0.0);
+  column_gradient_.assign(tile_size, 0.0);
+  channel_sums_.assign(static_cast<size_t>(max_batch) * out_channels_, 0.0);
+}
+
+const double* Conv2D::Unfold(const double* x, int n, int first, int count, double* columns, int& ld) const {
+  const int channels = in_channels_;
+  const int depth = kernel_h_ * kernel_w_ * channels;
+  const int pixels = out_height_ * out_width_;
+  const Conv2DOptions& o = options_;
+
+  if (options_.layout == ImageLayout::kNHWC) {
+    ld = depth;
+    if (isPointwise()) return x + static_cast<size_t>(first) * channels;
+    // Row per pixel, each kernel tap a contiguous run of channels
+    util::ParallelFor(0, count, [&](int row_begin, int row_end) {
+      for (int r = row_begin; r < row_end; ++r) {
+        const int sample = (first + r) / pixels;
+        const int pixel = (first + r) % pixels;
+        const int oy = pixel / out_width_, ox = pixel % out_width_;
+        double* row = columns + static_cast<size_t>(r) * depth;
+        for (int ky = 0; ky < kernel_h_; ++ky) {
+          const int iy = oy * o.stride_h - o.pad_h + ky * o.dilation_h;
+          for (int kx = 0; kx < kernel_w_; ++kx) {
+            const int ix = ox * o.stride_w - o.pad_w + kx * o.dilation_w;
+            double* tap = row + (ky * kernel_w_ + kx) * channels;
+            if (iy < 0 || iy >= height_ || ix < 0 || ix >= width_) {
+              std::fill(tap, tap + channels, 0.0);
+            } else {
+              const double* source = x + ((static_cast<size_t>(sample) * height_ + iy) * width_ + ix) * channels;
+              std::copy(source, source + channels, tap);
+            }
+          }
+        }
+      }
+    }, std::max(1, util::kParallelGrainSize / depth));
+    return columns;
+  }
+
+  const double* sample = x + static_cast<size_t>(n) * channels * height_ * width_;
+  if (isPointwise()) {
+    ld = pixels;
+    return sample + first;
+  }
+  // Row per kernel tap and channel, running over pixels
+  ld = count;
+  util::ParallelFor(0, depth, [&](int k_begin, int k_end) {
+    for (int k = k_begin; k < k_end; ++k) {
+      const int c = k % channels;
+      const int ky = k / channels / kernel_w_, kx = k / channels % kernel_w_;
+      const double* plane = sample + static_cast<size_t>(c) * height_ * width_;
+      double* row = columns + static_cast<size_t>(k) * count;
+      int oy = first / out_width_, ox = first % out_width_;
+      for (int j = 0; j < count; ++j) {
+        const int iy = oy * o.stride_h - o.pad_h + ky * o.dilation_h;
+        const int ix = ox * o.stride_w - o.pad_w + kx * o.dilation_w;
+        row[j] = (iy < 0 || iy >= height_ || ix < 0 || ix >= width_) ? 0.0 : plane[iy * width_ + ix];
+        if (++ox == out_width_) {
+          ox = 0;
+          ++oy;
+        }
+      }
+    }
+  }, std::max(1, util::kParallelGrainSize / count));
+  return columns;
+}
+void Conv2D::Fold(const double* column_gradient, int n, int first, int count, double* dx) const {
+  const int channels = in_channels_;
+  const int depth = kernel_h_ * kernel_w_ * channels;
+  const int pixels = out_height_ * out_width_;
+  const Conv2DOptions& o = options_;
+  // Windows overlap, so threads split input channels, never pixels
+  const int grain = std::max(1, util::kParallelGrainSize / (count * kernel_h_ * kernel_w_));
+
+  if (options_.layout == ImageLayout::kNHWC) {
+    util::ParallelFor(0, channels, [&](int c_begin, int c_end) {
+      for (int r = 0; r < count; ++r) {
+        const int sample = (first + r) / pixels;
+        const int pixel = (first + r) % pixels;
+        const int oy = pixel / out_width_, ox = pixel % out_width_;
+        const double* row = column_gradient + static_cast<size_t>(r) * depth;
+        for (int ky = 0; ky < kernel_h_; ++ky) {
+          const int iy = oy * o.stride_h - o.pad_h + ky * o.dilation_h;
+          if (iy < 0 || iy >= height_) continue;
+          for (int kx = 0; kx < kernel_w_; ++kx) {
+            const int ix = ox * o.stride_w - o.pad_w + kx * o.dilation_w;
+            if (ix < 0 || ix >= width_) continue;
+            const double* tap = row + (ky * kernel_w_ + kx) * channels;
+            double* target = dx + ((static_cast<size_t>(sample) * height_ + iy) * width_ + ix) * channels;
+            for (int c = c_begin; c < c_end; ++c) target[c] += tap[c];
+          }
+        }
+      }
+    }, grain);
+    return;
+  }
+
+  double* sample = dx + static_cast<size_t>(n) * channels * height_ * width_;
+  util::ParallelFor(0, channels, [&](int c_begin, int c_end) {
+    for (int c = c_begin; c < c_end; ++c) {
+      double* plane = sample + static_cast<size_t>(c) * height_ * width_;
+      for (int ky = 0; ky < kernel_h_; ++ky) {
+        for (int kx = 0; kx < kernel_w_; ++kx) {
+          const double* row = column_gradient + static_cast<size_t>((ky * kernel_w_ + kx) * channels + c) * count;
+          int oy = first / out_width_, ox = first % out_width_;
+          for (int j = 0; j < count; ++j) {
+            const int iy = oy * o.stride_h - o.pad_h + ky * o.dilation_h;
+            const int ix = ox * o.stride_w - o.pad_w + kx * o.dilation_w;
+            if (iy >= 0 && iy < height_ && ix >= 0 && ix < width_) plane[iy * width_ + ix] += row[j];
+            if (++ox == out_width_) {
+              ox = 0;
+              ++oy;
+            }
+          }
+        }
+      }
+    }
+  }, grain);
+}
+
+void Conv2D::ForwardInto(const util::Tensor<double>& input, util::Tensor<double>& output) {
+  const bool nchw = options_.layout == ImageLayout::kNCHW;
+  const int batch = input.getDimension(0);
+  const int pixels = out_height_ * out_width_;
+  const int depth = kernel_h_ * kernel_w_ * in_channels_;
+  const int tiles_per_sample = (pixels + tile_pixels_ - 1) / tile_pixels_;
+  const int num_tiles = nchw ? batch * tiles_per_sample : (batch * pixels + tile_pixels_ - 1) / tile_pixels_;
+
+  util::GemmEpilogue<double> epilogue;
+  epilogue.bias = bias_.data();
+  epilogue.bias_axis = nchw ? util::BiasAxis::kCol : util::BiasAxis::kRow;
+  const double* x = input.data();
+  double* y = output.data();
+  if (!nchw) packed_weight_.Pack(depth, out_channels_, weight_.data(), out_channels_, 1);
+  // Slot s unfolds tiles [s * num_tiles / slots, (s + 1) * num_tiles / slots) into its own buffer
+  const int slots = std::min(num_slots_, num_tiles);
+  const size_t tile_size = isPointwise() ? 0 : static_cast<size_t>(tile_pixels_) * depth;
+  util::ParallelFor(0, slots, [&](int slot_begin, int slot_end) {
+    for (int s = slot_begin; s < slot_end; ++s) {
+      double* columns = columns_.data() + s * tile_size;
+      const int tile_end = static_cast<int>(static_cast<long long>(s + 1) * num_tiles / slots);
+      for (int t = static_cast<int>(static_cast<long long>(s) * num_tiles / slots); t < tile_end; ++t) {
+        const int n = nchw ? t / tiles_per_sample : 0;
+        const int first = (nchw ? t % tiles_per_sample : t) * tile_pixels_;
+        const int count = std::min(tile_pixels_, (nchw ? pixels : batch * pixels) - first);
+        int ld = 0;
+        const double* col = Unfold(x, n, first, count, columns, ld);
+        if (nchw) {
+          // y_n[O, pixels] = W^T * col
+          util::Gemm(out_channels_, count, depth, weight_.data(), 1, out_channels_, col, ld, 1,
+                     y + static_cast<size_t>(n) * out_channels_ * pixels + first, pixels, epilogue);
+        } else {
+          util::GemmPacked(count, col, ld, 1, packed_weight_, y + static_cast<size_t>(first) * out_channels_,
+                           out_channels_, epilogue);
+        }
+      }
+    }
+  });
+}
+void Conv2D::BackwardInto(const util::Tensor<double>& input, const util::Tensor<double>& output,
+                          const util::Tensor<double>& output_gradient,
+                          util::Tensor<double>& input_gradient) {
+  const bool nchw = options_.layout == ImageLayout::kNCHW;
+  const int batch = input.getDimension(0);
+  const int pixels = out_height_ * out_width_;
+  const int depth = kernel_h_ * kernel_w_ * in_channels_;
+  const int tiles_per_sample = (pixels + tile_pixels_ - 1) / tile_pixels_;
+  const int num_tiles = nchw ? batch * tiles_per_sample : (batch * pixels + tile_pixels_ - 1) / tile_pixels_;
+
+  const double* x = input.data();
+  const double* dy = output_gradient.data();
+  double* dx = input_gradient.data();
+  // Pointwise dcol is dx itself, written whole by Gemm. Otherwise folded tiles add into it
+  if (!isPointwise()) {
+    util::ParallelChunks(input_gradient.getCapacity(), [&](int begin, int end) {
+      std::fill(dx + begin, dx + end, 0.0);
+    });
+  }
+
+  if (!nchw) packed_weight_.Pack(out_channels_, depth, weight_.data(), 1, out_channels_);
+
+  util::GemmEpilogue<double> accumulate;
+  accumulate.beta = 1;
+  // Tiles in order, as every one adds into dC/dW. Each Gemm, unfold and fold splits among threads
+  for (int t = 0; t < num_tiles; ++t) {
+    const int n = nchw ? t / tiles_per_sample : 0;
+    const int first = (nchw ? t % tiles_per_sample : t) * tile_pixels_;
+    const int count = std::min(tile_pixels_, (nchw ? pixels : batch * pixels) - first);
+    int ld = 0;
+    const double* col = Unfold(x, n, first, count, columns_.data(), ld);
+    double* dcol = column_gradient_.data();
+
+    if (nchw) {
+      const double* dy_tile = dy + static_cast<size_t>(n) * out_channels_ * pixels + first;
+      if (isPointwise()) dcol = dx + static_cast<size_t>(n) * in_channels_ * pixels + first;
+      // dW += col * dy_n^T,  dcol = W * dy_n
+      util::Gemm(depth, out_channels_, count, col, ld, 1, dy_tile, 1, pixels,
+                 weight_gradient_.data(), out_channels_, accumulate);
+      util::Gemm(depth, count, out_channels_, weight_.data(), out_channels_, 1, dy_tile, pixels, 1, dcol, ld);
+    } else {
+      const double* dy_tile = dy + static_cast<size_t>(first) * out_channels_;
+      if (isPointwise()) dcol = dx + static_cast<size_t>(first) * in_channels_;
+      // dW += col^T * dy,  dcol = dy * W^T
+      util::Gemm(depth, out_channels_, count, col, 1, ld, dy_tile, out_channels_, 1,
+                 weight_gradient_.data(), out_channels_, accumulate);
+      util::GemmPacked(count, dy_tile, out_channels_, 1, packed_weight_, dcol, ld);
+    }
+    if (!isPointwise()) Fold(dcol, n, first, count, dx);
+  }
+
+  // db += sum of dy over batch and pixels
+  double* db = bias_gradient_.data();
+  if (nchw) {
+    util::ParallelReduceAxis(dy, batch * out_channels_, pixels, 1, 0.0, [](double a, double b) {return a + b;},
+                             channel_sums_.data());
+    for (int n = 0; n < batch; ++n) {
+      for (int o = 0; o < out_channels_; ++o) db[o] += channel_sums_[n * out_channels_ + o];
+    }
+  } else {
+    util::ParallelReduceAxis(dy, 1, batch * pixels, out_channels_, 0.0, [](double a, double b) {return a + b;},
+                             channel_sums_.data());
+    for (int o = 0; o < out_channels_; ++o) db[o] += channel_sums_[o];
+  }
+}
+// End of Conv2D ===================================================================
+
+} // cpp_nn
@@ -0,0 +1,111 @@
+#include "CPPNeuralNet/losses.h"
+#include "CPPNeuralNet/Utils/utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace cpp_nn {
+
+namespace {
+/** Checks logits and labels, and returns number of classes */
+int CheckInputs(const util::Tensor<double>& logits, const std::vector<int>& labels, const char* method) {
+  if (logits.getOrder() != 2) {
+    throw std::invalid_argument(std::string("SoftmaxCrossEntropy ") + method + "- Invalid Shape");
+  }
+  const int batch = logits.getDimension(0);
+  const int classes = logits.getDimension(1);
+  if (static_cast<int>(labels.size()) != batch) {
+    throw std::invalid_argument(std::string("SoftmaxCrossEntropy ") + method + "- Label Count Mismatch");
+  }
+  for (const int& label : labels) {
+    if (label < 0 || label >= classes) {
+      throw std::invalid_argument(std::string("SoftmaxCrossEntropy ") + method + "- Label Out Of Range");
+    }
+  }
+  return classes;
+}
+
+/** Logsumexp of a row in one pass, rescaling the running sum whenever the max grows */
+double LogSumExp(const double* z, int classes) {
+  double max = -std::numeric_limits<double>::infinity();
+  double sum = 0;
+  for (int c = 0; c < classes; ++c) {
+    if (z[c] > max) {
+      sum = sum * std::exp(max - z[c]) + 1;
+      max = z[c];
+    } else {
+      sum += std::exp(z[c] - max);
+    }
+  }
+  return max + std::log(sum);
+}
+} // namespace
+
+SoftmaxCrossEntropy::SoftmaxCrossEntropy() : gradient_(std::vector<int>{0, 0}) {}
+
+double SoftmaxCrossEntropy::Compute(const util::Tensor<double>& logits, const std::vector<int>& labels,
+                                    util::Tensor<double>& gradient) {
+  const int classes = CheckInputs(logits, labels, "Compute");
+  if (gradient.getShape() != logits.getShape()) {
+    throw std::invalid_argument("SoftmaxCrossEntropy Compute- Gradient Shape Mismatch");
+  }
+  const int batch = logits.getDimension(0);
+  if (batch == 0) return 0;
+
+  row_losses_.resize(batch);
+  const double scale = 1.0 / batch;
+  const double* z = logits.data();
+  double* dz = gradient.data();
+  util::ParallelFor(0, batch, [&](int first_row, int last_row) {
+    for (int r = first_row; r < last_row; ++r) {
+      const double* z_row = z + static_cast<size_t>(r) * classes;
+      double* dz_row = dz + static_cast<size_t>(r) * classes;
+      // Read before the row may be overwritten in place
+      const double target = z_row[labels[r]];
+      const double max = *std::max_element(z_row, z_row + classes);
+      // exp is taken once per element, kept in gradient and normalized after
+      double sum = 0;
+      for (int c = 0; c < classes; ++c) {
+        dz_row[c] = std::exp(z_row[c] - max);
+        sum += dz_row[c];
+      }
+      row_losses_[r] = max + std::log(sum) - target;
+      const double normalizer = scale / sum;
+      for (int c = 0; c < classes; ++c) {
+        dz_row[c] *= normalizer;
+      }
+      dz_row[labels[r]] -= scale;
+    }
+  }, std::max(1, util::kParallelGrainSize / std::max(classes, 1)));
+
+  double loss = 0;
+  for (const double& row_loss : row_losses_) loss += row_loss;
+  return loss * scale;
+}
+double SoftmaxCrossEntropy::Compute(const util::Tensor<double>& logits, const std::vector<int>& labels) {
+  if (logits.getOrder() == 2 && logits.getShape() != gradient_.getShape()) gradient_.Resize(logits.getShape());
+  return Compute(logits, labels, gradient_);
+}
+double SoftmaxCrossEntropy::Loss(const util::Tensor<double>& logits, const std::vector<int>& labels) {
+  const int classes = CheckInputs(logits, labels, "Loss");
+  const int batch = logits.getDimension(0);
+  if (batch == 0) return 0;
+
+  row_losses_.resize(batch);
+  const double* z = logits.data();
+  util::ParallelFor(0, batch, [&](int first_row, int last_row) {
+    for (int r = first_row; r < last_row; ++r) {
+      const double* z_row = z + static_cast<size_t>(r) * classes;
+      row_losses_[r] = LogSumExp(z_row, classes) - z_row[labels[r]];
+    }
+  }, std::max(1, util::kParallelGrainSize / std::max(classes, 1)));
+
+  double loss = 0;
+  for (const double& row_loss : row_losses_) loss += row_loss;
+  return loss / batch;
+}
+
+} // cpp_nn
@@ -0,0 +1,250 @@
+#include "CPPNeuralNet/model.h"
+#include "CPPNeuralNet/layers.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+
+namespace cpp_nn {
+
+namespace {
+/** Doubles per arena buffer are rounded up to this, so every buffer starts on a cache line */
+constexpr size_t kArenaAlignment = util::kTensorAlignment / sizeof(double);
+
+size_t AlignedSize(size_t size) {
+  return (size + kArenaAlignment - 1) / kArenaAlignment * kArenaAlignment;
+}
+size_t ShapeSize(const std::vector<int>& shape) {
+  size_t size = 1;
+  for (const int& dim : shape) size *= dim;
+  return size;
+}
+} // namespace
+
+Model::Model()
+    : max_batch_(0), num_fused_(0), input_(nullptr), unplanned_size_(0),
+      flat_parameters_(std::vector<int>{0}), flat_gradients_(std::vector<int>{0}) {}
+
+// Layers --------------------------------------------------------------
+void Model::AddLayer(std::unique_ptr<Layer> layer) {
+  if (layer == nullptr) throw std::invalid_argument("Model AddLayer- Null Layer");
+  layers_.push_back(std::move(layer));
+  max_batch_ = 0;
+}
+void Model::AddCheckpoint() {
+  checkpoints_.push_back(layers_.size());
+  max_batch_ = 0;
+}
+// End of Layers -------------------------------------------------------
+
+// Build ---------------------------------------------------------------
+void Model::Build(const std::vector<int>& input_shape, int max_batch, bool fuse /*= true*/) {
+  if (layers_.empty()) throw std::invalid_argument("Model Build- No Layers");
+  if (max_batch <= 0) throw std::invalid_argument("Model Build- Non-Positive Batch");
+  max_batch_ = 0;
+  input_ = nullptr;
+
+  // Fusion, Linear -> Activation. Checkpoints past the removed layer move back with it
+  num_fused_ = 0;
+  for (size_t i = 0; fuse && i + 1 < layers_.size(); ++i) {
+    Linear* linear = dynamic_cast<Linear*>(layers_[i].get());
+    ActivationLayer* activation = dynamic_cast<ActivationLayer*>(layers_[i + 1].get());
+    if (linear != nullptr && activation != nullptr && linear->FuseActivation(activation->getActivation())) {
+      layers_.erase(layers_.begin() + i + 1);
+      ++num_fused_;
+      for (int& checkpoint : checkpoints_) {
+        if (checkpoint > static_cast<int>(i) + 1) --checkpoint;
+      }
+    }
+  }
+
+  const int num_layers = layers_.size();
+  std::sort(checkpoints_.begin(), checkpoints_.end());
+  checkpoints_.erase(std::unique(checkpoints_.begin(), checkpoints_.end()), checkpoints_.end());
+  checkpoints_.erase(std::remove_if(checkpoints_.begin(), checkpoints_.end(), [&](int checkpoint) {
+    return checkpoint <= 0 || checkpoint >= num_layers;
+  }), checkpoints_.end());
+  std::vector<int> segment_bounds{0};
+  segment_bounds.insert(segment_bounds.end(), checkpoints_.begin(), checkpoints_.end());
+  segment_bounds.push_back(num_layers);
+
+  std::vector<std::vector<int>> shapes{input_shape};
+  unplanned_size_ = 0;
+  for (const std::unique_ptr<Layer>& layer : layers_) {
+    shapes.push_back(layer->InferOutputShape(shapes.back()));
+    unplanned_size_ += AlignedSize(max_batch * ShapeSize(shapes[shapes.size() - 2]));
+    unplanned_size_ += AlignedSize(max_batch * ShapeSize(shapes.back()));
+  }
+
+  // Memory plan, over the steps of Forward then Backward, one layer pass each.
+  //  Every write of an output or dC/dx is a buffer. An output written again, by a segment run forward again,
+  //  takes over storage of its first write, as a layer has one output buffer
+  std::vector<util::BufferLifetime> buffers;
+  std::vector<std::vector<int>> outputs(num_layers); // Buffers of each layer's output, in order written
+  std::vector<int> input_gradients(num_layers);
+  int step = 0;
+  auto write = [&](const std::vector<int>& shape, int in_place_of) {
+    util::BufferLifetime buffer;
+    buffer.size = max_batch * ShapeSize(shape);
+    buffer.first = buffer.last = step;
+    buffer.in_place_of = in_place_of;
+    buffers.push_back(buffer);
+    return static_cast<int>(buffers.size()) - 1;
+  };
+  auto read_output = [&](int layer) {
+    if (layer >= 0) buffers[outputs[layer].back()].last = step;
+  };
+  auto forward = [&](int layer) {
+    read_output(layer - 1);
+    outputs[layer].push_back(write(shapes[layer + 1], outputs[layer].empty() ? -1 : outputs[layer][0]));
+    ++step;
+  };
+
+  for (int i = 0; i < num_layers; ++i) forward(i);
+  read_output(num_layers - 1); // By caller, up to Backward
+  for (int k = segment_bounds.size() - 2; k >= 0; --k) {
+    const int begin = segment_bounds[k], end = segment_bounds[k + 1];
+    for (int i = begin; end != num_layers && i < end; ++i) forward(i);
+    for (int i = end - 1; i >= begin; --i) {
+      if (layers_[i]->BackwardReadsInput()) read_output(i - 1);
+      if (layers_[i]->BackwardReadsOutput()) read_output(i);
+      if (i + 1 < num_layers) buffers[input_gradients[i + 1]].last = step;
+      // dC/dy is dead once read, so can always be taken over
+      const bool in_place = i + 1 < num_layers && layers_[i]->BackwardInPlace();
+      input_gradients[i] = write(shapes[i], in_place ? input_gradients[i + 1] : -1);
+      ++step;
+    }
+  }
+  // Output written over input, when every write of the input is dead at the matching write of the output
+  for (int i = 1; i < num_layers; ++i) {
+    if (!layers_[i]->ForwardInPlace() || outputs[i].size() != outputs[i - 1].size()) continue;
+    bool in_place = true;
+    for (size_t j = 0; j < outputs[i].size(); ++j) {
+      in_place = in_place && buffers[outputs[i - 1][j]].last == buffers[outputs[i][j]].first;
+    }
+    if (in_place) buffers[outputs[i][0]].in_place_of = outputs[i - 1][0];
+  }
+  memory_plan_ = util::PlanMemory(buffers, kArenaAlignment);
+
+  arena_.resize(memory_plan_.arena_size);
+  util::FirstTouchFill(arena_.data(), static_cast<int>(arena_.size()), 0.0);
+  for (int i = 0; i < num_layers; ++i) {
+    layers_[i]->Prepare(shapes[i], max_batch, arena_.data() + memory_plan_.offsets[outputs[i][0]],
+                        arena_.data() + memory_plan_.offsets[input_gradients[i]]);
+  }
+
+  FlattenParameters();
+  input_shape_ = input_shape;
+  max_batch_ = max_batch;
+}
+void Model::FlattenParameters() {
+  std::vector<util::Tensor<double>*> parameters = Parameters();
+  std::vector<util::Tensor<double>*> gradients = Gradients();
+  std::vector<size_t> offsets;
+  size_t size = 0;
+  for (const util::Tensor<double>* parameter : parameters) {
+    offsets.push_back(size);
+    size += AlignedSize(parameter->getCapacity());
+  }
+
+  // Values are copied out before views are moved, as they may be views into the buffers being replaced
+  std::vector<double, util::TensorAllocator<double>> parameter_buffer(size);
+  std::vector<double, util::TensorAllocator<double>> gradient_buffer(size);
+  util::FirstTouchFill(parameter_buffer.data(), static_cast<int>(size), 0.0);
+  util::FirstTouchFill(gradient_buffer.data(), static_cast<int>(size), 0.0);
+  for (size_t i = 0; i < parameters.size(); ++i) {
+    std::copy(parameters[i]->data(), parameters[i]->data() + parameters[i]->getCapacity(),
+              parameter_buffer.data() + offsets[i]);
+    std::copy(gradients[i]->data(), gradients[i]->data() + gradients[i]->getCapacity(),
+              gradient_buffer.data() + offsets[i]);
+    *parameters[i] = util::Tensor<double>::View(parameters[i]->getShape(), parameter_buffer.data() + offsets[i]);
+    *gradients[i] = util::Tensor<double>::View(gradients[i]->getShape(), gradient_buffer.data() + offsets[i]);
+  }
+  parameter_buffer_.swap(parameter_buffer);
+  gradient_buffer_.swap(gradient_buffer);
+  flat_parameters_ = util::Tensor<double>::View({static_cast<int>(size)}, parameter_buffer_.data());
+  flat_gradients_ = util::Tensor<double>::View({static_cast<int>(size)}, gradient_buffer_.data());
+}
+// End of Build --------------------------------------------------------
+
+// Passes --------------------------------------------------------------
+const util::Tensor<double>& Model::Forward(const util::Tensor<double>& input) {
+  if (!isBuilt()) throw std::invalid_argument("Model Forward- Model Not Built");
+
+  input_ = &input;
+  const util::Tensor<double>* current = &input;
+  for (const std::unique_ptr<Layer>& layer : layers_) {
+    current = &layer->Forward(*current);
+  }
+  return *current;
+}
+const util::Tensor<double>& Model::Backward(const util::Tensor<double>& output_gradient) {
+  if (!isBuilt()) throw std::invalid_argument("Model Backward- Model Not Built");
+  if (input_ == nullptr) throw std::invalid_argument("Model Backward- No Forward Pass");
+
+  const util::Tensor<double>* current = &output_gradient;
+  const int num_layers = layers_.size();
+  int end = num_layers;
+  for (int k = checkpoints_.size(); k >= 0; --k) {
+    const int begin = k > 0 ? checkpoints_[k - 1] : 0;
+    if (end != num_layers) {
+      // Outputs of segment died in Forward, all but its input
+      const util::Tensor<double>* x = begin > 0 ? &layers_[begin - 1]->getOutput() : input_;
+      for (int i = begin; i < end; ++i) x = &layers_[i]->Forward(*x);
+    }
+    for (int i = end - 1; i >= begin; --i) current = &layers_[i]->Backward(*current);
+    end = begin;
+  }
+  return *current;
+}
+// End of Passes -------------------------------------------------------
+
+// Parameters ----------------------------------------------------------
+std::vector<util::Tensor<double>*> Model::Parameters() {
+  std::vector<util::Tensor<double>*> res;
+  for (const std::unique_ptr<Layer>& layer : layers_) {
+    std::vector<util::Tensor<double>*> parameters = layer->Parameters();
+    res.insert(res.end(), parameters.begin(), parameters.end());
+  }
+  return res;
+}
+std::vector<util::Tensor<double>*> Model::Gradients() {
+  std::vector<util::Tensor<double>*> res;
+  for (const std::unique_ptr<Layer>& layer : layers_) {
+    std::vector<util::Tensor<double>*> gradients = layer->Gradients();
+    res.insert(res.end(), gradients.begin(), gradients.end());
+  }
+  return res;
+}
+void Model::ZeroGradients() {
+  if (!isBuilt()) {
+    for (const std::unique_ptr<Layer>& layer : layers_) {
+      layer->ZeroGradients();
+    }
+    return;
+  }
+  util::ParallelChunks(static_cast<int>(gradient_buffer_.size()), [&](int begin, int end) {
+    std::fill(gradient_buffer_.data() + begin, gradient_buffer_.data() + end, 0.0);
+  });
+}
+void Model::Save(std::ostream& out) const {
+  if (!isBuilt()) throw std::invalid_argument("Model Save- Model Not Built");
+  const uint64_t size = parameter_buffer_.size();
+  out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+  out.write(reinterpret_cast<const char*>(parameter_buffer_.data()), size * sizeof(double));
+  if (!out) throw std::invalid_argument("Model Save- Stream Error");
+}
+void Model::Load(std::istream& in) {
+  if (!isBuilt()) throw std::invalid_argument("Model Load- Model Not Built");
+  uint64_t size = 0;
+  in.read(reinterpret_cast<char*>(&size), sizeof(size));
+  if (!in) throw std::invalid_argument("Model Load- Stream Error");
+  if (size != parameter_buffer_.size()) throw std::invalid_argument("Model Load- Parameter Count Mismatch");
+  in.read(reinterpret_cast<char*>(parameter_buffer_.data()), size * sizeof(double));
+  if (!in) throw std::invalid_argument("Model Load- Stream Error");
+}
+// End of Parameters ---------------------------------------------------
+
+} // cpp_nn
@@ -0,0 +1,252 @@
+#include "CPPNeuralNet/optimizers.h"
+#include "CPPNeuralNet/Utils/utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace cpp_nn {
+
+namespace {
+/** Elements per partial sum of GradientNorm, fixed so the sum does not depend on thread count */
+constexpr int kNormBlock = 1 << 13;
+
+/** Runs span on the parts of group's tensors within [begin, end) of its flat range */
+template<typename SpanOp>
+void SpansIn(const std::vector<util::Tensor<double>*>& parameters, const std::vector<util::Tensor<double>*>& gradients,
+             const std::vector<int>& bounds, int begin, int end, SpanOp& span) {
+  int t = std::upper_bound(bounds.begin(), bounds.end(), begin) - bounds.begin() - 1;
+  for (int index = begin; index < end; ++t) {
+    const int span_end = std::min(end, bounds[t + 1]);
+    if (span_end > index) {
+      const int offset = index - bounds[t];
+      span(parameters[t]->data() + offset, gradients[t]->data() + offset, index, span_end - index);
+    }
+    index = std::max(index, span_end);
+  }
+}
+
+struct AdamCoefficients {
+  double scale;         // Of gradient, by clipping
+  double beta1, beta2;
+  double step_size;     // learning_rate / (1 - beta1^t)
+  double root_bias2;    // 1 / sqrt(1 - beta2^t)
+  double epsilon;
+  double l2;            // Weight decay added to gradient, Adam
+  double decay;         // Factor on w, 1 - learning_rate * weight_decay, AdamW
+};
+
+/** Adam Update of count elements, in one pass */
+void AdamSpan(double* w, const double* dw, double* m, double* v, int count, const AdamCoefficients& c) {
+  int i = 0;
+#if defined(__AVX2__)
+  const __m256d scale = _mm256_set1_pd(c.scale), l2 = _mm256_set1_pd(c.l2), decay = _mm256_set1_pd(c.decay);
+  const __m256d beta1 = _mm256_set1_pd(c.beta1), one_beta1 = _mm256_set1_pd(1 - c.beta1);
+  const __m256d beta2 = _mm256_set1_pd(c.beta2), one_beta2 = _mm256_set1_pd(1 - c.beta2);
+  const __m256d step_size = _mm256_set1_pd(c.step_size), root_bias2 = _mm256_set1_pd(c.root_bias2);
+  const __m256d epsilon = _mm256_set1_pd(c.epsilon);
+  for (; i + 4 <= count; i += 4) {
+    const __m256d w4 = _mm256_loadu_pd(w + i);
+    const __m256d g = _mm256_add_pd(_mm256_mul_pd(scale, _mm256_loadu_pd(dw + i)), _mm256_mul_pd(l2, w4));
+    const __m256d m4 = _mm256_add_pd(_mm256_mul_pd(beta1, _mm256_loadu_pd(m + i)), _mm256_mul_pd(one_beta1, g));
+    const __m256d v4 = _mm256_add_pd(_mm256_mul_pd(beta2, _mm256_loadu_pd(v + i)),
+                                     _mm256_mul_pd(one_beta2, _mm256_mul_pd(g, g)));
+    const __m256d denominator = _mm256_add_pd(_mm256_mul_pd(_mm256_sqrt_pd(v4), root_bias2), epsilon);
+    _mm256_storeu_pd(m + i, m4);
+    _mm256_storeu_pd(v + i, v4);
+    _mm256_storeu_pd(w + i, _mm256_sub_pd(_mm256_mul_pd(decay, w4),
+                                          _mm256_div_pd(_mm256_mul_pd(step_size, m4), denominator)));
+  }
+#endif
+  for (; i < count; ++i) {
+    const double g = c.scale * dw[i] + c.l2 * w[i];
+    m[i] = c.beta1 * m[i] + (1 - c.beta1) * g;
+    v[i] = c.beta2 * v[i] + (1 - c.beta2) * (g * g);
+    w[i] = c.decay * w[i] - c.step_size * m[i] / (std::sqrt(v[i]) * c.root_bias2 + c.epsilon);
+  }
+}
+} // namespace
+
+// Optimizer =======================================================================
+Optimizer::Optimizer(double learning_rate, double weight_decay)
+    : learning_rate_(learning_rate), weight_decay_(weight_decay), max_gradient_norm_(0), num_steps_(0) {
+  if (learning_rate < 0 || weight_decay < 0) {
+    throw std::invalid_argument("Optimizer Constructor- Negative Hyperparameter");
+  }
+}
+
+template<typename SpanOp>
+void Optimizer::ForEachSpan(const Group& group, SpanOp span) const {
+  util::ParallelChunks(group.size(), [&](int begin, int end) {
+    SpansIn(group.parameters, group.gradients, group.bounds, begin, end, span);
+  });
+}
+
+// Parameters ----------------------------------------------------------
+void Optimizer::AddParameters(const std::vector<util::Tensor<double>*>& parameters,
+                              const std::vector<util::Tensor<double>*>& gradients) {
+  AddParameterGroup(parameters, gradients, learning_rate_, weight_decay_);
+}
+void Optimizer::AddParameterGroup(const std::vector<util::Tensor<double>*>& parameters,
+                                  const std::vector<util::Tensor<double>*>& gradients,
+                                  double learning_rate, double weight_decay) {
+  if (learning_rate < 0 || weight_decay < 0) {
+    throw std::invalid_argument("Optimizer AddParameterGroup- Negative Hyperparameter");
+  }
+  if (parameters.size() != gradients.size()) {
+    throw std::invalid_argument("Optimizer AddParameterGroup- Parameter Gradient Mismatch");
+  }
+  Group group;
+  group.bounds.push_back(0);
+  for (size_t i = 0; i < parameters.size(); ++i) {
+    if (parameters[i] == nullptr || gradients[i] == nullptr ||
+        parameters[i]->getCapacity() != gradients[i]->getCapacity()) {
+      throw std::invalid_argument("Optimizer AddParameterGroup- Parameter Gradient Mismatch");
+    }
+    group.bounds.push_back(group.bounds.back() + parameters[i]->getCapacity());
+  }
+  group.parameters = parameters;
+  group.gradients = gradients;
+  group.learning_rate = learning_rate;
+  group.weight_decay = weight_decay;
+  group.state_offset = state_.size();
+  state_.resize(state_.size() + static_cast<size_t>(getNumStates()) * group.size(), 0.0);
+  groups_.push_back(std::move(group));
+}
+void Optimizer::setLearningRate(double learning_rate) {
+  if (learning_rate < 0) throw std::invalid_argument("Optimizer setLearningRate- Negative Hyperparameter");
+  learning_rate_ = learning_rate;
+  for (Group& group : groups_) {
+    group.learning_rate = learning_rate;
+  }
+}
+void Optimizer::setMaxGradientNorm(double max_norm) {
+  if (max_norm < 0) throw std::invalid_argument("Optimizer setMaxGradientNorm- Negative Hyperparameter");
+  max_gradient_norm_ = max_norm;
+}
+// End of Parameters ---------------------------------------------------
+
+// Step ----------------------------------------------------------------
+double Optimizer::Step() {
+  ++num_steps_;
+  double norm = 0;
+  double scale = 1;
+  if (max_gradient_norm_ > 0) {
+    norm = GradientNorm();
+    if (norm > max_gradient_norm_) scale = max_gradient_norm_ / norm;
+  }
+  for (const Group& group : groups_) {
+    UpdateGroup(group, scale);
+  }
+  return norm;
+}
+double Optimizer::GradientNorm() const {
+  double sum = 0;
+  std::vector<double> partials;
+  for (const Group& group : groups_) {
+    const int num_blocks = (group.size() + kNormBlock - 1) / kNormBlock;
+    partials.assign(num_blocks, 0.0);
+    util::ParallelFor(0, num_blocks, [&](int first_block, int last_block) {
+      for (int b = first_block; b < last_block; ++b) {
+        double block_sum = 0;
+        auto square_sum = [&](double*, const double* g, int, int count) {
+          for (int i = 0; i < count; ++i) block_sum += g[i] * g[i];
+        };
+        SpansIn(group.parameters, group.gradients, group.bounds,
+                b * kNormBlock, std::min(group.size(), (b + 1) * kNormBlock), square_sum);
+        partials[b] = block_sum;
+      }
+    });
+    for (const double& partial : partials) sum += partial;
+  }
+  return std::sqrt(sum);
+}
+void Optimizer::ZeroGradients() {
+  for (const Group& group : groups_) {
+    ForEachSpan(group, [](double*, double* g, int, int count) {
+      std::fill(g, g + count, 0.0);
+    });
+  }
+}
+// End of Step ---------------------------------------------------------
+// End of Optimizer ================================================================
+
+// SGD =============================================================================
+SGD::SGD(double learning_rate, double momentum /*= 0*/, double weight_decay /*= 0*/, bool nesterov /*= false*/)
+    : Optimizer(learning_rate, weight_decay), momentum_(momentum), nesterov_(nesterov) {
+  if (momentum < 0) throw std::invalid_argument("SGD Constructor- Negative Hyperparameter");
+}
+
+void SGD::UpdateGroup(const Group& group, double gradient_scale) {
+  const double learning_rate = group.learning_rate;
+  const double weight_decay = group.weight_decay;
+  const double momentum = momentum_;
+  double* velocity = state_.data() + group.state_offset;
+
+  if (momentum == 0) {
+    ForEachSpan(group, [&](double* w, const double* dw, int, int count) {
+      for (int i = 0; i < count; ++i) {
+        w[i] -= learning_rate * (gradient_scale * dw[i] + weight_decay * w[i]);
+      }
+    });
+  } else if (!nesterov_) {
+    ForEachSpan(group, [&](double* w, const double* dw, int index, int count) {
+      double* v = velocity + index;
+      for (int i = 0; i < count; ++i) {
+        v[i] = momentum * v[i] + (gradient_scale * dw[i] + weight_decay * w[i]);
+        w[i] -= learning_rate * v[i];
+      }
+    });
+  } else {
+    ForEachSpan(group, [&](double* w, const double* dw, int index, int count) {
+      double* v = velocity + index;
+      for (int i = 0; i < count; ++i) {
+        const double g = gradient_scale * dw[i] + weight_decay * w[i];
+        v[i] = momentum * v[i] + g;
+        w[i] -= learning_rate * (g + momentum * v[i]);
+      }
+    });
+  }
+}
+// End of SGD ======================================================================
+
+// Adam ============================================================================
+Adam::Adam(double learning_rate, double beta1, double beta2, double epsilon, double weight_decay, bool decoupled)
+    : Optimizer(learning_rate, weight_decay), beta1_(beta1), beta2_(beta2), epsilon_(epsilon), decoupled_(decoupled) {
+  if (beta1 < 0 || beta1 >= 1 || beta2 < 0 || beta2 >= 1) throw std::invalid_argument("Adam Constructor- Invalid Beta");
+  if (epsilon < 0) throw std::invalid_argument("Adam Constructor- Negative Hyperparameter");
+}
+Adam::Adam(double learning_rate /*= 1e-3*/, double beta1 /*= 0.9*/, double beta2 /*= 0.999*/,
+           double epsilon /*= 1e-8*/, double weight_decay /*= 0*/)
+    : Adam(learning_rate, beta1, beta2, epsilon, weight_decay, false) {}
+
+void Adam::UpdateGroup(const Group& group, double gradient_scale) {
+  AdamCoefficients coefficients;
+  coefficients.scale = gradient_scale;
+  coefficients.beta1 = beta1_;
+  coefficients.beta2 = beta2_;
+  coefficients.step_size = group.learning_rate / (1 - std::pow(beta1_, getStepCount()));
+  coefficients.root_bias2 = 1 / std::sqrt(1 - std::pow(beta2_, getStepCount()));
+  coefficients.epsilon = epsilon_;
+  coefficients.l2 = decoupled_ ? 0 : group.weight_decay;
+  coefficients.decay = decoupled_ ? 1 - group.learning_rate * group.weight_decay : 1;
+
+  double* first_moment = state_.data() + group.state_offset;
+  double* second_moment = first_moment + group.size();
+  ForEachSpan(group, [&](double* w, const double* dw, int index, int count) {
+    AdamSpan(w, dw, first_moment + index, second_moment + index, count, coefficients);
+  });
+}
+// End of Adam =====================================================================
+
+// AdamW ===========================================================================
+AdamW::AdamW(double learning_rate /*= 1e-3*/, double beta1 /*= 0.9*/, double beta2 /*= 0.999*/,
+             double epsilon /*= 1e-8*/, double weight_decay /*= 1e-2*/)
+    : Adam(learning_rate, beta1, beta2, epsilon, weight_decay, true) {}
+// End of AdamW ====================================================================
+
+} // cpp_nn
@@ -0,0 +1,236 @@
+#include "gtest/gtest.h"
+
+#include "CPPNeuralNet/layer.h"
+#include "CPPNeuralNet/layers.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace cpp_nn {
+
+namespace {
+/** Direct convolution by its definition, with dC/dx, dC/dW and dC/db for given dC/dy */
+struct ReferenceConv {
+    util::Tensor<double> y, dx, dw, db;
+
+    ReferenceConv(Conv2D& layer, const util::Tensor<double>& x, const util::Tensor<double>& dy)
+        : y(dy.getShape(), 0.0), dx(x.getShape(), 0.0),
+          dw(layer.getWeight().getShape(), 0.0), db({layer.getOutChannels()}, 0.0) {
+        const Conv2DOptions& o = layer.getOptions();
+        const bool nchw = o.layout == ImageLayout::kNCHW;
+        const int batch = x.getDimension(0);
+        const int channels = layer.getInChannels(), out_channels = layer.getOutChannels();
+        const int height = x.getDimension(nchw ? 2 : 1), width = x.getDimension(nchw ? 3 : 2);
+        const int out_height = y.getDimension(nchw ? 2 : 1), out_width = y.getDimension(nchw ? 3 : 2);
+        const int kernel_h = dw.getDimension(0), kernel_w = dw.getDimension(1);
+        auto index = [&](int n, int c, int h, int w, int num_c, int num_h, int num_w) {
+            return nchw ? ((n * num_c + c) * num_h + h) * num_w + w : ((n * num_h + h) * num_w + w) * num_c + c;
+        };
+        const double* w_data = layer.getWeight().data();
+        for (int n = 0; n < batch; ++n) {
+            for (int oc = 0; oc < out_channels; ++oc) {
+                for (int oy = 0; oy < out_height; ++oy) {
+                    for (int ox = 0; ox < out_width; ++ox) {
+                        const int out = index(n, oc, oy, ox, out_channels, out_height, out_width);
+                        y.data()[out] = layer.getBias().data()[oc];
+                        db.data()[oc] += dy.data()[out];
+                        for (int ky = 0; ky < kernel_h; ++ky) {
+                            for (int kx = 0; kx < kernel_w; ++kx) {
+                                const int iy = oy * o.stride_h - o.pad_h + ky * o.dilation_h;
+                                const int ix = ox * o.stride_w - o.pad_w + kx * o.dilation_w;
+                                if (iy < 0 || iy >= height || ix < 0 || ix >= width) continue;
+                                for (int c = 0; c < channels; ++c) {
+                                    const int in = index(n, c, iy, ix, channels, height, width);
+                                    const int weight = ((ky * kernel_w + kx) * channels + c) * out_channels + oc;
+                                    y.data()[out] += w_data[weight] * x.data()[in];
+                                    dx.data()[in] += w_data[weight] * dy.data()[out];
+                                    dw.data()[weight] += x.data()[in] * dy.data()[out];
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+};
+} // namespace
+
+TEST(Layer, PreparedBuffers) {
+    ActivationLayer relu(util::Activation::kReLU);
+    EXPECT_FALSE(relu.isPrepared());
+    EXPECT_THROW(relu.Forward(util::Tensor<double>({2, 3})), std::invalid_argument);
+
+    relu.Prepare({3}, 4);
+    EXPECT_EQ(relu.getOutputShape(), std::vector<int>({3}));
+    const double* output_storage = relu.getOutput().data();
+    const double* gradient_storage = relu.getInputGradient().data();
+
+    util::Tensor<double> x({4, 3});
+    for (int i = 0; i < x.getCapacity(); ++i) x.data()[i] = i - 5.5;
+    const util::Tensor<double>& y = relu.Forward(x);
+    EXPECT_EQ(y.getShape(), std::vector<int>({4, 3}));
+    for (int i = 0; i < y.getCapacity(); ++i) EXPECT_EQ(y.data()[i], i > 5 ? i - 5.5 : 0);
+
+    const util::Tensor<double>& dx = relu.Backward(util::Tensor<double>({4, 3}, 2.0));
+    for (int i = 0; i < dx.getCapacity(); ++i) EXPECT_EQ(dx.data()[i], i > 5 ? 2 : 0);
+
+    // Smaller batches reuse the same buffers
+    util::Tensor<double> small({2, 3}, -1.0);
+    EXPECT_EQ(relu.Forward(small).getShape(), std::vector<int>({2, 3}));
+    EXPECT_EQ(relu.Backward(util::Tensor<double>({2, 3}, 1.0)).getShape(), std::vector<int>({2, 3}));
+    EXPECT_EQ(relu.getOutput().data(), output_storage);
+    EXPECT_EQ(relu.getInputGradient().data(), gradient_storage);
+
+    EXPECT_THROW(relu.Forward(util::Tensor<double>({5, 3})), std::invalid_argument);
+    EXPECT_THROW(relu.Forward(util::Tensor<double>({2, 4})), std::invalid_argument);
+    EXPECT_THROW(relu.Backward(util::Tensor<double>({4, 3})), std::invalid_argument);
+    EXPECT_THROW(relu.Prepare({3}, 0), std::invalid_argument);
+    EXPECT_TRUE(relu.Parameters().empty());
+}
+
+TEST(Layer, ActivationGradients) {
+    // Analytic dC/dx against central differences, C = sum(y)
+    for (util::Activation activation : {util::Activation::kGELU, util::Activation::kSigmoid}) {
+        ActivationLayer layer(activation);
+        layer.Prepare({5}, 1);
+        util::Tensor<double> x({1, 5});
+        for (int i = 0; i < 5; ++i) x.data()[i] = 0.7 * i - 1.6;
+        layer.Forward(x);
+        const util::Tensor<double> dx = layer.Backward(util::Tensor<double>({1, 5}, 1.0));
+
+        for (int i = 0; i < 5; ++i) {
+            const double h = 1e-6;
+            util::Tensor<double> shifted(x);
+            shifted.data()[i] += h;
+            const double up = layer.Forward(shifted).data()[i];
+            shifted.data()[i] -= 2 * h;
+            const double down = layer.Forward(shifted).data()[i];
+            EXPECT_NEAR(dx.data()[i], (up - down) / (2 * h), 1e-6);
+        }
+    }
+}
+
+TEST(Layer, LinearGradients) {
+    // C = sum(y * r) for fixed r, so dC/dy = r. Every gradient against central differences
+    for (util::Activation activation : {util::Activation::kNone, util::Activation::kSigmoid, util::Activation::kGELU}) {
+        Linear layer(7, 5, activation, 3);
+        layer.Prepare({7}, 4);
+        EXPECT_EQ(layer.Parameters().size(), 2u);
+        for (int i = 0; i < 5; ++i) layer.getBias().data()[i] = 0.1 * i - 0.2;
+
+        util::Tensor<double> x({3, 7});
+        util::Tensor<double> r({3, 5});
+        for (int i = 0; i < x.getCapacity(); ++i) x.data()[i] = std::sin(1.3 * i);
+        for (int i = 0; i < r.getCapacity(); ++i) r.data()[i] = std::cos(0.7 * i);
+        auto cost = [&]() {
+            const util::Tensor<double>& y = layer.Forward(x);
+            double c = 0;
+            for (int i = 0; i < y.getCapacity(); ++i) c += y.data()[i] * r.data()[i];
+            return c;
+        };
+
+        layer.ZeroGradients();
+        cost();
+        const util::Tensor<double> dx = layer.Backward(r);
+        std::vector<util::Tensor<double>*> parameters = layer.Parameters();
+        std::vector<util::Tensor<double>*> gradients = layer.Gradients();
+        parameters.push_back(&x);
+        gradients.push_back(const_cast<util::Tensor<double>*>(&dx));
+
+        const double h = 1e-6;
+        for (size_t p = 0; p < parameters.size(); ++p) {
+            for (int i = 0; i < parameters[p]->getCapacity(); ++i) {
+                double& value = parameters[p]->data()[i];
+                value += h;
+                const double up = cost();
+                value -= 2 * h;
+                const double down = cost();
+                value += h;
+                EXPECT_NEAR(gradients[p]->data()[i], (up - down) / (2 * h), 1e-6);
+            }
+        }
+    }
+
+    // Gradients accumulate over calls, until zeroed
+    Linear layer(3, 2);
+    layer.Prepare({3}, 2);
+    util::Tensor<double> x({2, 3}, 1.0);
+    layer.Forward(x);
+    layer.Backward(util::Tensor<double>({2, 2}, 1.0));
+    layer.Forward(x);
+    layer.Backward(util::Tensor<double>({2, 2}, 1.0));
+    EXPECT_DOUBLE_EQ(layer.getBiasGradient().data()[0], 4);
+    EXPECT_DOUBLE_EQ(layer.getWeightGradient().data()[0], 4);
+    layer.ZeroGradients();
+    EXPECT_DOUBLE_EQ(layer.getBiasGradient().data()[1], 0);
+
+    EXPECT_THROW(Linear(0, 3), std::invalid_argument);
+    EXPECT_THROW(layer.Prepare({4}, 2), std::invalid_argument);
+}
+
+TEST(Layer, Conv2D) {
+    // Against the direct definition, in both layouts, over geometries including several im2col tiles
+    struct Case {
+        int channels, out_channels, kernel_h, kernel_w, height, width;
+        Conv2DOptions options;
+    };
+    Conv2DOptions strided;
+    strided.stride_h = 2;
+    strided.pad_h = 1;
+    strided.pad_w = 2;
+    strided.dilation_w = 2;
+    Conv2DOptions padded;
+    padded.pad_h = padded.pad_w = 1;
+    const std::vector<Case> cases{
+        {3, 4, 3, 2, 7, 6, strided},
+        {2, 5, 1, 1, 4, 3, Conv2DOptions()},  // Pointwise, x read as its own unfolding
+        {64, 8, 3, 3, 13, 12, padded}};        // K = 576, so 112-pixel tiles, of 156 pixels per sample
+    for (const Case& test : cases) {
+        for (ImageLayout layout : {ImageLayout::kNCHW, ImageLayout::kNHWC}) {
+            Conv2DOptions options = test.options;
+            options.layout = layout;
+            const bool nchw = layout == ImageLayout::kNCHW;
+            Conv2D layer(test.channels, test.out_channels, test.kernel_h, test.kernel_w, options, 5);
+            for (int o = 0; o < test.out_channels; ++o) layer.getBias().data()[o] = 0.1 * o - 0.2;
+            const std::vector<int> input_shape = nchw ? std::vector<int>{test.channels, test.height, test.width}
+                                                      : std::vector<int>{test.height, test.width, test.channels};
+            layer.Prepare(input_shape, 3);
+
+            util::Tensor<double> x({2, input_shape[0], input_shape[1], input_shape[2]});
+            for (int i = 0; i < x.getCapacity(); ++i) x.data()[i] = std::sin(1.3 * i);
+            std::vector<int> output_dims{2};
+            for (const int& dim : layer.getOutputShape()) output_dims.push_back(dim);
+            util::Tensor<double> dy(output_dims);
+            for (int i = 0; i < dy.getCapacity(); ++i) dy.data()[i] = std::cos(0.7 * i);
+            ReferenceConv reference(layer, x, dy);
+
+            layer.ZeroGradients();
+            const util::Tensor<double>& y = layer.Forward(x);
+            ASSERT_EQ(y.getShape(), reference.y.getShape());
+            for (int i = 0; i < y.getCapacity(); ++i) EXPECT_NEAR(y.data()[i], reference.y.data()[i], 1e-12);
+            const util::Tensor<double>& dx = layer.Backward(dy);
+            for (int i = 0; i < dx.getCapacity(); ++i) EXPECT_NEAR(dx.data()[i], reference.dx.data()[i], 1e-12);
+            for (int i = 0; i < reference.dw.getCapacity(); ++i) {
+                EXPECT_NEAR(layer.getWeightGradient().data()[i], reference.dw.data()[i], 1e-12);
+            }
+            for (int i = 0; i < reference.db.getCapacity(); ++i) {
+                EXPECT_NEAR(layer.getBiasGradient().data()[i], reference.db.data()[i], 1e-12);
+            }
+        }
+    }
+
+    // Output shape, [O, OH, OW] from (7 + 2 - 1 * 2 - 1) / 2 + 1 and (6 + 4 - 2 * 1 - 1) / 1 + 1
+    Conv2D layer(3, 4, 3, 2, strided);
+    EXPECT_EQ(layer.InferOutputShape({3, 7, 6}), std::vector<int>({4, 4, 8}));
+    EXPECT_THROW(layer.Prepare({4, 7, 6}, 2), std::invalid_argument);
+    EXPECT_THROW(layer.Prepare({3, 7}, 2), std::invalid_argument);
+    EXPECT_THROW(Conv2D(3, 4, 9, 1).Prepare({3, 8, 8}, 2), std::invalid_argument);
+    EXPECT_THROW(Conv2D(0, 4, 3, 3), std::invalid_argument);
+    Conv2DOptions invalid;
+    invalid.stride_w = 0;
+    EXPECT_THROW(Conv2D(3, 4, 3, 3, invalid), std::invalid_argument);
+}
+
+} // cpp_nn
@@ -0,0 +1,112 @@
+#include "gtest/gtest.h"
+
+#include "CPPNeuralNet/losses.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace cpp_nn {
+
+namespace {
+/** Mean cross entropy of softmax, written out as in its definition */
+double ReferenceLoss(const util::Tensor<double>& logits, const std::vector<int>& labels) {
+    const int batch = logits.getDimension(0), classes = logits.getDimension(1);
+    double loss = 0;
+    for (int r = 0; r < batch; ++r) {
+        double sum = 0;
+        for (int c = 0; c < classes; ++c) sum += std::exp(logits.data()[r * classes + c]);
+        loss -= std::log(std::exp(logits.data()[r * classes + labels[r]]) / sum);
+    }
+    return loss / batch;
+}
+} // namespace
+
+TEST(SoftmaxCrossEntropy, LossAndGradient) {
+    const int batch = 5, classes = 7;
+    util::Tensor<double> logits({batch, classes});
+    for (int i = 0; i < logits.getCapacity(); ++i) logits.data()[i] = std::sin(1.3 * i) * 3;
+    const std::vector<int> labels{0, 6, 3, 3, 1};
+
+    SoftmaxCrossEntropy loss;
+    util::Tensor<double> gradient({batch, classes});
+    const double value = loss.Compute(logits, labels, gradient);
+    EXPECT_NEAR(value, ReferenceLoss(logits, labels), 1e-12);
+    EXPECT_DOUBLE_EQ(loss.Loss(logits, labels), value);
+
+    // Against central differences, and each row of gradient sums to 0
+    const double h = 1e-6;
+    for (int i = 0; i < logits.getCapacity(); ++i) {
+        util::Tensor<double> shifted = logits;
+        shifted.data()[i] += h;
+        const double up = ReferenceLoss(shifted, labels);
+        shifted.data()[i] -= 2 * h;
+        const double down = ReferenceLoss(shifted, labels);
+        EXPECT_NEAR(gradient.data()[i], (up - down) / (2 * h), 1e-7);
+    }
+    for (int r = 0; r < batch; ++r) {
+        double row_sum = 0;
+        for (int c = 0; c < classes; ++c) row_sum += gradient.data()[r * classes + c];
+        EXPECT_NEAR(row_sum, 0, 1e-15);
+    }
+
+    // Own buffer, and in place over the logits
+    EXPECT_DOUBLE_EQ(loss.Compute(logits, labels), value);
+    util::Tensor<double> in_place = logits;
+    EXPECT_DOUBLE_EQ(loss.Compute(in_place, labels, in_place), value);
+    for (int i = 0; i < logits.getCapacity(); ++i) {
+        EXPECT_DOUBLE_EQ(loss.getGradient().data()[i], gradient.data()[i]);
+        EXPECT_DOUBLE_EQ(in_place.data()[i], gradient.data()[i]);
+    }
+}
+
+TEST(SoftmaxCrossEntropy, Stability) {
+    // exp(1000) overflows, shifting every logit of a row leaves softmax unchanged
+    util::Tensor<double> logits({2, 3});
+    util::Tensor<double> shifted({2, 3});
+    const std::vector<double> values{1, 2, 3, -4, 0, 0.5};
+    for (int i = 0; i < 6; ++i) {
+        logits.data()[i] = values[i];
+        shifted.data()[i] = values[i] + (i < 3 ? 1000 : -1000);
+    }
+    SoftmaxCrossEntropy loss;
+    util::Tensor<double> gradient({2, 3}), shifted_gradient({2, 3});
+    const double value = loss.Compute(logits, {2, 0}, gradient);
+    EXPECT_NEAR(loss.Compute(shifted, {2, 0}, shifted_gradient), value, 1e-12);
+    for (int i = 0; i < 6; ++i) {
+        EXPECT_TRUE(std::isfinite(shifted_gradient.data()[i]));
+        EXPECT_NEAR(shifted_gradient.data()[i], gradient.data()[i], 1e-12);
+    }
+
+    // Large batch of many classes, split among threads
+    util::Tensor<double> wide({300, 1000});
+    std::vector<int> labels(300);
+    for (int i = 0; i < wide.getCapacity(); ++i) wide.data()[i] = std::cos(0.01 * i) * 50;
+    for (int r = 0; r < 300; ++r) labels[r] = (r * 37) % 1000;
+    double expected = 0;
+    for (int r = 0; r < 300; ++r) {
+        double max = wide.data()[r * 1000];
+        for (int c = 0; c < 1000; ++c) max = std::max(max, wide.data()[r * 1000 + c]);
+        double sum = 0;
+        for (int c = 0; c < 1000; ++c) sum += std::exp(wide.data()[r * 1000 + c] - max);
+        expected += max + std::log(sum) - wide.data()[r * 1000 + labels[r]];
+    }
+    EXPECT_NEAR(loss.Compute(wide, labels), expected / 300, 1e-10);
+    EXPECT_EQ(loss.getGradient().getShape(), std::vector<int>({300, 1000}));
+}
+
+TEST(SoftmaxCrossEntropy, Throws) {
+    SoftmaxCrossEntropy loss;
+    util::Tensor<double> logits({2, 3}, 0.0);
+    util::Tensor<double> gradient({2, 3}, 5.0);
+    EXPECT_THROW(loss.Compute(util::Tensor<double>({6}), {0}), std::invalid_argument);
+    EXPECT_THROW(loss.Compute(logits, {0}), std::invalid_argument);
+    EXPECT_THROW(loss.Compute(logits, {0, 3}, gradient), std::invalid_argument);
+    EXPECT_THROW(loss.Loss(logits, {-1, 0}), std::invalid_argument);
+    util::Tensor<double> transposed({3, 2});
+    EXPECT_THROW(loss.Compute(logits, {0, 1}, transposed), std::invalid_argument);
+    // Nothing is written on a bad label
+    EXPECT_EQ(gradient.data()[0], 5.0);
+}
+
+} // cpp_nn
@@ -0,0 +1,435 @@
+#include "gtest/gtest.h"
+
+#include "CPPNeuralNet/model.h"
+#include "CPPNeuralNet/layers.h"
+#include "CPPNeuralNet/optimizers.h"
+#include "CPPNeuralNet/Utils/thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+// Heap allocations of any thread are counted while counting is on
+namespace {
+std::atomic<bool> counting_allocations(false);
+std::atomic<long> num_allocations(0);
+void* CountedAllocate(size_t size, size_t alignment) {
+    if (counting_allocations.load()) ++num_allocations;
+    size = (std::max<size_t>(size, 1) + alignment - 1) / alignment * alignment;
+    void* pointer = std::aligned_alloc(alignment, size);
+    if (pointer == nullptr) throw std::bad_alloc();
+    return pointer;
+}
+} // namespace
+
+void* operator new(size_t size) {return CountedAllocate(size, alignof(std::max_align_t));}
+void* operator new[](size_t size) {return CountedAllocate(size, alignof(std::max_align_t));}
+void* operator new(size_t size, std::align_val_t alignment) {return CountedAllocate(size, static_cast<size_t>(alignment));}
+void* operator new[](size_t size, std::align_val_t alignment) {return CountedAllocate(size, static_cast<size_t>(alignment));}
+void operator delete(void* pointer) noexcept {std::free(pointer);}
+void operator delete[](void* pointer) noexcept {std::free(pointer);}
+void operator delete(void* pointer, size_t) noexcept {std::free(pointer);}
+void operator delete[](void* pointer, size_t) noexcept {std::free(pointer);}
+void operator delete(void* pointer, std::align_val_t) noexcept {std::free(pointer);}
+void operator delete[](void* pointer, std::align_val_t) noexcept {std::free(pointer);}
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept {std::free(pointer);}
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept {std::free(pointer);}
+
+namespace cpp_nn {
+
+namespace {
+void AddMlp(Model& model) {
+    model.AddLayer<Linear>(4, 16, util::Activation::kNone, 1);
+    model.AddLayer<ActivationLayer>(util::Activation::kReLU);
+    model.AddLayer<Linear>(16, 8, util::Activation::kNone, 2);
+    model.AddLayer<ActivationLayer>(util::Activation::kGELU);
+    model.AddLayer<Linear>(8, 1, util::Activation::kNone, 3);
+}
+} // namespace
+
+TEST(Model, FusionMatchesLayers) {
+    Model fused, unfused;
+    AddMlp(fused);
+    AddMlp(unfused);
+    EXPECT_THROW(fused.Forward(util::Tensor<double>({2, 4})), std::invalid_argument);
+    fused.Build({4}, 8);
+    unfused.Build({4}, 8, false);
+    EXPECT_EQ(fused.getNumFused(), 2);
+    EXPECT_EQ(fused.getNumLayers(), 3);
+    EXPECT_EQ(unfused.getNumLayers(), 5);
+
+    util::Tensor<double> x({6, 4});
+    for (int i = 0; i < x.getCapacity(); ++i) x.data()[i] = std::sin(0.9 * i);
+    util::Tensor<double> dy({6, 1}, 1.0);
+
+    const util::Tensor<double>& y_fused = fused.Forward(x);
+    const util::Tensor<double>& y_unfused = unfused.Forward(x);
+    EXPECT_TRUE(y_fused.isView());
+    for (int i = 0; i < 6; ++i) EXPECT_NEAR(y_fused.data()[i], y_unfused.data()[i], 1e-12);
+
+    const util::Tensor<double>& dx_fused = fused.Backward(dy);
+    const util::Tensor<double>& dx_unfused = unfused.Backward(dy);
+    EXPECT_EQ(dx_fused.getShape(), std::vector<int>({6, 4}));
+    for (int i = 0; i < dx_fused.getCapacity(); ++i) EXPECT_NEAR(dx_fused.data()[i], dx_unfused.data()[i], 1e-12);
+
+    std::vector<util::Tensor<double>*> g_fused = fused.Gradients();
+    std::vector<util::Tensor<double>*> g_unfused = unfused.Gradients();
+    ASSERT_EQ(g_fused.size(), 6u);
+    ASSERT_EQ(g_unfused.size(), 6u);
+    for (size_t p = 0; p < g_fused.size(); ++p) {
+        for (int i = 0; i < g_fused[p]->getCapacity(); ++i) {
+            EXPECT_NEAR(g_fused[p]->data()[i], g_unfused[p]->data()[i], 1e-12);
+        }
+    }
+
+    EXPECT_THROW(Model().Build({4}, 8), std::invalid_argument);
+    EXPECT_THROW(unfused.Build({5}, 8), std::invalid_argument);
+}
+
+TEST(Model, MemoryPlan) {
+    // Unfused, so activations run in place, checked against the same layers on their own buffers
+    const std::vector<util::Activation> activations{util::Activation::kReLU, util::Activation::kSigmoid,
+                                                     util::Activation::kGELU, util::Activation::kReLU};
+    Model model;
+    std::vector<std::unique_ptr<Layer>> layers;
+    for (size_t l = 0; l < activations.size(); ++l) {
+        model.AddLayer<Linear>(8, 8, util::Activation::kNone, l + 1);
+        model.AddLayer<ActivationLayer>(activations[l]);
+        layers.push_back(std::make_unique<Linear>(8, 8, util::Activation::kNone, l + 1));
+        layers.push_back(std::make_unique<ActivationLayer>(activations[l]));
+    }
+    model.Build({8}, 4, false);
+    for (std::unique_ptr<Layer>& layer : layers) layer->Prepare({8}, 4);
+
+    // 16 buffers of 4 x 8 doubles. ReLU and Sigmoid take Linear's output, GELU keeps its own
+    EXPECT_EQ(model.getUnplannedBytes(), 16 * 32 * sizeof(double));
+    EXPECT_LE(model.getPeakBytes(), model.getArenaBytes());
+    EXPECT_LE(model.getArenaBytes() * 2, model.getUnplannedBytes());
+
+    util::Tensor<double> x({4, 8});
+    util::Tensor<double> dy({4, 8});
+    for (int i = 0; i < x.getCapacity(); ++i) {
+        x.data()[i] = std::sin(0.9 * i);
+        dy.data()[i] = std::cos(0.4 * i);
+    }
+    const util::Tensor<double>* y = &x;
+    for (std::unique_ptr<Layer>& layer : layers) y = &layer->Forward(*y);
+    const util::Tensor<double>& y_model = model.Forward(x);
+    for (int i = 0; i < y->getCapacity(); ++i) EXPECT_DOUBLE_EQ(y_model.data()[i], y->data()[i]);
+
+    const util::Tensor<double>* dx = &dy;
+    for (auto layer = layers.rbegin(); layer != layers.rend(); ++layer) dx = &(*layer)->Backward(*dx);
+    const util::Tensor<double>& dx_model = model.Backward(dy);
+    for (int i = 0; i < dx->getCapacity(); ++i) EXPECT_DOUBLE_EQ(dx_model.data()[i], dx->data()[i]);
+    std::vector<util::Tensor<double>*> gradients = model.Gradients();
+    for (size_t l = 0; l < layers.size(); l += 2) {
+        const util::Tensor<double>& expected = static_cast<Linear&>(*layers[l]).getWeightGradient();
+        for (int i = 0; i < expected.getCapacity(); ++i) {
+            EXPECT_DOUBLE_EQ(gradients[l]->data()[i], expected.data()[i]);
+        }
+    }
+}
+
+TEST(Model, SteadyStateAllocatesNothing) {
+    // Once warmed up, forward and backward run on prepared buffers and leased scratch alone.
+    // Batch 1 takes the vector-matrix kernels, larger batches the blocked Gemm.
+    // Warm-up runs long enough that every pool thread has taken its share of tasks
+    const int default_threads = util::getNumThreads();
+    for (int threads : {1, 4}) {
+        util::SetNumThreads(threads);
+        Model model;
+        model.AddLayer<Linear>(128, 128, util::Activation::kNone, 1);
+        model.AddLayer<ActivationLayer>(util::Activation::kReLU);
+        model.AddLayer<Linear>(128, 10, util::Activation::kNone, 2);
+        model.Build({128}, 64);
+
+        for (int batch : {1, 8, 64}) {
+            util::Tensor<double> x({batch, 128}, 0.5);
+            util::Tensor<double> dy({batch, 10}, 0.1);
+            for (int i = 0; i < 20; ++i) {
+                model.Forward(x);
+                model.Backward(dy);
+            }
+            num_allocations = 0;
+            counting_allocations = true;
+            model.Forward(x);
+            const long forward_allocations = num_allocations.exchange(0);
+            model.Backward(dy);
+            counting_allocations = false;
+            EXPECT_EQ(forward_allocations, 0) << "threads " << threads << ", batch " << batch;
+            EXPECT_EQ(num_allocations.load(), 0) << "threads " << threads << ", batch " << batch;
+        }
+    }
+    util::SetNumThreads(default_threads);
+}
+
+TEST(Model, PrunedLinear) {
+    // Same pruned network through structured kernels and, threshold off, through dense Gemm
+    auto in_block = [](int k, int n) {return (k / 4 * 12 + n / 4) % 10 == 0;};  // 90% of 4x4 blocks zero
+    auto in_pair = [](int k, int n) {return (k + n) % 4 < 2;};                  // 2:4
+    Model sparse, dense;
+    std::vector<Linear*> sparse_layers, dense_layers;
+    for (Model* model : {&sparse, &dense}) {
+        Linear& first = model->AddLayer<Linear>(64, 48, util::Activation::kReLU, 1);
+        Linear& second = model->AddLayer<Linear>(48, 32, util::Activation::kNone, 2);
+        for (int k = 0; k < 64; ++k) for (int n = 0; n < 48; ++n) {
+            if (!in_block(k, n)) first.getWeight().getElement({k, n}) = 0.0;
+        }
+        for (int k = 0; k < 48; ++k) for (int n = 0; n < 32; ++n) {
+            double& w = second.getWeight().getElement({k, n});
+            w = in_pair(k, n) ? 0.1 + 0.01 * ((k * 7 + n) % 11) : 0.0;
+        }
+        (model == &sparse ? sparse_layers : dense_layers) = {&first, &second};
+    }
+    const double default_threshold = util::getBlockSparseThreshold();
+    util::SetBlockSparseThreshold(0.5);
+    sparse.Build({64}, 32);
+    util::SetBlockSparseThreshold(0.0);
+    dense.Build({64}, 32);
+    util::SetBlockSparseThreshold(default_threshold);
+    EXPECT_EQ(sparse_layers[0]->getWeightFormat(), util::StructuredFormat::kBlockSparse);
+    EXPECT_EQ(sparse_layers[1]->getWeightFormat(), util::StructuredFormat::kTwoFour);
+    EXPECT_EQ(dense_layers[0]->getWeightFormat(), util::StructuredFormat::kDense);
+
+    util::Tensor<double> x({32, 64});
+    util::Tensor<double> dy({32, 32});
+    for (int i = 0; i < x.getCapacity(); ++i) x.data()[i] = std::sin(0.7 * i);
+    for (int i = 0; i < dy.getCapacity(); ++i) dy.data()[i] = std::cos(0.3 * i);
+    auto expect_match = [&]() {
+        const util::Tensor<double>& y_sparse = sparse.Forward(x);
+        const util::Tensor<double>& y_dense = dense.Forward(x);
+        for (int i = 0; i < y_dense.getCapacity(); ++i) EXPECT_NEAR(y_sparse.data()[i], y_dense.data()[i], 1e-12);
+        sparse.ZeroGradients();
+        dense.ZeroGradients();
+        const util::Tensor<double>& dx_sparse = sparse.Backward(dy);
+        const util::Tensor<double>& dx_dense = dense.Backward(dy);
+        for (int i = 0; i < dx_dense.getCapacity(); ++i) EXPECT_NEAR(dx_sparse.data()[i], dx_dense.data()[i], 1e-12);
+    };
+    expect_match();
+
+    // dC/dW is kept inside the pattern, so a training step leaves W pruned
+    const util::Tensor<double>& dw_sparse = sparse_layers[0]->getWeightGradient();
+    const util::Tensor<double>& dw_dense = dense_layers[0]->getWeightGradient();
+    for (int k = 0; k < 64; ++k) for (int n = 0; n < 48; ++n) {
+        const int i = k * 48 + n;
+        EXPECT_NEAR(dw_sparse.data()[i], in_block(k, n) ? dw_dense.data()[i] : 0.0, 1e-12);
+    }
+    for (int k = 0; k < 48; ++k) for (int n = 0; n < 32; ++n) {
+        const int i = k * 32 + n;
+        EXPECT_NEAR(sparse_layers[1]->getWeightGradient().data()[i],
+                    in_pair(k, n) ? dense_layers[1]->getWeightGradient().data()[i] : 0.0, 1e-12);
+    }
+    util::Tensor<double>& parameters = sparse.getFlatParameters();
+    for (int i = 0; i < parameters.getCapacity(); ++i) {
+        parameters.data()[i] -= 0.1 * sparse.getFlatGradients().data()[i];
+    }
+    for (int i = 0; i < parameters.getCapacity(); ++i) {
+        dense.getFlatParameters().data()[i] = parameters.data()[i];
+    }
+    for (int i = 0; i < 64 * 48; ++i) {
+        if (!in_block(i / 48, i % 48)) EXPECT_EQ(sparse_layers[0]->getWeight().data()[i], 0.0);
+    }
+    // Packed weights pick up the step
+    expect_match();
+}
+
+TEST(Model, Checkpointing) {
+    // Same network, whole and in segments of 4 layers, fused and not
+    for (bool fuse : {true, false}) {
+        Model whole, checkpointed;
+        for (Model* model : {&whole, &checkpointed}) {
+            for (int l = 0; l < 8; ++l) {
+                if (model == &checkpointed && l > 0 && l % 2 == 0) model->AddCheckpoint();
+                model->AddLayer<Linear>(16, 16, util::Activation::kNone, l + 1);
+                model->AddLayer<ActivationLayer>(l % 3 == 2 ? util::Activation::kGELU : util::Activation::kReLU);
+            }
+            model->AddLayer<Linear>(16, 2, util::Activation::kNone, 9);
+            model->Build({16}, 8, fuse);
+        }
+        EXPECT_EQ(whole.getNumSegments(), 1);
+        EXPECT_EQ(checkpointed.getNumSegments(), 4);
+        EXPECT_LT(checkpointed.getArenaBytes(), whole.getArenaBytes());
+        EXPECT_LE(checkpointed.getPeakBytes(), checkpointed.getArenaBytes());
+
+        util::Tensor<double> x({8, 16});
+        util::Tensor<double> dy({8, 2});
+        for (int i = 0; i < x.getCapacity(); ++i) x.data()[i] = std::sin(0.3 * i);
+        for (int i = 0; i < dy.getCapacity(); ++i) dy.data()[i] = std::cos(0.5 * i);
+        // Twice, so stale buffers of a first pass would show
+        for (int pass = 0; pass < 2; ++pass) {
+            const util::Tensor<double>& y_whole = whole.Forward(x);
+            const util::Tensor<double>& y_checkpointed = checkpointed.Forward(x);
+            for (int i = 0; i < y_whole.getCapacity(); ++i) EXPECT_DOUBLE_EQ(y_checkpointed.data()[i], y_whole.data()[i]);
+            const util::Tensor<double>& dx_whole = whole.Backward(dy);
+            const util::Tensor<double>& dx_checkpointed = checkpointed.Backward(dy);
+            for (int i = 0; i < dx_whole.getCapacity(); ++i) {
+                EXPECT_DOUBLE_EQ(dx_checkpointed.data()[i], dx_whole.data()[i]);
+            }
+        }
+        std::vector<util::Tensor<double>*> g_whole = whole.Gradients();
+        std::vector<util::Tensor<double>*> g_checkpointed = checkpointed.Gradients();
+        ASSERT_EQ(g_whole.size(), g_checkpointed.size());
+        for (size_t p = 0; p < g_whole.size(); ++p) {
+            for (int i = 0; i < g_whole[p]->getCapacity(); ++i) {
+                EXPECT_DOUBLE_EQ(g_checkpointed[p]->data()[i], g_whole[p]->data()[i]);
+            }
+        }
+    }
+
+    Model model;
+    model.AddLayer<Linear>(4, 4);
+    model.AddCheckpoint();
+    model.AddLayer<Linear>(4, 4);
+    model.Build({4}, 2);
+    EXPECT_THROW(model.Backward(util::Tensor<double>({2, 4})), std::invalid_argument);
+}
+
+TEST(Model, Training) {
+    // Fits y = x0 * x1 on [-1, 1]^2 by plain gradient descent on squared error
+    Model model;
+    model.AddLayer<Linear>(2, 32, util::Activation::kNone, 7);
+    model.AddLayer<ActivationLayer>(util::Activation::kReLU);
+    model.AddLayer<Linear>(32, 1, util::Activation::kNone, 8);
+    model.Build({2}, 64);
+
+    util::Tensor<double> x({64, 2});
+    util::Tensor<double> target({64, 1});
+    for (int i = 0; i < 64; ++i) {
+        x({i, 0}) = (i % 8) / 3.5 - 1;
+        x({i, 1}) = (i / 8) / 3.5 - 1;
+        target({i, 0}) = x({i, 0}) * x({i, 1});
+    }
+    util::Tensor<double> dy({64, 1});
+    auto step = [&]() {
+        const util::Tensor<double>& y = model.Forward(x);
+        double loss = 0;
+        for (int i = 0; i < 64; ++i) {
+            const double error = y.data()[i] - target.data()[i];
+            loss += error * error / 64;
+            dy.data()[i] = 2 * error / 64;
+        }
+        model.ZeroGradients();
+        model.Backward(dy);
+        std::vector<util::Tensor<double>*> parameters = model.Parameters();
+        std::vector<util::Tensor<double>*> gradients = model.Gradients();
+        for (size_t p = 0; p < parameters.size(); ++p) {
+            for (int i = 0; i < parameters[p]->getCapacity(); ++i) {
+                parameters[p]->data()[i] -= 0.1 * gradients[p]->data()[i];
+            }
+        }
+        return loss;
+    };
+
+    const double initial = step();
+    double loss = initial;
+    for (int i = 0; i < 500; ++i) loss = step();
+    EXPECT_LT(loss, initial * 0.1);
+
+    // Smaller batch runs in the same arena
+    util::Tensor<double> few({3, 2}, 0.5);
+    EXPECT_EQ(model.Forward(few).getShape(), std::vector<int>({3, 1}));
+}
+
+TEST(Model, FlatParameters) {
+    Model reference;
+    AddMlp(reference);
+    const std::vector<util::Tensor<double>*> before = reference.Parameters();
+    std::vector<util::Tensor<double>> values;
+    for (const util::Tensor<double>* parameter : before) values.push_back(*parameter);
+
+    Model model;
+    AddMlp(model);
+    EXPECT_EQ(model.getFlatParameters().getCapacity(), 0);
+    model.Build({4}, 8);
+
+    // Each parameter is a view into the flat buffer, in order, with values kept
+    const std::vector<util::Tensor<double>*> parameters = model.Parameters();
+    const std::vector<util::Tensor<double>*> gradients = model.Gradients();
+    ASSERT_EQ(parameters.size(), values.size());
+    const double* flat = model.getFlatParameters().data();
+    const double* flat_end = flat + model.getFlatParameters().getCapacity();
+    const double* previous_end = flat;
+    for (size_t p = 0; p < parameters.size(); ++p) {
+        EXPECT_GE(parameters[p]->data(), previous_end);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(parameters[p]->data()) % util::kTensorAlignment, 0u);
+        previous_end = parameters[p]->data() + parameters[p]->getCapacity();
+        EXPECT_LE(previous_end, flat_end);
+        EXPECT_EQ(gradients[p]->data() - model.getFlatGradients().data(), parameters[p]->data() - flat);
+        EXPECT_EQ(parameters[p]->getShape(), values[p].getShape());
+        for (int i = 0; i < values[p].getCapacity(); ++i) {
+            EXPECT_EQ(parameters[p]->data()[i], values[p].data()[i]);
+        }
+    }
+
+    // Training writes through the views, and rebuilding keeps values
+    util::Tensor<double> x({8, 4});
+    for (int i = 0; i < x.getCapacity(); ++i) x.data()[i] = std::sin(0.7 * i);
+    util::Tensor<double> dy({8, 1}, 1.0);
+    model.Forward(x);
+    model.Backward(dy);
+    double gradient_sum = 0;
+    for (int i = 0; i < model.getFlatGradients().getCapacity(); ++i) {
+        gradient_sum += std::abs(model.getFlatGradients().data()[i]);
+    }
+    EXPECT_GT(gradient_sum, 0);
+    model.Build({4}, 16);
+    const util::Tensor<double>& y = model.Forward(x);
+    const double y0 = y.data()[0];
+    model.ZeroGradients();
+    for (int i = 0; i < model.getFlatGradients().getCapacity(); ++i) {
+        EXPECT_EQ(model.getFlatGradients().data()[i], 0);
+    }
+
+    // An optimizer over the flat buffer steps like one over every tensor
+    reference.Build({4}, 8);
+    Adam flat_adam(1e-2), layer_adam(1e-2);
+    flat_adam.AddParameters({&model.getFlatParameters()}, {&model.getFlatGradients()});
+    layer_adam.AddParameters(reference.Parameters(), reference.Gradients());
+    for (int step = 0; step < 3; ++step) {
+        for (Model* m : {&model, &reference}) {
+            m->Forward(x);
+            m->ZeroGradients();
+            m->Backward(dy);
+        }
+        flat_adam.Step();
+        layer_adam.Step();
+    }
+    const std::vector<util::Tensor<double>*> stepped = reference.Parameters();
+    for (size_t p = 0; p < parameters.size(); ++p) {
+        for (int i = 0; i < parameters[p]->getCapacity(); ++i) {
+            EXPECT_DOUBLE_EQ(parameters[p]->data()[i], stepped[p]->data()[i]);
+        }
+    }
+
+    // Save and Load round trip, into a model of the same layers only
+    std::stringstream stream;
+    model.Save(stream);
+    Model loaded;
+    AddMlp(loaded);
+    EXPECT_THROW(loaded.Load(stream), std::invalid_argument);
+    loaded.Build({4}, 8);
+    loaded.Load(stream);
+    const util::Tensor<double>& y_loaded = loaded.Forward(x);
+    const util::Tensor<double>& y_saved = model.Forward(x);
+    EXPECT_NE(y_saved.data()[0], y0);
+    for (int i = 0; i < y_saved.getCapacity(); ++i) {
+        EXPECT_EQ(y_loaded.data()[i], y_saved.data()[i]);
+    }
+
+    std::stringstream other_stream;
+    model.Save(other_stream);
+    Model other;
+    other.AddLayer<Linear>(4, 2);
+    other.Build({4}, 8);
+    EXPECT_THROW(other.Load(other_stream), std::invalid_argument);
+    EXPECT_THROW(Model().Save(other_stream), std::invalid_argument);
+}
+
+} // cpp_nn
@@ -0,0 +1,176 @@
+#include "gtest/gtest.h"
+
+#include "CPPNeuralNet/optimizers.h"
+#include "CPPNeuralNet/model.h"
+#include "CPPNeuralNet/layers.h"
+
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace cpp_nn {
+
+namespace {
+/** Adam of one element over given gradients, written out as in its definition */
+double ReferenceAdam(double w, const std::vector<double>& gradients, double learning_rate,
+                     double weight_decay, bool decoupled) {
+    const double beta1 = 0.9, beta2 = 0.999, epsilon = 1e-8;
+    double m = 0, v = 0;
+    for (size_t t = 1; t <= gradients.size(); ++t) {
+        const double g = gradients[t - 1] + (decoupled ? 0 : weight_decay * w);
+        if (decoupled) w -= learning_rate * weight_decay * w;
+        m = beta1 * m + (1 - beta1) * g;
+        v = beta2 * v + (1 - beta2) * g * g;
+        const double m_hat = m / (1 - std::pow(beta1, t));
+        const double v_hat = v / (1 - std::pow(beta2, t));
+        w -= learning_rate * m_hat / (std::sqrt(v_hat) + epsilon);
+    }
+    return w;
+}
+} // namespace
+
+TEST(Optimizer, SGD) {
+    util::Tensor<double> w({3}, 1.0);
+    util::Tensor<double> g({3}, 0.5);
+    SGD plain(0.1);
+    plain.AddParameters({&w}, {&g});
+    plain.Step();
+    EXPECT_DOUBLE_EQ(w.data()[2], 1 - 0.1 * 0.5);
+    EXPECT_EQ(plain.getStateBytes(), 0u);
+
+    // Momentum and weight decay, against the recurrence
+    for (bool nesterov : {false, true}) {
+        util::Tensor<double> a({5}, 2.0);
+        util::Tensor<double> da({5}, 1.0);
+        SGD sgd(0.1, 0.9, 0.01, nesterov);
+        sgd.AddParameters({&a}, {&da});
+        EXPECT_EQ(sgd.getStateBytes(), 5 * sizeof(double));
+        double w_ref = 2, v_ref = 0;
+        for (int t = 0; t < 4; ++t) {
+            sgd.Step();
+            const double step_g = 1 + 0.01 * w_ref;
+            v_ref = 0.9 * v_ref + step_g;
+            w_ref -= 0.1 * (nesterov ? step_g + 0.9 * v_ref : v_ref);
+        }
+        for (int i = 0; i < 5; ++i) EXPECT_NEAR(a.data()[i], w_ref, 1e-12);
+    }
+
+    EXPECT_THROW(SGD(-1), std::invalid_argument);
+    EXPECT_THROW(SGD(0.1, -0.5), std::invalid_argument);
+    util::Tensor<double> small({2});
+    EXPECT_THROW(plain.AddParameters({&w}, {&small}), std::invalid_argument);
+    EXPECT_THROW(plain.AddParameters({&w, &g}, {&g}), std::invalid_argument);
+}
+
+TEST(Optimizer, Adam) {
+    // Groups of tensors of odd sizes, so spans end off vector width
+    for (bool decoupled : {false, true}) {
+        util::Tensor<double> a({7});
+        util::Tensor<double> b({3, 5});
+        util::Tensor<double> c({2});
+        util::Tensor<double> da({7}), db({3, 5}), dc({2});
+        std::vector<util::Tensor<double>*> parameters{&a, &b, &c};
+        std::vector<util::Tensor<double>*> gradients{&da, &db, &dc};
+        for (util::Tensor<double>* p : parameters) {
+            for (int i = 0; i < p->getCapacity(); ++i) p->data()[i] = std::sin(1.1 * i + p->getCapacity());
+        }
+        const std::vector<double> initial_a(a.data(), a.data() + 7);
+        const std::vector<double> initial_c(c.data(), c.data() + 2);
+
+        std::unique_ptr<Adam> adam = decoupled ? std::make_unique<AdamW>(0.01, 0.9, 0.999, 1e-8, 0.1)
+                                               : std::make_unique<Adam>(0.01, 0.9, 0.999, 1e-8, 0.1);
+        adam->AddParameters({&a, &b}, {&da, &db});
+        adam->AddParameterGroup({&c}, {&dc}, 0.05, 0);
+        EXPECT_EQ(adam->getNumGroups(), 2);
+        EXPECT_EQ(adam->getStateBytes(), 2 * 24 * sizeof(double));
+
+        std::vector<std::vector<double>> history_a(7), history_c(2);
+        for (int t = 0; t < 5; ++t) {
+            for (size_t p = 0; p < gradients.size(); ++p) {
+                for (int i = 0; i < gradients[p]->getCapacity(); ++i) {
+                    gradients[p]->data()[i] = std::cos(0.3 * t + 0.7 * i + p);
+                }
+            }
+            for (int i = 0; i < 7; ++i) history_a[i].push_back(da.data()[i]);
+            for (int i = 0; i < 2; ++i) history_c[i].push_back(dc.data()[i]);
+            adam->Step();
+        }
+        EXPECT_EQ(adam->getStepCount(), 5);
+        for (int i = 0; i < 7; ++i) {
+            EXPECT_NEAR(a.data()[i], ReferenceAdam(initial_a[i], history_a[i], 0.01, 0.1, decoupled), 1e-12);
+        }
+        for (int i = 0; i < 2; ++i) {
+            EXPECT_NEAR(c.data()[i], ReferenceAdam(initial_c[i], history_c[i], 0.05, 0, decoupled), 1e-12);
+        }
+
+        adam->ZeroGradients();
+        EXPECT_EQ(db.data()[14], 0);
+    }
+    EXPECT_THROW(Adam(1e-3, 1.0), std::invalid_argument);
+}
+
+TEST(Optimizer, GradientClipping) {
+    util::Tensor<double> a({20000}, 0.0);
+    util::Tensor<double> b({3}, 0.0);
+    util::Tensor<double> da({20000}, 0.0);
+    util::Tensor<double> db({3}, 0.0);
+    da.data()[123] = 3;
+    da.data()[19999] = 4;
+    db.data()[0] = 12;
+    SGD sgd(1);
+    sgd.AddParameters({&a}, {&da});
+    sgd.AddParameterGroup({&b}, {&db}, 1, 0);
+    EXPECT_DOUBLE_EQ(sgd.GradientNorm(), 13);
+    EXPECT_EQ(sgd.Step(), 0);  // Not taken with clipping off
+
+    sgd.setMaxGradientNorm(1.3);
+    EXPECT_DOUBLE_EQ(sgd.Step(), 13);
+    EXPECT_NEAR(a.data()[123], -3 - 0.3, 1e-12);
+    EXPECT_NEAR(b.data()[0], -12 - 1.2, 1e-12);
+    EXPECT_EQ(da.data()[123], 3);  // Gradients unchanged
+
+    sgd.setMaxGradientNorm(100);
+    sgd.Step();
+    EXPECT_NEAR(b.data()[0], -12 - 1.2 - 12, 1e-12);
+    EXPECT_THROW(sgd.setMaxGradientNorm(-1), std::invalid_argument);
+}
+
+TEST(Optimizer, ModelTraining) {
+    // Same fit as Model.Training, by AdamW
+    Model model;
+    model.AddLayer<Linear>(2, 32, util::Activation::kReLU, 7);
+    model.AddLayer<Linear>(32, 1, util::Activation::kNone, 8);
+    model.Build({2}, 64);
+    AdamW optimizer(0.01);
+    optimizer.AddParameters(model.Parameters(), model.Gradients());
+    optimizer.setMaxGradientNorm(10);
+
+    util::Tensor<double> x({64, 2});
+    util::Tensor<double> target({64, 1});
+    for (int i = 0; i < 64; ++i) {
+        x({i, 0}) = (i % 8) / 3.5 - 1;
+        x({i, 1}) = (i / 8) / 3.5 - 1;
+        target({i, 0}) = x({i, 0}) * x({i, 1});
+    }
+    util::Tensor<double> dy({64, 1});
+    auto step = [&]() {
+        const util::Tensor<double>& y = model.Forward(x);
+        double loss = 0;
+        for (int i = 0; i < 64; ++i) {
+            const double error = y.data()[i] - target.data()[i];
+            loss += error * error / 64;
+            dy.data()[i] = 2 * error / 64;
+        }
+        optimizer.ZeroGradients();
+        model.Backward(dy);
+        optimizer.Step();
+        return loss;
+    };
+    const double initial = step();
+    double loss = initial;
+    for (int i = 0; i < 300; ++i) loss = step();
+    EXPECT_LT(loss, initial * 0.1);
+}
+
+} // cpp_nn
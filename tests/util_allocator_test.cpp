@@ -0,0 +1,30 @@
+#include "gtest/gtest.h"
+
+#include "CPPNeuralNet/Utils/allocator.h"
+
+#include <cstdint>
+
+namespace cpp_nn {
+namespace util {
+
+TEST(UtilAllocator, ScratchBuffer) {
+    const double* outer_data = nullptr;
+    {
+        ScratchBuffer<double> outer(100);
+        outer_data = outer.data();
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(outer.data()) % kTensorAlignment, 0u);
+        for (int i = 0; i < 100; ++i) outer.data()[i] = i;
+
+        // Nested lease gets its own storage, outer contents are untouched
+        ScratchBuffer<double> inner(100);
+        EXPECT_NE(inner.data(), outer.data());
+        for (int i = 0; i < 100; ++i) inner.data()[i] = -1;
+        for (int i = 0; i < 100; ++i) EXPECT_EQ(outer.data()[i], i);
+    }
+    // Released buffer is leased again, without reallocating when no larger
+    ScratchBuffer<double> again(50);
+    EXPECT_EQ(again.data(), outer_data);
+}
+
+} // util
+} // cpp_nn
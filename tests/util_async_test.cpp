@@ -0,0 +1,77 @@
+#include "gtest/gtest.h"
+
+#include "CPPNeuralNet/Utils/async.h"
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+namespace cpp_nn {
+namespace util {
+
+TEST(UtilAsync, Dependencies) {
+    Tensor<double> x({4, 6});
+    Tensor<double> W1({6, 5});
+    Tensor<double> W2({5, 3});
+    for (int i = 0; i < x.getCapacity(); ++i) x.data()[i] = (i % 7) - 3;
+    for (int i = 0; i < W1.getCapacity(); ++i) W1.data()[i] = (i % 5) - 2;
+    for (int i = 0; i < W2.getCapacity(); ++i) W2.data()[i] = (i % 3) - 1;
+    auto relu = [](double v) {return v > 0 ? v : 0.0;};
+
+    // Trunk feeding two heads, joined again
+    ExecutionStream stream;
+    auto trunk = stream.Multiply(stream.Ready(x), stream.Ready(W1));
+    auto head1 = stream.Map(trunk, relu);
+    auto head2 = stream.Multiply(trunk, stream.Ready(W2));
+    auto joined = stream.Enqueue([](const Tensor<double>& a, const Tensor<double>& b) {
+        return a * Tensor<double>({5, 3}, 1.0) + b;
+    }, head1, head2);
+
+    const Tensor<double> trunk_sync = x * W1;
+    const Tensor<double> expected = trunk_sync.Map(relu) * Tensor<double>({5, 3}, 1.0) + trunk_sync * W2;
+    ASSERT_EQ(joined.Get().getShape(), expected.getShape());
+    for (int i = 0; i < expected.getCapacity(); ++i) EXPECT_EQ(joined.Get().data()[i], expected.data()[i]);
+    EXPECT_TRUE(trunk.isReady());
+    stream.Synchronize();
+}
+
+TEST(UtilAsync, ConcurrencyAndErrors) {
+    const int default_threads = getNumThreads();
+    SetNumThreads(2);
+
+    // Each op waits for the other to start, which only finishes if both run at once
+    ExecutionStream stream;
+    std::atomic<int> started(0);
+    std::atomic<int> met(0);
+    auto rendezvous = [&started, &met](const Tensor<float>& t) {
+        ++started;
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (started.load() < 2 && std::chrono::steady_clock::now() < deadline) std::this_thread::yield();
+        if (started.load() >= 2) ++met;
+        return t;
+    };
+    auto input = stream.Ready(Tensor<float>({2}, 1.0f));
+    auto a = stream.Enqueue(rendezvous, input);
+    auto b = stream.Enqueue(rendezvous, input);
+    a.Wait();
+    b.Wait();
+    EXPECT_EQ(met.load(), 2);
+
+    // Failure reaches dependents without running them
+    std::atomic<bool> ran(false);
+    auto failing = stream.Enqueue([](const Tensor<float>& t) -> Tensor<float> {
+        throw std::invalid_argument("Async Test");
+    }, input);
+    auto dependent = stream.Enqueue([&ran](const Tensor<float>& t) {ran = true; return t;}, failing);
+    EXPECT_THROW(dependent.Get(), std::invalid_argument);
+    EXPECT_FALSE(ran.load());
+    EXPECT_THROW(stream.Synchronize(), std::invalid_argument);
+    EXPECT_THROW(stream.Enqueue([](const Tensor<float>& t) {return t;}, TensorFuture<float>()),
+                 std::invalid_argument);
+
+    SetNumThreads(default_threads);
+}
+
+}
+}
@@ -0,0 +1,191 @@
+#include "gtest/gtest.h"
+
+#include "CPPNeuralNet/Utils/autograd.h"
+#include "CPPNeuralNet/Utils/tensor.h"
+
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+namespace cpp_nn {
+namespace util {
+
+namespace {
+/** Checks tape gradient of every leaf against central differences of cost, which records and returns loss */
+void ExpectGradients(const std::function<Variable<double>(Tape<double>&, std::vector<Variable<double>>&)>& cost,
+                     std::vector<Tensor<double>*> leaves) {
+    Tape<double> tape;
+    std::vector<Variable<double>> variables;
+    tape.Backward(cost(tape, variables));
+    ASSERT_EQ(variables.size(), leaves.size());
+    std::vector<Tensor<double>> gradients;
+    for (const Variable<double>& variable : variables) gradients.push_back(tape.getGradient(variable));
+
+    auto evaluate = [&]() {
+        tape.Clear();
+        variables.clear();
+        return tape.getValue(cost(tape, variables)).data()[0];
+    };
+    const double h = 1e-6;
+    for (size_t l = 0; l < leaves.size(); ++l) {
+        for (int i = 0; i < leaves[l]->getCapacity(); ++i) {
+            double& value = leaves[l]->data()[i];
+            value += h;
+            const double up = evaluate();
+            value -= 2 * h;
+            const double down = evaluate();
+            value += h;
+            EXPECT_NEAR(gradients[l].data()[i], (up - down) / (2 * h), 1e-6);
+        }
+    }
+}
+} // namespace
+
+TEST(UtilAutograd, Gradients) {
+    Tensor<double> x({2, 3, 4});
+    Tensor<double> W({4, 5});
+    Tensor<double> b({5});
+    Tensor<double> s({3, 1});
+    for (int i = 0; i < x.getCapacity(); ++i) x.data()[i] = std::sin(1.3 * i);
+    for (int i = 0; i < W.getCapacity(); ++i) W.data()[i] = std::cos(0.7 * i);
+    for (int i = 0; i < b.getCapacity(); ++i) b.data()[i] = 0.1 * i - 0.2;
+    for (int i = 0; i < s.getCapacity(); ++i) s.data()[i] = 0.5 + i;
+
+    // Batched matmul, bias, activations, then mean
+    for (Activation activation : {Activation::kNone, Activation::kSigmoid, Activation::kGELU}) {
+        ExpectGradients([&](Tape<double>& tape, std::vector<Variable<double>>& leaves) {
+            leaves = {tape.Leaf(x), tape.Leaf(W), tape.Leaf(b)};
+            return tape.Mean(tape.Apply(leaves[0] * leaves[1] + leaves[2], activation));
+        }, {&x, &W, &b});
+    }
+
+    // Broadcast multiply and subtract, axis sum, transpose and reshape
+    ExpectGradients([&](Tape<double>& tape, std::vector<Variable<double>>& leaves) {
+        leaves = {tape.Leaf(x), tape.Leaf(W), tape.Leaf(s)};
+        Variable<double> y = tape.Multiply(leaves[0] * leaves[1], leaves[2]);  // [2, 3, 5] * [3, 1]
+        Variable<double> column = tape.Reshape(leaves[2], {3, 1, 1});
+        Variable<double> z = tape.Transpose(tape.Sum(y, 1), 0, 1) - column;  // [5, 2] - [3, 1, 1], broadcast on both sides
+        Variable<double> r = tape.Reshape(tape.Multiply(z, z), {5, 3, 2});
+        return tape.Scale(tape.Sum(tape.Apply(r, Activation::kSigmoid)), 0.5);
+    }, {&x, &W, &s});
+
+    // Leaf used twice, and constant leaf
+    ExpectGradients([&](Tape<double>& tape, std::vector<Variable<double>>& leaves) {
+        leaves = {tape.Leaf(W)};
+        Variable<double> constant = tape.Leaf(b, false);
+        Variable<double> y = tape.Multiply(leaves[0], leaves[0]) + constant;
+        return tape.Sum(tape.Sum(tape.Transpose(y, 1, 0), 0));
+    }, {&W});
+}
+
+TEST(UtilAutograd, Values) {
+    Tensor<double> A({2, 3});
+    Tensor<double> B({3, 2});
+    for (int i = 0; i < 6; ++i) {
+        A.data()[i] = i;
+        B.data()[i] = 6 - i;
+    }
+    Tape<double> tape;
+    Variable<double> a = tape.Leaf(A), b = tape.Leaf(B);
+    const Tensor<double> product = A * B;
+    const Tensor<double>& recorded = (a * b).getValue();
+    EXPECT_EQ(recorded.getShape(), product.getShape());
+    for (int i = 0; i < 4; ++i) EXPECT_DOUBLE_EQ(recorded.data()[i], product.data()[i]);
+    const Tensor<double>& transposed = tape.Transpose(a, 0, 1).getValue();
+    EXPECT_EQ(transposed.getShape(), std::vector<int>({3, 2}));
+    EXPECT_DOUBLE_EQ(transposed.data()[1], A.data()[3]);
+    EXPECT_EQ(tape.Sum(a, 0).getValue().getShape(), std::vector<int>({3}));
+    EXPECT_DOUBLE_EQ(tape.Sum(a, 1).getValue().data()[1], 12);
+    EXPECT_DOUBLE_EQ(tape.Mean(a).getValue().data()[0], 2.5);
+
+    EXPECT_THROW(tape.Matmul(a, a), std::invalid_argument);
+    EXPECT_THROW(tape.Matmul(tape.Sum(a, 0), b), std::invalid_argument);
+    EXPECT_THROW(tape.Reshape(a, {4}), std::invalid_argument);
+    EXPECT_THROW(tape.Sum(a, 2), std::invalid_argument);
+    EXPECT_THROW(tape.Backward(a), std::invalid_argument);
+    Tape<double> other;
+    EXPECT_THROW(other.Sum(a), std::invalid_argument);
+    EXPECT_THROW(Variable<double>().getValue(), std::invalid_argument);
+
+    Variable<double> loss = tape.Sum(a * b);
+    tape.Backward(loss);
+    EXPECT_THROW(tape.Backward(loss), std::invalid_argument);
+    EXPECT_THROW(tape.Sum(a), std::invalid_argument);
+    EXPECT_DOUBLE_EQ(loss.getValue().data()[0], (A * B).Sum());
+}
+
+TEST(UtilAutograd, BufferReuse) {
+    // 8 layer MLP, 2 leaves per layer
+    const int depth = 8;
+    Tensor<double> x({16, 32});
+    for (int i = 0; i < x.getCapacity(); ++i) x.data()[i] = std::sin(0.1 * i);
+    std::vector<Tensor<double>> weights(depth, Tensor<double>({32, 32}));
+    std::vector<Tensor<double>> biases(depth, Tensor<double>({32}, 0.01));
+    for (Tensor<double>& W : weights) {
+        for (int i = 0; i < W.getCapacity(); ++i) W.data()[i] = 0.1 * std::cos(0.37 * i);
+    }
+
+    Tape<double> tape;
+    auto step = [&]() {
+        tape.Clear();
+        Variable<double> h = tape.Leaf(x, false);
+        std::vector<Variable<double>> leaves;
+        for (int l = 0; l < depth; ++l) {
+            leaves.push_back(tape.Leaf(weights[l]));
+            leaves.push_back(tape.Leaf(biases[l]));
+            h = tape.Apply(h * leaves[2 * l] + leaves[2 * l + 1], Activation::kReLU);
+        }
+        Variable<double> loss = tape.Mean(h);
+        tape.Backward(loss);
+        // Intermediate values are released, leaves keep gradients
+        EXPECT_THROW(h.getValue(), std::invalid_argument);
+        EXPECT_EQ(tape.getGradient(leaves[0]).getShape(), std::vector<int>({32, 32}));
+        return tape.getGradient(leaves[0]).data()[5];
+    };
+
+    const double gradient = step();
+    const int num_nodes = tape.getNumNodes();
+    const int num_buffers = tape.getNumBuffers();
+    EXPECT_EQ(num_nodes, 1 + 5 * depth + 1);
+    // One value per recorded op, plus released gradients recycled among leaf gradients
+    EXPECT_LT(num_buffers, 3 * depth + 1 + 2 * depth);
+
+    // Same graph again takes only pooled buffers
+    EXPECT_DOUBLE_EQ(step(), gradient);
+    EXPECT_EQ(tape.getNumBuffers(), num_buffers);
+}
+
+TEST(UtilAutograd, RecordGrowth) {
+    // Apply as 5th and Scale as 9th node of a fresh tape, each where records grow and move
+    Tensor<double> a({2, 3}), b({4, 3});
+    for (int i = 0; i < a.getCapacity(); ++i) a.data()[i] = std::sin(0.9 * i);
+    for (int i = 0; i < b.getCapacity(); ++i) b.data()[i] = std::cos(0.4 * i);
+    Tape<double> tape;
+    Variable<double> va = tape.Leaf(a), vb = tape.Leaf(b);
+    Variable<double> product = tape.Matmul(va, tape.Transpose(vb, 0, 1));
+    Variable<double> applied = tape.Apply(product, Activation::kSigmoid);
+    ASSERT_EQ(tape.getNumNodes(), 5);
+    EXPECT_EQ(tape.getValue(applied).getShape(), std::vector<int>({2, 4}));
+    Variable<double> scaled = applied;
+    for (int i = 0; i < 4; ++i) scaled = tape.Scale(scaled, 0.5);
+    ASSERT_EQ(tape.getNumNodes(), 9);
+    EXPECT_EQ(tape.getValue(scaled).getShape(), std::vector<int>({2, 4}));
+
+    Variable<double> loss = tape.Mean(scaled);
+    const double expected = tape.getValue(loss).data()[0];
+    double sum = 0;
+    for (int r = 0; r < 2; ++r) {
+        for (int c = 0; c < 4; ++c) {
+            double z = 0;
+            for (int k = 0; k < 3; ++k) z += a.data()[r * 3 + k] * b.data()[c * 3 + k];
+            sum += 0.0625 / (1 + std::exp(-z));
+        }
+    }
+    EXPECT_NEAR(expected, sum / 8, 1e-12);
+    tape.Backward(loss);
+    EXPECT_EQ(tape.getGradient(vb).getShape(), std::vector<int>({4, 3}));
+}
+
+} // util
+} // cpp_nn
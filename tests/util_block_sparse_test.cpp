@@ -0,0 +1,127 @@
+#include "gtest/gtest.h"
+
+#include "CPPNeuralNet/Utils/block_sparse.h"
+#include "CPPNeuralNet/Utils/tensor.h"
+
+#include <vector>
+
+namespace cpp_nn {
+namespace util {
+
+namespace {
+/** Naive reference, C = A * B */
+std::vector<double> NaiveProduct(int M, int N, int K, const std::vector<double>& A, const std::vector<double>& B) {
+    std::vector<double> C(M * N, 0.0);
+    for (int r = 0; r < M; ++r) for (int k = 0; k < K; ++k) for (int c = 0; c < N; ++c)
+        C[r * N + c] += A[r * K + k] * B[k * N + c];
+    return C;
+}
+}
+
+TEST(UtilBlockSparse, KernelsMatchDense) {
+    // Edges not multiple of any block shape
+    const int M = 7, K = 21, N = 35;
+    std::vector<double> A(M * K), B(K * N, 0.0);
+    for (int i = 0; i < M * K; ++i) A[i] = (i % 11) - 5;
+    // Non-zeros in a few 4x4 blocks, at most 2 per group of 4 rows
+    for (int k = 0; k < K; ++k) for (int n = 0; n < N; ++n) {
+        if ((k / 4 + n / 4) % 3 == 0 && k % 4 < 2) B[k * N + n] = k - n * 0.5;
+    }
+    const std::vector<double> expected = NaiveProduct(M, N, K, A, B);
+
+    for (const auto& shape : {std::make_pair(4, 4), std::make_pair(1, 16), std::make_pair(16, 1)}) {
+        BlockSparseMatrix<double> packed;
+        packed.Pack(K, N, B.data(), N, 1, shape.first, shape.second);
+        std::vector<double> C(M * N, -1.0);
+        BlockSparseGemm(M, A.data(), K, 1, packed, C.data(), N);
+        for (int i = 0; i < M * N; ++i) EXPECT_DOUBLE_EQ(C[i], expected[i]);
+    }
+    BlockSparseMatrix<double> packed;
+    EXPECT_THROW(packed.Pack(K, N, B.data(), N, 1, 2, 2), std::invalid_argument);
+
+    ASSERT_TRUE(TwoFourSparseMatrix<double>::Matches(K, N, B.data(), N, 1));
+    TwoFourSparseMatrix<double> two_four;
+    two_four.Pack(K, N, B.data(), N, 1);
+    std::vector<double> C(M * N);
+    TwoFourSparseGemm(M, A.data(), K, 1, two_four, C.data(), N);
+    for (int i = 0; i < M * N; ++i) EXPECT_DOUBLE_EQ(C[i], expected[i]);
+
+    B[2 * N + 1] = 1.0;  // Third non-zero in rows 0-3 of column 1
+    EXPECT_FALSE(TwoFourSparseMatrix<double>::Matches(K, N, B.data(), N, 1));
+    EXPECT_THROW(two_four.Pack(K, N, B.data(), N, 1), std::invalid_argument);
+}
+
+TEST(UtilBlockSparse, StructuredSparseMatrix) {
+    // Pruned weight: 90% of 4x4 blocks are zero
+    const int M = 8, K = 64, N = 48;
+    std::vector<double> A(M * N), W(K * N, 0.0);
+    for (int i = 0; i < M * N; ++i) A[i] = (i % 7) - 3;
+    for (int k = 0; k < K; ++k) for (int n = 0; n < N; ++n) {
+        if ((k / 4 * 12 + n / 4) % 10 == 0) W[k * N + n] = 1.0 + k - n;
+    }
+
+    StructuredSparseMatrix<double> packed;
+    ASSERT_EQ(packed.Pack(K, N, W.data(), N), StructuredFormat::kBlockSparse);
+    const double default_threshold = getBlockSparseThreshold();
+    SetBlockSparseThreshold(0.0);
+    StructuredSparseMatrix<double> disabled;
+    EXPECT_EQ(disabled.Pack(K, N, W.data(), N), StructuredFormat::kDense);
+    EXPECT_FALSE(StructuredSparseGemm(M, A.data(), K, 1, disabled, A.data(), N));
+    SetBlockSparseThreshold(default_threshold);
+
+    // New values inside the pattern are refilled, those outside read as zero
+    std::vector<double> changed(W);
+    for (int i = 0; i < K * N; ++i) if (changed[i] != 0.0) changed[i] *= -2.0;
+    std::vector<double> outside(changed);
+    outside[1 * N + 5] = 100.0;
+    packed.Refill(outside.data(), N);
+    std::vector<double> C(M * N, -1.0);
+    ASSERT_TRUE(StructuredSparseGemm(M, A.data(), K, 1, packed, C.data(), N));
+    std::vector<double> expected = NaiveProduct(M, N, K, A, changed);
+    for (int i = 0; i < M * N; ++i) EXPECT_DOUBLE_EQ(C[i], expected[i]);
+
+    // A * W^T skips the same blocks, [M x N] * [N x K]
+    std::vector<double> changed_t(N * K), CT(M * K);
+    for (int k = 0; k < K; ++k) for (int n = 0; n < N; ++n) changed_t[n * K + k] = changed[k * N + n];
+    ASSERT_TRUE(StructuredSparseGemmTransposed(M, A.data(), N, 1, packed, CT.data(), K));
+    expected = NaiveProduct(M, K, N, A, changed_t);
+    for (int i = 0; i < M * K; ++i) EXPECT_DOUBLE_EQ(CT[i], expected[i]);
+
+    packed.Mask(outside.data(), N);
+    for (int i = 0; i < K * N; ++i) EXPECT_DOUBLE_EQ(outside[i], changed[i]);
+}
+
+TEST(UtilBlockSparse, TwoFourRefill) {
+    // Groups of 0, 1 and 2 non-zeros, and a last group cut short by K
+    const int M = 16, K = 18, N = 20;
+    std::vector<double> A(M * K), B(K * N, 0.0);
+    for (int i = 0; i < M * K; ++i) A[i] = (i % 5) - 2;
+    for (int k = 0; k < K; ++k) for (int n = 0; n < N; ++n) {
+        if ((k + n) % 4 == 0 || ((k + 2 * n) % 4 == 1 && n % 3 == 0)) B[k * N + n] = 0.5 * k - n;
+    }
+    ASSERT_TRUE(TwoFourSparseMatrix<double>::Matches(K, N, B.data(), N, 1));
+    TwoFourSparseMatrix<double> packed;
+    packed.Pack(K, N, B.data(), N, 1);
+
+    // Every group names 2 positions, so changed values there are all picked up
+    std::vector<double> changed(B), masked(K * N, 1.0);
+    packed.Mask(masked.data(), N, 1);
+    int kept = 0;
+    for (int i = 0; i < K * N; ++i) {
+        if (masked[i] == 0.0) {
+            EXPECT_DOUBLE_EQ(B[i], 0.0);
+            continue;
+        }
+        changed[i] = 1.0 + i % 3;
+        ++kept;
+    }
+    EXPECT_EQ(kept, 2 * (K / 4) * N + 2 * N);
+    packed.Refill(changed.data(), N, 1);
+    std::vector<double> C(M * N);
+    TwoFourSparseGemm(M, A.data(), K, 1, packed, C.data(), N);
+    const std::vector<double> expected = NaiveProduct(M, N, K, A, changed);
+    for (int i = 0; i < M * N; ++i) EXPECT_DOUBLE_EQ(C[i], expected[i]);
+}
+
+}
+}
@@ -0,0 +1,189 @@
+#include "gtest/gtest.h"
+
+#include "CPPNeuralNet/Utils/gemm.h"
+#include "CPPNeuralNet/Utils/strassen.h"
+
+#include <vector>
+
+namespace cpp_nn {
+namespace util {
+
+namespace {
+// Reference triple loop on row-major matrices
+std::vector<double> NaiveProduct(int M, int N, int K, const std::vector<double>& A, const std::vector<double>& B) {
+  std::vector<double> C(M * N, 0.0);
+  for (int r = 0; r < M; ++r) {
+    for (int c = 0; c < N; ++c) {
+      for (int k = 0; k < K; ++k) {
+        C[r * N + c] += A[r * K + k] * B[k * N + c];
+      }
+    }
+  }
+  return C;
+}
+std::vector<double> Sequence(int size, int mod) {
+  std::vector<double> values(size);
+  for (int i = 0; i < size; ++i) values[i] = (i * 7) % mod - mod / 2;
+  return values;
+}
+} // namespace
+
+TEST(UtilGemm, MatchesNaiveAcrossBlockEdges) {
+  // Sizes chosen to cross register tile, A block and K panel boundaries
+  const int M = 70, N = 19, K = 300;
+  std::vector<double> A = Sequence(M * K, 11);
+  std::vector<double> B = Sequence(K * N, 5);
+  std::vector<double> C(M * N, -1.0);
+
+  Gemm(M, N, K, A.data(), K, 1, B.data(), N, 1, C.data(), N);
+
+  std::vector<double> expected = NaiveProduct(M, N, K, A, B);
+  for (int i = 0; i < M * N; ++i) {
+    EXPECT_DOUBLE_EQ(C[i], expected[i]);
+  }
+}
+
+TEST(UtilGemm, TransposedOperandByStride) {
+  const int M = 5, N = 6, K = 9;
+  std::vector<double> A = Sequence(M * K, 7);
+  std::vector<double> B = Sequence(K * N, 3);
+  // Store A column-major, as if it were transposed
+  std::vector<double> A_t(K * M);
+  for (int r = 0; r < M; ++r) 
+    for (int k = 0; k < K; ++k) A_t[k * M + r] = A[r * K + k];
+  std::vector<double> C(M * N);
+
+  Gemm(M, N, K, A_t.data(), 1, M, B.data(), N, 1, C.data(), N);
+
+  std::vector<double> expected = NaiveProduct(M, N, K, A, B);
+  for (int i = 0; i < M * N; ++i) {
+    EXPECT_DOUBLE_EQ(C[i], expected[i]);
+  }
+}
+
+TEST(UtilGemm, Epilogue) {
+  const int M = 3, N = 5, K = 4;
+  std::vector<double> A = Sequence(M * K, 5);
+  std::vector<double> B = Sequence(K * N, 7);
+  std::vector<double> bias = {1, -2, 3, -4, 5};
+  std::vector<double> residual = Sequence(M * N, 3);
+  std::vector<double> C(M * N, 2.0);
+
+  GemmEpilogue<double> epilogue;
+  epilogue.alpha = 0.5;
+  epilogue.beta = 2.0;
+  epilogue.bias = bias.data();
+  epilogue.activation = Activation::kReLU;
+  epilogue.residual = residual.data();
+  epilogue.residual_ld = N;
+  Gemm(M, N, K, A.data(), K, 1, B.data(), N, 1, C.data(), N, epilogue);
+
+  std::vector<double> product = NaiveProduct(M, N, K, A, B);
+  for (int r = 0; r < M; ++r) {
+    for (int c = 0; c < N; ++c) {
+      double value = 0.5 * product[r * N + c] + 2.0 * 2.0 + bias[c];
+      value = (value > 0 ? value : 0) + residual[r * N + c];
+      EXPECT_DOUBLE_EQ(C[r * N + c], value);
+    }
+  }
+}
+
+TEST(UtilGemm, NarrowEpilogue) {
+  // Integers accumulate in int64, narrowed in the micro-kernel within one K panel and after it otherwise
+  const int M = 9, N = 11;
+  std::vector<int> bias(N);
+  for (int c = 0; c < N; ++c) bias[c] = c - 5;
+
+  for (int K : {100, 300}) {
+    std::vector<double> A = Sequence(M * K, 7);
+    std::vector<double> B = Sequence(K * N, 5);
+    std::vector<double> expected = NaiveProduct(M, N, K, A, B);
+    std::vector<int> A_int(A.begin(), A.end()), B_int(B.begin(), B.end());
+    std::vector<int> C(M * N, -3);
+
+    GemmEpilogue<int> epilogue;
+    epilogue.alpha = 2;
+    epilogue.beta = 3;
+    epilogue.bias = bias.data();
+    epilogue.activation = Activation::kReLU;
+    Gemm(M, N, K, A_int.data(), K, 1, B_int.data(), N, 1, C.data(), N, epilogue);
+
+    for (int r = 0; r < M; ++r) {
+      for (int c = 0; c < N; ++c) {
+        const double value = 2.0 * expected[r * N + c] - 9.0 + bias[c];
+        EXPECT_EQ(C[r * N + c], static_cast<int>(value > 0 ? value : 0));
+      }
+    }
+  }
+}
+
+TEST(UtilGemm, VectorShapes) {
+  // {M, N, K}: dot, matrix-vector, vector-matrix, outer
+  const std::vector<std::vector<int>> shapes = {{1, 1, 37}, {29, 1, 21}, {1, 33, 18}, {13, 17, 1}};
+  std::vector<double> bias(64, 0.25);
+
+  for (const std::vector<int>& shape : shapes) {
+    const int M = shape[0], N = shape[1], K = shape[2];
+    std::vector<double> A = Sequence(M * K, 9);
+    std::vector<double> B = Sequence(K * N, 4);
+    std::vector<double> expected = NaiveProduct(M, N, K, A, B);
+
+    GemmEpilogue<double> epilogue;
+    epilogue.alpha = 2.0;
+    epilogue.bias = bias.data();
+
+    // Row-major operands
+    std::vector<double> C(M * N);
+    Gemm(M, N, K, A.data(), K, 1, B.data(), N, 1, C.data(), N, epilogue);
+    for (int i = 0; i < M * N; ++i) {
+      EXPECT_DOUBLE_EQ(C[i], 2.0 * expected[i] + 0.25);
+    }
+
+    // Column-major operands
+    std::vector<double> A_t(K * M), B_t(N * K);
+    for (int r = 0; r < M; ++r) 
+      for (int k = 0; k < K; ++k) A_t[k * M + r] = A[r * K + k];
+    for (int k = 0; k < K; ++k) 
+      for (int c = 0; c < N; ++c) B_t[c * K + k] = B[k * N + c];
+    std::vector<double> C_t(M * N);
+    Gemm(M, N, K, A_t.data(), 1, M, B_t.data(), 1, K, C_t.data(), N, epilogue);
+    for (int i = 0; i < M * N; ++i) {
+      EXPECT_DOUBLE_EQ(C_t[i], 2.0 * expected[i] + 0.25);
+    }
+  }
+}
+
+TEST(UtilGemm, StrassenMatchesGemm) {
+  // Odd sizes exercise peeling at every level
+  const int M = 67, N = 45, K = 51;
+  std::vector<double> A = Sequence(M * K, 13);
+  std::vector<double> B = Sequence(K * N, 9);
+  std::vector<double> expected = NaiveProduct(M, N, K, A, B);
+
+  StrassenWorkspace<double> workspace;
+  std::vector<double> C(M * N);
+  StrassenGemm(M, N, K, A.data(), K, B.data(), N, C.data(), N, 8, workspace);
+  for (int i = 0; i < M * N; ++i) {
+    EXPECT_NEAR(C[i], expected[i], 1e-9);
+  }
+  EXPECT_EQ(workspace.getMark(), 0u);
+  EXPECT_GE(workspace.getCapacity(), StrassenWorkspace<double>::RequiredSize(M, N, K, 8));
+
+  // Opted into through Gemm, with epilogue applied afterwards
+  std::vector<double> bias(N, 1.0);
+  GemmEpilogue<double> epilogue;
+  epilogue.alpha = -1.0;
+  epilogue.bias = bias.data();
+  epilogue.activation = Activation::kReLU;
+  SetStrassenCutoff(16);
+  std::vector<double> D(M * N);
+  Gemm(M, N, K, A.data(), K, 1, B.data(), N, 1, D.data(), N, epilogue);
+  SetStrassenCutoff(0);
+  for (int i = 0; i < M * N; ++i) {
+    const double value = 1.0 - expected[i];
+    EXPECT_NEAR(D[i], value > 0 ? value : 0.0, 1e-9);
+  }
+}
+
+}
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#include "gtest/gtest.h"
+
+#include "CPPNeuralNet/Utils/memory_planner.h"
+
+#include <stdexcept>
+#include <vector>
+
+namespace cpp_nn {
+namespace util {
+
+namespace {
+/** Whether any two buffers live at the same step overlap in the arena */
+bool HasConflict(const std::vector<BufferLifetime>& buffers, const MemoryPlan& plan) {
+    for (size_t a = 0; a < buffers.size(); ++a) {
+        for (size_t b = a + 1; b < buffers.size(); ++b) {
+            if (buffers[b].in_place_of == static_cast<int>(a) || buffers[a].in_place_of == static_cast<int>(b)) continue;
+            const bool in_time = buffers[a].first <= buffers[b].last && buffers[b].first <= buffers[a].last;
+            const bool in_space = plan.offsets[a] < plan.offsets[b] + buffers[b].size &&
+                                  plan.offsets[b] < plan.offsets[a] + buffers[a].size;
+            if (in_time && in_space) return true;
+        }
+    }
+    return false;
+}
+} // namespace
+
+TEST(UtilMemoryPlanner, Offsets) {
+    // Chain where each buffer is read by the next step only
+    std::vector<BufferLifetime> chain;
+    for (int i = 0; i < 6; ++i) chain.push_back({100, i, i + 1});
+    MemoryPlan plan = PlanMemory(chain);
+    EXPECT_FALSE(HasConflict(chain, plan));
+    EXPECT_EQ(plan.arena_size, 200u);
+    EXPECT_EQ(plan.peak_size, 200u);
+    EXPECT_EQ(plan.total_size, 600u);
+
+    // In place, every buffer takes over the last
+    for (int i = 1; i < 6; ++i) chain[i].in_place_of = i - 1;
+    plan = PlanMemory(chain);
+    EXPECT_EQ(plan.arena_size, 100u);
+    for (int i = 0; i < 6; ++i) EXPECT_EQ(plan.offsets[i], 0u);
+
+    // Mixed sizes and lifetimes, with alignment
+    std::vector<BufferLifetime> mixed{{30, 0, 5}, {10, 1, 2}, {50, 2, 3}, {20, 3, 7}, {7, 4, 4}, {40, 6, 7}, {64, 0, 0}};
+    plan = PlanMemory(mixed, 8);
+    EXPECT_FALSE(HasConflict(mixed, plan));
+    for (const size_t& offset : plan.offsets) EXPECT_EQ(offset % 8, 0u);
+    EXPECT_GE(plan.arena_size, plan.peak_size);
+    EXPECT_LT(plan.arena_size, plan.total_size);
+    EXPECT_EQ(plan.peak_size, 32u + 56 + 24);
+
+    // Buffer written again later, as a recomputed output, sharing storage with its first write
+    std::vector<BufferLifetime> recomputed{{16, 0, 1}, {16, 1, 6}, {16, 4, 5, 0}, {8, 2, 3}};
+    plan = PlanMemory(recomputed);
+    EXPECT_FALSE(HasConflict(recomputed, plan));
+    EXPECT_EQ(plan.offsets[2], plan.offsets[0]);
+    EXPECT_EQ(plan.arena_size, 32u);
+    EXPECT_EQ(plan.peak_size, 32u);
+
+    EXPECT_EQ(PlanMemory({}).arena_size, 0u);
+    EXPECT_THROW(PlanMemory({{10, 3, 2}}), std::invalid_argument);
+    EXPECT_THROW(PlanMemory({{10, 0, 2}, {10, 1, 3, 0}}), std::invalid_argument);  // Owner still read after
+    EXPECT_THROW(PlanMemory({{10, 0, 1}, {20, 1, 3, 0}}), std::invalid_argument);  // Larger than owner
+    EXPECT_THROW(PlanMemory({{10, 0, 1, 1}, {10, 1, 3}}), std::invalid_argument);  // Owner not earlier
+}
+
+} // util
+} // cpp_nn
@@ -0,0 +1,78 @@
+#include "gtest/gtest.h"
+
+#include "CPPNeuralNet/Utils/numeric_types.h"
+#include "CPPNeuralNet/Utils/tensor.h"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace cpp_nn {
+namespace util {
+
+TEST(UtilNumericTypes, ScalarConversion) {
+    // Exactly representable values survive
+    for (float value : {0.0f, 1.0f, -2.5f, 0.15625f, 256.0f}) {
+        EXPECT_EQ(float(bf16(value)), value);
+        EXPECT_EQ(float(fp16(value)), value);
+    }
+    // Round to nearest even: 1 + 2^-8 is halfway between bf16 1 and 1 + 2^-7
+    EXPECT_EQ(float(bf16(1.0f + 1.0f / 256)), 1.0f);
+    EXPECT_EQ(float(bf16(1.0f + 3.0f / 256)), 1.0f + 4.0f / 256);
+    EXPECT_EQ(float(fp16(1.0f + 1.0f / 2048)), 1.0f);
+    // fp16 range and subnormals
+    EXPECT_EQ(float(fp16(65504.0f)), 65504.0f);
+    EXPECT_TRUE(std::isinf(float(fp16(65520.0f))));
+    EXPECT_EQ(float(fp16(std::ldexp(1.0f, -24))), std::ldexp(1.0f, -24));
+    EXPECT_EQ(float(fp16(std::ldexp(3.0f, -26))), std::ldexp(1.0f, -24));
+    EXPECT_EQ(fp16(std::ldexp(1.0f, -25)).bits, 0);
+    EXPECT_TRUE(std::isnan(float(bf16(std::numeric_limits<float>::quiet_NaN()))));
+    EXPECT_TRUE(std::isnan(float(fp16(std::numeric_limits<float>::quiet_NaN()))));
+}
+
+TEST(UtilNumericTypes, BulkConversionMatchesScalar) {
+    std::vector<float> values(37);
+    for (size_t i = 0; i < values.size(); ++i) values[i] = 0.731f * i - 11.0f;
+
+    std::vector<bf16> b(values.size());
+    std::vector<fp16> h(values.size());
+    std::vector<float> back(values.size());
+    ConvertElements(values.data(), b.data(), values.size());
+    ConvertElements(values.data(), h.data(), values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        EXPECT_EQ(b[i].bits, bf16(values[i]).bits);
+        EXPECT_EQ(h[i].bits, fp16(values[i]).bits);
+    }
+    ConvertElements(b.data(), back.data(), values.size());
+    for (size_t i = 0; i < values.size(); ++i) EXPECT_EQ(back[i], float(b[i]));
+    ConvertElements(h.data(), back.data(), values.size());
+    for (size_t i = 0; i < values.size(); ++i) EXPECT_EQ(back[i], float(h[i]));
+}
+
+TEST(UtilNumericTypes, HalfTensors) {
+    // Sum of 4096 ones is exact in float32, but would stall at 256 if accumulated in bf16
+    Tensor<bf16> A({2, 4096}, bf16(1.0f));
+    Tensor<bf16> B({4096, 3}, bf16(1.0f));
+    Tensor<bf16> C = A * B;
+    for (int i = 0; i < C.getCapacity(); ++i) EXPECT_EQ(float(C.data()[i]), 4096.0f);
+
+    // Against float product of the same rounded values
+    Tensor<fp16> X({5, 300});
+    Tensor<fp16> Y({300, 7});
+    Tensor<float> Xf({5, 300});
+    Tensor<float> Yf({300, 7});
+    for (int i = 0; i < X.getCapacity(); ++i) Xf.data()[i] = X.data()[i] = fp16(std::sin(0.1f * i));
+    for (int i = 0; i < Y.getCapacity(); ++i) Yf.data()[i] = Y.data()[i] = fp16(std::cos(0.3f * i));
+    Tensor<fp16> Z = X * Y;
+    Tensor<float> Zf = Xf * Yf;
+    for (int i = 0; i < Z.getCapacity(); ++i) {
+        EXPECT_NEAR(float(Z.data()[i]), Zf.data()[i], std::abs(Zf.data()[i]) * 1e-3 + 1e-3);
+    }
+
+    // Elementwise ops compute in float and round once
+    Tensor<fp16> S = X + X;
+    for (int i = 0; i < S.getCapacity(); ++i) EXPECT_EQ(float(S.data()[i]), 2 * float(X.data()[i]));
+}
+
+}
+}
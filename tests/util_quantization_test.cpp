@@ -0,0 +1,94 @@
+#include "gtest/gtest.h"
+
+#include "CPPNeuralNet/Utils/quantization.h"
+
+#include <cmath>
+#include <vector>
+
+namespace cpp_nn {
+namespace util {
+
+TEST(UtilQuantization, RoundTripPerTensor) {
+    Tensor<float> t({3, 4});
+    for (int i = 0; i < 12; ++i) t.data()[i] = 0.37f * i - 1.5f;
+
+    auto q = QuantizedTensor<uint8_t>::Quantize(t);
+    auto back = q.Dequantize();
+    ASSERT_EQ(back.getShape(), t.getShape());
+    for (int i = 0; i < 12; ++i) {
+        EXPECT_NEAR(back.data()[i], t.data()[i], q.getScale() / 2 + 1e-6);
+    }
+    // Zero is exactly representable
+    Tensor<float> zero({1});
+    EXPECT_EQ(QuantizedTensor<uint8_t>::Quantize(zero, {q.getScale()}, {q.getZeroPoint()}).data()[0],
+              q.getZeroPoint());
+}
+
+TEST(UtilQuantization, PerChannelSymmetric) {
+    Tensor<float> w({2, 3});
+    w.getElement({0, 0}) = 1.0f;  w.getElement({1, 0}) = -0.5f;
+    w.getElement({0, 1}) = 100.0f;
+    w.getElement({1, 2}) = -0.01f;
+
+    auto q = QuantizedTensor<int8_t>::Quantize(w, 1);
+    EXPECT_EQ(q.getAxis(), 1);
+    EXPECT_FLOAT_EQ(q.getScale(0), 1.0f / 127);
+    EXPECT_FLOAT_EQ(q.getScale(1), 100.0f / 127);
+    EXPECT_EQ(q.getZeroPoint(2), 0);
+    EXPECT_EQ(q.data()[0], 127);
+    EXPECT_EQ(q.data()[3], -64);
+
+    EXPECT_THROW(QuantizedTensor<int8_t>({2, 3}, {1.0f}, {0}, 1), std::invalid_argument);
+}
+
+TEST(UtilQuantization, GemmMatchesInteger) {
+    const int M = 5, K = 37, N = 6;
+    // Activations in [0, 255] with zero point, weights in [-127, 127]
+    QuantizedTensor<uint8_t> a({M, K}, {0.5f}, {17});
+    QuantizedTensor<int8_t> w({K, N}, std::vector<float>(N, 0.25f), std::vector<int>(N, 0), 1);
+    for (int i = 0; i < M * K; ++i) a.data()[i] = (i * 37) % 256;
+    for (int i = 0; i < K * N; ++i) w.data()[i] = (i * 29) % 255 - 127;
+
+    QuantizedGemmWeight packed(w);
+    std::vector<int32_t> C(M * N);
+    QuantizedGemm(M, a.data(), K, a.getZeroPoint(), packed, C.data(), N);
+
+    for (int r = 0; r < M; ++r) {
+        for (int c = 0; c < N; ++c) {
+            int32_t expected = 0;
+            for (int k = 0; k < K; ++k) expected += (a.data()[r * K + k] - 17) * w.data()[k * N + c];
+            EXPECT_EQ(C[r * N + c], expected);
+        }
+    }
+
+    // Float output agrees with dequantized float matmul
+    auto real = QuantizedMatmul(a, packed);
+    auto expected = a.Dequantize() * w.Dequantize();
+    ASSERT_EQ(real.getShape(), expected.getShape());
+    for (int i = 0; i < M * N; ++i) {
+        EXPECT_NEAR(real.data()[i], expected.data()[i], 1e-2);
+    }
+}
+
+TEST(UtilQuantization, RequantizeToUint8) {
+    QuantizedTensor<uint8_t> a({1, 2}, {1.0f}, {0});
+    QuantizedTensor<int8_t> w({2, 2}, {1.0f}, {0});
+    a.data()[0] = 3; a.data()[1] = 4;
+    w.data()[0] = 1; w.data()[1] = -1;
+    w.data()[2] = 2; w.data()[3] = -2;
+    QuantizedGemmWeight packed(w);
+
+    float bias[2] = {1.0f, 0.0f};
+    RequantizeEpilogue epilogue;
+    epilogue.bias = bias;
+    epilogue.activation = Activation::kReLU;
+    epilogue.output_scale = 0.5f;
+    epilogue.output_zero_point = 10;
+    uint8_t out[2];
+    QuantizedGemm(1, a.data(), 2, 0, 1.0f, packed, out, 2, epilogue);
+    EXPECT_EQ(out[0], 10 + 24);  // relu(3 + 8 + 1) / 0.5
+    EXPECT_EQ(out[1], 10);       // relu(-11) = 0
+}
+
+}
+}
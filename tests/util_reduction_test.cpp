@@ -0,0 +1,121 @@
+#include "gtest/gtest.h"
+
+#include "CPPNeuralNet/Utils/reduction.h"
+#include "CPPNeuralNet/Utils/tensor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace cpp_nn {
+namespace util {
+
+TEST(UtilReduction, Values) {
+    // [3, 2500, 4], long enough along axis 1 to span several leaves
+    Tensor<int> A({3, 2500, 4});
+    for (int i = 0; i < A.getCapacity(); ++i) A.data()[i] = (i * 37) % 101 - 50;
+
+    long long sum = 0;
+    int max = A.data()[0], min = A.data()[0];
+    for (int i = 0; i < A.getCapacity(); ++i) {
+        sum += A.data()[i];
+        max = std::max(max, A.data()[i]);
+        min = std::min(min, A.data()[i]);
+    }
+    EXPECT_EQ(A.Sum(), sum);
+    EXPECT_EQ(A.Mean(), sum / A.getCapacity());
+    EXPECT_EQ(A.Max(), max);
+    EXPECT_EQ(A.Min(), min);
+
+    for (int axis = 0; axis < 3; ++axis) {
+        Tensor<int> sums = A.Sum(axis);
+        Tensor<int> maxes = A.Max(axis);
+        std::vector<int> shape = A.getShape();
+        shape.erase(shape.begin() + axis);
+        EXPECT_EQ(sums.getShape(), shape);
+
+        std::vector<long long> expect_sum(sums.getCapacity(), 0);
+        std::vector<int> expect_max(sums.getCapacity(), -1000);
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 2500; ++j) {
+                for (int k = 0; k < 4; ++k) {
+                    const int out = axis == 0 ? j * 4 + k : axis == 1 ? i * 4 + k : i * 2500 + j;
+                    expect_sum[out] += A({i, j, k});
+                    expect_max[out] = std::max(expect_max[out], A({i, j, k}));
+                }
+            }
+        }
+        for (int i = 0; i < sums.getCapacity(); ++i) {
+            EXPECT_EQ(sums.data()[i], expect_sum[i]);
+            EXPECT_EQ(maxes.data()[i], expect_max[i]);
+        }
+    }
+
+    // Column means, as for a bias gradient
+    Tensor<double> B({4, 2}, 0);
+    for (int i = 0; i < 4; ++i) {
+        B({i, 0}) = i;
+        B({i, 1}) = -2 * i;
+    }
+    Tensor<double> means = B.Mean(0);
+    EXPECT_EQ(means.getShape(), std::vector<int>({2}));
+    EXPECT_DOUBLE_EQ(means({0}), 1.5);
+    EXPECT_DOUBLE_EQ(means({1}), -3);
+    EXPECT_EQ(Tensor<double>({5}, 2).Sum(0).getShape(), std::vector<int>({1}));
+    EXPECT_DOUBLE_EQ(Tensor<double>({5}, 2).Min(0)({0}), 2);
+
+    EXPECT_THROW(B.Sum(2), std::invalid_argument);
+    EXPECT_THROW(B.Max(-1), std::invalid_argument);
+    EXPECT_THROW(Tensor<double>({0, 3}).Max(), std::invalid_argument);
+    EXPECT_EQ(Tensor<double>({0, 3}).Sum(), 0);
+}
+
+TEST(UtilReduction, Deterministic) {
+    const int default_threads = getNumThreads();
+    const bool default_deterministic = getDeterministicReductions();
+
+    // Values of wildly different magnitude, so every regrouping of the sum rounds differently
+    Tensor<float> A({200000});
+    Tensor<float> B({50000, 3});
+    uint32_t state = 12345;
+    auto next = [&state]() {
+        state = state * 1664525u + 1013904223u;
+        return static_cast<float>(static_cast<int>(state >> 8) - (1 << 23)) * (state % 7 == 0 ? 1e4f : 1e-3f);
+    };
+    for (int i = 0; i < A.getCapacity(); ++i) A.data()[i] = next();
+    for (int i = 0; i < B.getCapacity(); ++i) B.data()[i] = next();
+
+    auto bits = [](float x) {
+        uint32_t res;
+        std::memcpy(&res, &x, sizeof(res));
+        return res;
+    };
+
+    SetDeterministicReductions(true);
+    EXPECT_TRUE(getDeterministicReductions());
+    SetNumThreads(1);
+    const uint32_t sum = bits(A.Sum());
+    const Tensor<float> columns = B.Sum(0);
+    for (int threads : {2, 3, 4, 7}) {
+        SetNumThreads(threads);
+        EXPECT_EQ(bits(A.Sum()), sum);
+        Tensor<float> parallel_columns = B.Sum(0);
+        for (int i = 0; i < columns.getCapacity(); ++i) {
+            EXPECT_EQ(bits(parallel_columns.data()[i]), bits(columns.data()[i]));
+        }
+    }
+
+    // Fast mode is still close, just not bit-exact
+    const float deterministic = A.Sum();
+    SetDeterministicReductions(false);
+    EXPECT_NEAR(A.Sum(), deterministic, 1e-3 * std::abs(deterministic) + 1);
+
+    SetDeterministicReductions(default_deterministic);
+    SetNumThreads(default_threads);
+}
+
+} // util
+} // cpp_nn
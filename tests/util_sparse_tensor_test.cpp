@@ -0,0 +1,71 @@
+#include "gtest/gtest.h"
+
+#include "CPPNeuralNet/Utils/sparse_tensor.h"
+
+namespace cpp_nn {
+namespace util {
+
+TEST(UtilSparseTensor, Conversions) {
+    Tensor<double> dense({2, 3, 4});
+    dense.getElement({0, 0, 1}) = 1.5;
+    dense.getElement({0, 2, 3}) = -2.0;
+    dense.getElement({1, 1, 0}) = 4.0;
+
+    auto csr = CsrTensor<double>::FromDense(dense);
+    EXPECT_EQ(csr.getRows(), 6);
+    EXPECT_EQ(csr.getCols(), 4);
+    EXPECT_EQ(csr.getNonZeros(), 3);
+    EXPECT_EQ(csr.getRowOffsets()[3], 2);   // Stacked row 3 is chunk 1, row 0
+    EXPECT_EQ(csr.getColIndices()[2], 0);
+
+    auto coo = csr.ToCoo();
+    EXPECT_EQ(coo.getNonZeros(), 3);
+    EXPECT_EQ(coo.getIndices(2)[0], 1);
+    EXPECT_EQ(coo.getIndices(2)[1], 1);
+
+    auto back = coo.ToCsr().ToDense();
+    ASSERT_EQ(back.getShape(), dense.getShape());
+    for (int i = 0; i < dense.getCapacity(); ++i) EXPECT_EQ(back.data()[i], dense.data()[i]);
+
+    // Duplicates are summed and entries sorted
+    CooTensor<double> built({3, 3});
+    built.Insert({2, 1}, 1.0);
+    built.Insert({0, 2}, 2.0);
+    built.Insert({2, 1}, 3.0);
+    built.Coalesce();
+    EXPECT_EQ(built.getNonZeros(), 2);
+    EXPECT_EQ(built.getValue(1), 4.0);
+    EXPECT_THROW(built.Insert({3, 0}, 1.0), std::invalid_argument);
+    EXPECT_THROW(CsrTensor<double>({2, 2}, {0, 1, 1}, {0, 1}, {1.0, 2.0}), std::invalid_argument);
+}
+
+TEST(UtilSparseTensor, Multiplication) {
+    // [2, 5, 7] sparse * [7, 3] dense against dense product
+    Tensor<double> dense({2, 5, 7});
+    for (int i = 0; i < dense.getCapacity(); ++i) dense.data()[i] = i % 4 == 0 ? i * 0.5 - 10 : 0.0;
+    Tensor<double> B({7, 3});
+    for (int i = 0; i < B.getCapacity(); ++i) B.data()[i] = 1.0 - i * 0.25;
+
+    auto csr = CsrTensor<double>::FromDense(dense);
+    auto C = csr * B;
+    auto expected = dense * B;
+    ASSERT_EQ(C.getShape(), expected.getShape());
+    for (int i = 0; i < C.getCapacity(); ++i) EXPECT_DOUBLE_EQ(C.data()[i], expected.data()[i]);
+
+    // Matrix-vector, with fused column bias and ReLU
+    Tensor<double> x({7, 1}, 1.0);
+    Tensor<double> bias({5}, 1.0);
+    Tensor<double> y({2, 5, 1});
+    MatmulEpilogue<double> epilogue;
+    epilogue.bias = &bias;
+    epilogue.bias_axis = BiasAxis::kCol;
+    epilogue.activation = Activation::kReLU;
+    csr.MultiplyInto(x, y, epilogue);
+    auto y_expected = dense * x;
+    for (int i = 0; i < y.getCapacity(); ++i) EXPECT_DOUBLE_EQ(y.data()[i], std::max(0.0, y_expected.data()[i] + 1.0));
+
+    EXPECT_THROW(csr * Tensor<double>({6, 3}), std::invalid_argument);
+}
+
+}
+}
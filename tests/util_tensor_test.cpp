@@ -2,6 +2,8 @@
 
 #include "CPPNeuralNet/Utils/tensor.h"
 
+#include <limits>
+
 
 namespace cpp_nn {
 namespace util {
@@ -48,5 +50,231 @@ TEST(UtilTensorOperations, Multiplication) {
 }
 
 
+
+TEST(UtilTensorOperations, Summation) {
+    Tensor<int> t1({2, 3}, 1);
+    Tensor<int> t2({2, 3}, 2);
+    auto t3 = t1 + t2;
+    EXPECT_EQ(t3.getDimension(0), 2);
+    EXPECT_EQ(t3.getDimension(1), 3);
+    EXPECT_EQ(t3.getElement({1, 2}), 3);
+}
+
+
+TEST(UtilTensorOperations, ElementwiseBroadcast) {
+    Tensor<int> t1({2, 3}, 0);
+    Tensor<int> bias({3}, 0);
+    Tensor<int> col({2, 1}, 0);
+    for (int c = 0; c < 3; ++c) bias.getElement({c}) = c;
+    for (int r = 0; r < 2; ++r) col.getElement({r, 0}) = 10 * r;
+
+    // Leading-axis broadcast
+    auto t2 = t1.ElementwiseApply(bias, [](int x, int y) {return x + y;});
+    EXPECT_EQ(t2.getElement({1, 2}), 2);
+    // Trailing-axis broadcast, both broadcasted
+    auto t3 = bias.ElementwiseApply(col, [](int x, int y) {return x - y;});
+    EXPECT_EQ(t3.getOrder(), 2);
+    EXPECT_EQ(t3.getElement({0, 1}), 1);
+    EXPECT_EQ(t3.getElement({1, 2}), -8);
+}
+
+
+TEST(UtilTensorOperations, Map) {
+    Tensor<float> t1({2, 3}, -2.0f);
+    t1.getElement({1, 1}) = 4.0f;
+
+    auto relu = t1.Map([](float x) {return x > 0 ? x : 0.0f;});
+    EXPECT_FLOAT_EQ(relu.getElement({0, 0}), 0.0f);
+    EXPECT_FLOAT_EQ(relu.getElement({1, 1}), 4.0f);
+    EXPECT_FLOAT_EQ(t1.getElement({0, 0}), -2.0f); // original untouched
+
+    // Fused, applied in given order
+    auto fused = t1.Map([](float x) {return x + 1.0f;}, [](float x) {return x * 3.0f;});
+    EXPECT_FLOAT_EQ(fused.getElement({0, 0}), -3.0f);
+    EXPECT_FLOAT_EQ(fused.getElement({1, 1}), 15.0f);
+
+    auto cast = t1.MapTo<int>([](float x) {return x * 2;});
+    EXPECT_EQ(cast.getElement({1, 1}), 8);
+}
+
+
+TEST(UtilTensorOperations, ApplyInPlace) {
+    // Large enough to be chunked across threads
+    Tensor<int> t1({300, 300}, 1);
+    t1.Apply([](int x) {return x + 1;}).Apply([](int x) {return x * x;}, [](int x) {return -x;});
+    EXPECT_EQ(t1.getElement({0, 0}), -4);
+    EXPECT_EQ(t1.getElement({299, 299}), -4);
+}
+
+
+
+TEST(UtilTensorOperations, MultiplicationCombinations) {
+    // [2, 2, 3] * [3, 3, 1] -> [2, 3, 2, 1], every combination of matrices
+    Tensor<int> t1({2, 2, 3}, 1);
+    Tensor<int> t2({3, 3, 1}, 1);
+    t1.getElement({1, 0, 0}) = 2;
+    t2.getElement({2, 1, 0}) = 5;
+    auto t3 = t1 * t2;
+    ASSERT_EQ(t3.getShape(), std::vector<int>({2, 3, 2, 1}));
+    EXPECT_EQ(t3.getElement({0, 0, 0, 0}), 3);
+    EXPECT_EQ(t3.getElement({0, 2, 1, 0}), 7);
+    EXPECT_EQ(t3.getElement({1, 0, 0, 0}), 4);
+    EXPECT_EQ(t3.getElement({1, 2, 0, 0}), 8);
+}
+
+
+TEST(UtilTensorOperations, MultiplyIntoEpilogue) {
+    Tensor<double> x({2, 3}, 1.0);
+    Tensor<double> W({3, 2}, 1.0);
+    Tensor<double> bias({2}, 0.0);
+    Tensor<double> residual({2, 2}, 0.5);
+    W.getElement({0, 1}) = -4.0;
+    bias.getElement({0}) = 1.0;
+
+    MatmulEpilogue<double> epilogue;
+    epilogue.bias = &bias;
+    epilogue.activation = Activation::kReLU;
+    epilogue.residual = &residual;
+
+    Tensor<double> y({2, 2});
+    y.MultiplyInto(x, W, epilogue);
+    EXPECT_DOUBLE_EQ(y.getElement({0, 0}), 4.5);  // relu(3 + 1) + 0.5
+    EXPECT_DOUBLE_EQ(y.getElement({1, 1}), 0.5);  // relu(-2 + 0) + 0.5
+
+    Tensor<double> wrong_bias({3}, 0.0);
+    epilogue.bias = &wrong_bias;
+    EXPECT_THROW(y.MultiplyInto(x, W, epilogue), std::invalid_argument);
+}
+
+
+
+TEST(UtilTensorOperations, MultiplicationBatchedPacked) {
+    // [3, 5, 4] * [2, 4, 6] -> [3, 2, 5, 6], B chunks packed once for every A chunk
+    Tensor<double> t1({3, 5, 4});
+    Tensor<double> t2({2, 4, 6});
+    Tensor<double> weight({4, 6});
+    for (int a = 0; a < 3; ++a) for (int r = 0; r < 5; ++r) for (int k = 0; k < 4; ++k)
+        t1.getElement({a, r, k}) = (a * 7 + r * 3 + k) % 5 - 2;
+    for (int b = 0; b < 2; ++b) for (int k = 0; k < 4; ++k) for (int c = 0; c < 6; ++c)
+        t2.getElement({b, k, c}) = (b * 5 + k * 2 + c) % 7 - 3;
+    for (int k = 0; k < 4; ++k) for (int c = 0; c < 6; ++c)
+        weight.getElement({k, c}) = t2.getElement({1, k, c});
+
+    auto t3 = t1 * t2;
+    ASSERT_EQ(t3.getShape(), std::vector<int>({3, 2, 5, 6}));
+    for (int a = 0; a < 3; ++a) for (int b = 0; b < 2; ++b) for (int r = 0; r < 5; ++r) for (int c = 0; c < 6; ++c) {
+        double expected = 0;
+        for (int k = 0; k < 4; ++k) expected += t1.getElement({a, r, k}) * t2.getElement({b, k, c});
+        EXPECT_DOUBLE_EQ(t3.getElement({a, b, r, c}), expected);
+    }
+
+    // [3, 5, 4] * [4, 6] -> [3, 5, 6], shared weight, with both bias axes
+    Tensor<double> col_bias({5}, 1.0);
+    MatmulEpilogue<double> epilogue;
+    epilogue.bias = &col_bias;
+    epilogue.bias_axis = BiasAxis::kCol;
+    Tensor<double> t4({3, 5, 6});
+    t4.MultiplyInto(t1, weight, epilogue);
+    Tensor<double> t5 = t1 * weight;
+    for (int a = 0; a < 3; ++a) for (int r = 0; r < 5; ++r) for (int c = 0; c < 6; ++c) {
+        EXPECT_DOUBLE_EQ(t5.getElement({a, r, c}), t3.getElement({a, 1, r, c}));
+        EXPECT_DOUBLE_EQ(t4.getElement({a, r, c}), t3.getElement({a, 1, r, c}) + 1.0);
+    }
+}
+
+
+
+TEST(UtilTensorOperations, BatchedMatmul) {
+    // [4, 2, 3] * [4, 3, 2] -> [4, 2, 2], pairwise rather than every combination
+    Tensor<double> t1({4, 2, 3});
+    Tensor<double> t2({4, 3, 2});
+    for (int b = 0; b < 4; ++b) for (int r = 0; r < 2; ++r) for (int k = 0; k < 3; ++k) {
+        t1.getElement({b, r, k}) = b + r - k;
+        t2.getElement({b, k, r}) = b * k - r;
+    }
+    auto t3 = t1.BatchedMatmul(t2);
+    auto every = t1 * t2;
+    ASSERT_EQ(t3.getShape(), std::vector<int>({4, 2, 2}));
+    for (int b = 0; b < 4; ++b) for (int r = 0; r < 2; ++r) for (int c = 0; c < 2; ++c) {
+        EXPECT_DOUBLE_EQ(t3.getElement({b, r, c}), every.getElement({b, b, r, c}));
+    }
+
+    // [4, 1, 2, 3] * [3, 3, 2] -> [4, 3, 2, 2], broadcasted batch axes
+    Tensor<double> t4({3, 3, 2});
+    for (int b = 0; b < 3; ++b) for (int k = 0; k < 3; ++k) for (int c = 0; c < 2; ++c)
+        t4.getElement({b, k, c}) = b - k * c;
+    Tensor<double> t1_expanded({4, 1, 2, 3});
+    for (int b = 0; b < 4; ++b) for (int r = 0; r < 2; ++r) for (int k = 0; k < 3; ++k)
+        t1_expanded.getElement({b, 0, r, k}) = t1.getElement({b, r, k});
+    auto t5 = t1_expanded.BatchedMatmul(t4);
+    auto every_t4 = t1 * t4;
+    ASSERT_EQ(t5.getShape(), std::vector<int>({4, 3, 2, 2}));
+    for (int a = 0; a < 4; ++a) for (int b = 0; b < 3; ++b) for (int r = 0; r < 2; ++r) for (int c = 0; c < 2; ++c) {
+        EXPECT_DOUBLE_EQ(t5.getElement({a, b, r, c}), every_t4.getElement({a, b, r, c}));
+    }
+
+    Tensor<double> t6({3, 3, 2});
+    EXPECT_THROW(t1.BatchedMatmul(t6), std::runtime_error);
+}
+
+TEST(UtilTensorOperations, MultiplicationAccumulator) {
+    // Partial sums pass 2^31, but int products accumulate in int64
+    Tensor<int> A({4, 9});
+    Tensor<int> B({9, 8}, 1 << 15);
+    for (int r = 0; r < 4; ++r) for (int k = 0; k < 9; ++k) A.getElement({r, k}) = k < 5 ? (1 << 15) : -(1 << 15);
+    auto C = A * B;
+    for (int i = 0; i < C.getCapacity(); ++i) EXPECT_EQ(C.data()[i], 1 << 30);
+    // Results beyond int saturate
+    A.Apply([](int) {return 1 << 15;});
+    C = A * B;
+    EXPECT_EQ(C.getElement({0, 0}), std::numeric_limits<int>::max());
+
+    // 1 is lost against 1e8 in float, but kept in double
+    Tensor<float> X({2, 1002}, 1.0f);
+    Tensor<float> Y({1002, 8}, 1.0f);
+    X.getElement({0, 0}) = 1e8f;
+    X.getElement({0, 1001}) = -1e8f;
+    EXPECT_NE((X * Y).getElement({0, 3}), 1000.0f);
+    auto Z = X.Multiply<double>(Y);
+    EXPECT_EQ(Z.getElement({0, 3}), 1000.0f);
+    EXPECT_EQ(Z.getElement({1, 3}), 1002.0f);
+}
+
+
+TEST(UtilTensorModifiers, ReshapeResize) {
+    Tensor<int> A({2, 6});
+    for (int i = 0; i < A.getCapacity(); ++i) A.data()[i] = i;
+    A.Reshape({3, 2, 2});
+    EXPECT_EQ(A.getShape(), std::vector<int>({3, 2, 2}));
+    EXPECT_EQ(A.getElement({2, 1, 0}), 10);
+    EXPECT_THROW(A.Reshape({5, 2}), std::invalid_argument);
+
+    // Shrinking and growing back within largest capacity keeps storage
+    const int* storage = A.data();
+    A.Resize({1, 4});
+    EXPECT_EQ(A.getCapacity(), 4);
+    EXPECT_EQ(A.getElement({0, 3}), 3);
+    A.Resize({4, 3});
+    EXPECT_EQ(A.data(), storage);
+    EXPECT_EQ(A.getElement({1, 0}), 3);
+    EXPECT_THROW(A.Resize({-1, 3}), std::invalid_argument);
+
+    // Views read and write storage owned elsewhere, and copies of them own their elements
+    std::vector<double> arena(10, 1.0);
+    Tensor<double> view = Tensor<double>::View({2, 3}, arena.data() + 2);
+    EXPECT_TRUE(view.isView());
+    view.getElement({1, 2}) = 5;
+    EXPECT_EQ(arena[7], 5);
+    Tensor<double> copy(view);
+    EXPECT_FALSE(copy.isView());
+    copy.getElement({0, 0}) = 3;
+    EXPECT_EQ(arena[2], 1);
+    view.Resize({1, 3});
+    view.Resize({3, 2});
+    EXPECT_EQ(view.data(), arena.data() + 2);
+    EXPECT_THROW(view.Resize({3, 3}), std::invalid_argument);
+    EXPECT_EQ(view.getShape(), std::vector<int>({3, 2}));
+}
+
 }
 }
\ No newline at end of file
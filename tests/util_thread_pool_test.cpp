@@ -0,0 +1,92 @@
+#include "gtest/gtest.h"
+
+#include "CPPNeuralNet/Utils/thread_pool.h"
+#include "CPPNeuralNet/Utils/tensor.h"
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace cpp_nn {
+namespace util {
+
+TEST(UtilThreadPool, ParallelFor) {
+    const int default_threads = getNumThreads();
+    SetNumThreads(4);
+    EXPECT_EQ(getNumThreads(), 4);
+
+    // Every index visited exactly once, each range at least grain long except the last
+    std::vector<std::atomic<int>> visits(10007);
+    std::atomic<int> short_ranges(0);
+    ParallelFor(0, visits.size(), [&](int begin, int end) {
+        if (end - begin < 100) ++short_ranges;
+        for (int i = begin; i < end; ++i) ++visits[i];
+    }, 100);
+    for (const auto& count : visits) EXPECT_EQ(count.load(), 1);
+    EXPECT_LE(short_ranges.load(), 1);
+
+    // Nested calls run inline, on the thread of the enclosing task
+    std::atomic<int> nested_elsewhere(0);
+    ParallelFor(0, 8, [&](int begin, int end) {
+        EXPECT_TRUE(ThreadPool::InParallelRegion());
+        const std::thread::id outer = std::this_thread::get_id();
+        ParallelFor(0, 1000, [&](int, int) {
+            if (std::this_thread::get_id() != outer) ++nested_elsewhere;
+        });
+    });
+    EXPECT_EQ(nested_elsewhere.load(), 0);
+    EXPECT_FALSE(ThreadPool::InParallelRegion());
+
+    // Exceptions reach the caller, and the pool stays usable
+    EXPECT_THROW(ParallelFor(0, 64, [](int begin, int) {
+        if (begin == 0) throw std::invalid_argument("ParallelFor Test");
+    }), std::invalid_argument);
+
+    // Kernels give the same result whatever the thread count
+    Tensor<double> A({3, 70, 90});
+    Tensor<double> B({90, 50});
+    for (int i = 0; i < A.getCapacity(); ++i) A.data()[i] = (i % 19) - 9;
+    for (int i = 0; i < B.getCapacity(); ++i) B.data()[i] = (i % 7) - 3;
+    Tensor<double> parallel = A * B;
+    SetNumThreads(1);
+    Tensor<double> serial = A * B;
+    for (int i = 0; i < serial.getCapacity(); ++i) EXPECT_EQ(parallel.data()[i], serial.data()[i]);
+
+    SetNumThreads(default_threads);
+}
+
+TEST(UtilThreadPool, NumaPlacement) {
+    const int default_threads = getNumThreads();
+    SetNumThreads(4);
+    SetThreadAffinity(true);
+    EXPECT_EQ(getNumThreads(), 4);
+    EXPECT_GE(getNumaNodes(), 1);
+
+    // Storage is aligned, and filled or copied in full by first-touch
+    Tensor<float> filled({300, 500}, 1.5f);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(filled.data()) % kTensorAlignment, 0u);
+    Tensor<float> copied(filled);
+    for (int i = 0; i < filled.getCapacity(); ++i) {
+        ASSERT_EQ(filled.data()[i], 1.5f);
+        ASSERT_EQ(copied.data()[i], 1.5f);
+    }
+
+    // Socket partitioning only changes which thread runs each pair
+    Tensor<double> A({16, 20, 30});
+    Tensor<double> B({16, 30, 10});
+    for (int i = 0; i < A.getCapacity(); ++i) A.data()[i] = (i % 13) - 6;
+    for (int i = 0; i < B.getCapacity(); ++i) B.data()[i] = (i % 5) - 2;
+    Tensor<double> balanced = A.BatchedMatmul(B);
+    SetSocketPartitioning(true);
+    Tensor<double> partitioned = A.BatchedMatmul(B);
+    SetSocketPartitioning(false);
+    for (int i = 0; i < balanced.getCapacity(); ++i) EXPECT_EQ(partitioned.data()[i], balanced.data()[i]);
+
+    SetThreadAffinity(false);
+    SetNumThreads(default_threads);
+}
+
+}
+}